@@ -132,6 +132,47 @@ moment(int mom,
     }
 }
 
+vector<double> const &Angular_Discretization::
+discrete_to_moment_matrix() const
+{
+    call_once(transfer_flag_,
+              &Angular_Discretization::initialize_transfer_matrices,
+              this);
+    return discrete_to_moment_matrix_;
+}
+
+vector<double> const &Angular_Discretization::
+moment_to_discrete_matrix() const
+{
+    call_once(transfer_flag_,
+              &Angular_Discretization::initialize_transfer_matrices,
+              this);
+    return moment_to_discrete_matrix_;
+}
+
+void Angular_Discretization::
+initialize_transfer_matrices() const
+{
+    vector<double> const &quadrature_weights = weights();
+    vector<int> const &l_indices = scattering_indices();
+    
+    discrete_to_moment_matrix_.resize(number_of_moments_ * number_of_ordinates_);
+    moment_to_discrete_matrix_.resize(number_of_ordinates_ * number_of_moments_);
+    for (int o = 0; o < number_of_ordinates_; ++o)
+    {
+        for (int m = 0; m < number_of_moments_; ++m)
+        {
+            double const p = moment(m, o);
+            int const l = l_indices[m];
+            
+            discrete_to_moment_matrix_[m + number_of_moments_ * o]
+                = quadrature_weights[o] * p;
+            moment_to_discrete_matrix_[o + number_of_ordinates_ * m]
+                = (2 * static_cast<double>(l) + 1) / angular_normalization_ * p;
+        }
+    }
+}
+
 void Angular_Discretization::
 moment_to_discrete(vector<double> &data) const
 {
@@ -145,16 +186,14 @@ moment_to_discrete(vector<double> &data) const
     data.resize(number_of_ordinates_);
 
     // Perform moment to discrete operation
+    vector<double> const &transfer = moment_to_discrete_matrix();
     for (int o = 0; o < number_of_ordinates_; ++o)
     {
         double sum = 0;
         
         for (int m = 0; m < number_of_moments_; ++m)
         {
-            int const l = scattering_indices()[m];
-            double const p = moment(m, o);
-            
-            sum += (2 * static_cast<double>(l) + 1) / angular_normalization_ * p * old_data[m];
+            sum += transfer[o + number_of_ordinates_ * m] * old_data[m];
         }
 
         data[o] = sum;
@@ -173,15 +212,14 @@ discrete_to_moment(vector<double> &data) const
     // Resize input vector
     data.resize(number_of_moments_);
 
-    // Perform moment to discrete operation
+    // Perform discrete to moment operation
+    vector<double> const &transfer = discrete_to_moment_matrix();
     for (int m = 0; m < number_of_moments_; ++m)
     {
         double sum = 0;
         for (int o = 0; o < number_of_ordinates_; ++o)
         {
-            double const p = moment(m, o);
-            
-            sum += weights()[o] * p * old_data[o];
+            sum += transfer[m + number_of_moments_ * o] * old_data[o];
         }
 
         data[m] = sum;
@@ -1,6 +1,7 @@
 #ifndef Angular_Discretization_hh
 #define Angular_Discretization_hh
 
+#include <mutex>
 #include <vector>
 
 class XML_Node;
@@ -86,6 +87,12 @@ public:
     // Check class member sizes
     virtual void check_class_invariants() const = 0;
     
+    // Transfer matrices, calculated on first use and stored column-major
+    //     discrete_to_moment_matrix: moments x ordinates, weights[o] * moment(m, o)
+    //     moment_to_discrete_matrix: ordinates x moments, (2l + 1) / norm * moment(m, o)
+    std::vector<double> const &discrete_to_moment_matrix() const;
+    std::vector<double> const &moment_to_discrete_matrix() const;
+    
     // Perform moment-to-discrete operation
     virtual void moment_to_discrete(std::vector<double> &data) const;
 
@@ -112,9 +119,16 @@ protected:
 private:
 
     virtual void initialize_moment_data();
+
+    // The ordinates are set by derived classes after construction, so
+    // the transfer matrices are calculated on first use
+    void initialize_transfer_matrices() const;
     
     std::vector<int> l_indices_;
     std::vector<int> m_indices_;
+    mutable std::once_flag transfer_flag_;
+    mutable std::vector<double> discrete_to_moment_matrix_;
+    mutable std::vector<double> moment_to_discrete_matrix_;
 };
 
 #endif
@@ -0,0 +1,94 @@
+#include "Cross_Section_Table.hh"
+
+#include <algorithm>
+#include <map>
+#include <set>
+#include <tuple>
+
+#include "Check.hh"
+
+using std::map;
+using std::set;
+using std::shared_ptr;
+using std::vector;
+
+Cross_Section_Table::
+Cross_Section_Table(vector<shared_ptr<Cross_Section> > const &cross_sections)
+{
+    int number_of_points = cross_sections.size();
+    Assert(number_of_points > 0);
+    
+    // Order the entries by dependencies and then by data, comparing the
+    // ranges already stored in data_ rather than copies of them
+    auto entry_less = [this](int a, int b)
+        {
+            Cross_Section::Dependencies const &dep_a = dependencies_[a];
+            Cross_Section::Dependencies const &dep_b = dependencies_[b];
+            auto key_a = std::make_tuple(dep_a.angular, dep_a.energy, dep_a.dimensional, dep_a.spatial, dep_a.number_of_basis_functions);
+            auto key_b = std::make_tuple(dep_b.angular, dep_b.energy, dep_b.dimensional, dep_b.spatial, dep_b.number_of_basis_functions);
+            if (key_a != key_b)
+            {
+                return key_a < key_b;
+            }
+            return std::lexicographical_compare(data_.begin() + offsets_[a], data_.begin() + offsets_[a + 1],
+                                                data_.begin() + offsets_[b], data_.begin() + offsets_[b + 1]);
+        };
+    
+    // Materials are usually shared between points, so check the pointer
+    // before comparing the data
+    map<Cross_Section const *, int> pointer_entries;
+    set<int, decltype(entry_less)> data_entries(entry_less);
+    number_of_entries_ = 0;
+    indices_.resize(number_of_points);
+    offsets_.assign(1, 0);
+    dependencies_.clear();
+    data_.clear();
+    for (int i = 0; i < number_of_points; ++i)
+    {
+        Cross_Section const *cross_section = cross_sections[i].get();
+        
+        // Check for the same cross section
+        auto pointer_entry = pointer_entries.find(cross_section);
+        if (pointer_entry != pointer_entries.end())
+        {
+            indices_[i] = pointer_entry->second;
+            continue;
+        }
+        
+        // Add the data as a candidate entry, and remove it again if the
+        // same data is already stored
+        vector<double> const &data = cross_section->data();
+        dependencies_.push_back(cross_section->dependencies());
+        data_.insert(data_.end(), data.begin(), data.end());
+        offsets_.push_back(data_.size());
+        auto data_entry = data_entries.insert(number_of_entries_);
+        int index = *data_entry.first;
+        if (data_entry.second)
+        {
+            number_of_entries_ += 1;
+        }
+        else
+        {
+            dependencies_.pop_back();
+            offsets_.pop_back();
+            data_.resize(offsets_.back());
+        }
+        pointer_entries.emplace(cross_section, index);
+        indices_[i] = index;
+    }
+    
+    check_class_invariants();
+}
+
+void Cross_Section_Table::
+check_class_invariants() const
+{
+    Assert(number_of_entries_ > 0);
+    Assert(static_cast<int>(offsets_.size()) == number_of_entries_ + 1);
+    Assert(static_cast<int>(dependencies_.size()) == number_of_entries_);
+    Assert(offsets_[number_of_entries_] == static_cast<int>(data_.size()));
+    for (int index : indices_)
+    {
+        Assert(index >= 0 && index < number_of_entries_);
+    }
+}
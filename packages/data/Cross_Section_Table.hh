@@ -0,0 +1,66 @@
+#ifndef Cross_Section_Table_hh
+#define Cross_Section_Table_hh
+
+#include <memory>
+#include <vector>
+
+#include "Cross_Section.hh"
+
+/*
+  Contiguous storage of one cross section for each point
+
+  Cross sections with identical dependencies and data are stored once, in
+  the order of Cross_Section::data(), and each point holds the index of its
+  entry. The dependencies are kept for each entry, so points may differ in
+  dependencies and data size. For scattering, an entry is laid out as
+  [moment][gt][gf][dimensional], so the group-to-group block for each
+  moment is a column-major (gf x gt) matrix with an inner stride of the
+  dimensional size and an outer stride of groups times dimensional size.
+*/
+class Cross_Section_Table
+{
+public:
+
+    // Constructor
+    Cross_Section_Table(std::vector<std::shared_ptr<Cross_Section> > const &cross_sections);
+
+    // Dependencies of the entry for a point
+    Cross_Section::Dependencies const &dependencies(int point) const
+    {
+        return dependencies_[indices_[point]];
+    }
+
+    // Number of points and number of unique cross sections
+    int number_of_points() const
+    {
+        return indices_.size();
+    }
+    int number_of_entries() const
+    {
+        return number_of_entries_;
+    }
+
+    // Index of the entry for a point
+    int index(int point) const
+    {
+        return indices_[point];
+    }
+
+    // Data of the entry for a point
+    double const *data(int point) const
+    {
+        return &data_[offsets_[indices_[point]]];
+    }
+    
+    void check_class_invariants() const;
+    
+private:
+
+    int number_of_entries_;
+    std::vector<int> indices_;
+    std::vector<int> offsets_;
+    std::vector<Cross_Section::Dependencies> dependencies_;
+    std::vector<double> data_;
+};
+
+#endif
@@ -21,6 +21,7 @@
 #include "Strong_Spatial_Discretization_Parser.hh"
 #include "Timer.hh"
 #include "Transport_Discretization.hh"
+#include "Vector_Operator.hh"
 #include "Weak_Spatial_Discretization.hh"
 #include "Weak_Spatial_Discretization_Parser.hh"
 
@@ -32,7 +33,8 @@ Transport_Problem(XML_Node input_node,
                   bool print):
     input_node_(input_node),
     output_node_(output_node),
-    print_(print)
+    print_(print),
+    operator_timing_(false)
 {
 }
 
@@ -44,6 +46,8 @@ solve()
     string type = problem_node.get_attribute<string>("type");
     string discretization_method = problem_node.get_attribute<string>("discretization",
                                                                       "weak");
+    operator_timing_ = problem_node.get_attribute<bool>("operator_timing",
+                                                        operator_timing_);
     
     timer.start();
     if (type == "eigenvalue")
@@ -218,6 +222,10 @@ solve_steady_state(string discretization_method)
     }
     timer.stop();
     times_.emplace_back(timer.time(), "solver_initialization");
+    if (operator_timing_)
+    {
+        enable_operator_timing(solver);
+    }
     
     // Solve problem
     print_message("Solving problem");
@@ -285,6 +293,10 @@ solve_eigenvalue(string discretization_method)
     }
     timer.stop();
     times_.emplace_back(timer.time(), "solver_initialization");
+    if (operator_timing_)
+    {
+        enable_operator_timing(solver);
+    }
     
     // Solve problem
     print_message("Solving problem");
@@ -307,6 +319,16 @@ solve_eigenvalue(string discretization_method)
     times_.emplace_back(timer.time(), "output");
 }
 
+void Transport_Problem::
+enable_operator_timing(shared_ptr<Solver> solver)
+{
+    timed_operators_ = solver->operators();
+    for (shared_ptr<Vector_Operator> oper : timed_operators_)
+    {
+        oper->enable_profiling();
+    }
+}
+
 void Transport_Problem::
 output_timing()
 {
@@ -315,6 +337,16 @@ output_timing()
     {
         timing_node.set_child_value(time.first, time.second);
     }
+    
+    // Output the tree of profiles for each operator used by the solver
+    if (!timed_operators_.empty())
+    {
+        XML_Node operators_node = timing_node.append_child("operators");
+        for (shared_ptr<Vector_Operator> oper : timed_operators_)
+        {
+            oper->output_profile(operators_node.append_child("operator"));
+        }
+    }
 }
 
 void Transport_Problem::
@@ -12,7 +12,9 @@ class Angular_Discretization;
 class Energy_Discretization;
 class Meshless_Sweep;
 class Solid_Geometry;
+class Solver;
 class Transport_Discretization;
+class Vector_Operator;
 class Weak_Spatial_Discretization;
 
 /*
@@ -52,6 +54,11 @@ private:
     // Timing
     void output_timing();
     std::vector<std::pair<double, std::string> > times_;
+
+    // Operator timing, enabled with the "operator_timing" problem attribute
+    void enable_operator_timing(std::shared_ptr<Solver> solver);
+    bool operator_timing_;
+    std::vector<std::shared_ptr<Vector_Operator> > timed_operators_;
 };
 
 #endif
@@ -63,7 +63,7 @@ perform_integration()
     for (int i = 0; i < number_of_cells; ++i)
     {
         // Get cell
-        shared_ptr<Integration_Cell> const cell = mesh_->cell(i);
+        Integration_Cell const &cell = mesh_->cell(i);
         
         // Get quadrature
         int number_of_ordinates;
@@ -122,10 +122,10 @@ perform_integration()
             double const source = data_->source(position);
 
             // Add integrals for each weight function in this cell
-            for (int w = 0; w < cell->number_of_weight_functions; ++w)
+            for (int w = 0; w < cell.number_of_weight_functions; ++w)
             {
                 // Get global weight function index
-                int w_ind = cell->weight_indices[w];
+                int w_ind = cell.weight_indices[w];
 
                 // Add source to rhs
                 switch (options_->geometry)
@@ -139,7 +139,7 @@ perform_integration()
                     break;
                 }
                 
-                for (int b = 0; b < cell->number_of_basis_functions; ++b)
+                for (int b = 0; b < cell.number_of_basis_functions; ++b)
                 {
                     // Get basis index for this weight function
                     int w_b_ind = weight_basis_indices[w][b];
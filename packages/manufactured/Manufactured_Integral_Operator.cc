@@ -99,7 +99,7 @@ apply(vector<double> &x) const
     for (int i = 0; i < number_of_cells; ++i)
     {
         // Get cell
-        shared_ptr<Integration_Cell> const cell = mesh_->cell(i);
+        Integration_Cell const &cell = mesh_->cell(i);
         
         // Get quadrature
         int number_of_ordinates;
@@ -240,7 +240,7 @@ apply(vector<double> &x) const
 }
 
 void Manufactured_Integral_Operator::
-get_flux(shared_ptr<Integration_Cell> const cell,
+get_flux(Integration_Cell const &cell,
          vector<double> const &b_val,
          vector<double> const &coeff,
          vector<double> &flux) const
@@ -251,9 +251,9 @@ get_flux(shared_ptr<Integration_Cell> const cell,
 
     // Calculate flux
     flux.assign(number_of_groups * number_of_moments, 0.);
-    for (int i = 0; i < cell->number_of_basis_functions; ++i)
+    for (int i = 0; i < cell.number_of_basis_functions; ++i)
     {
-        int const j = cell->basis_indices[i];
+        int const j = cell.basis_indices[i];
         for (int m = 0; m < number_of_moments; ++m)
         {
             for (int g = 0; g < number_of_groups; ++g)
@@ -28,6 +28,11 @@ public:
         return vector_operator_->column_size() + number_of_augments_;
     }
     virtual std::string description() const override;
+
+    virtual std::vector<std::shared_ptr<Vector_Operator> > children() const override
+    {
+        return {vector_operator_};
+    }
     
 private:
     
@@ -78,9 +78,9 @@ apply_full(vector<double> &x) const
         shared_ptr<Weight_Function> weight = spatial_discretization_->weight(i);
         int const number_of_basis_functions = weight->number_of_basis_functions();
         vector<int> const basis_function_indices = weight->basis_function_indices();
-        Weight_Function::Integrals const integrals = weight->integrals();
-        vector<double> const &iv_b_w = integrals.iv_b_w;
-        vector<double> const &iv_b_dw = integrals.iv_b_dw;
+        Weight_Function::Integrals const &integrals = weight->integrals();
+        Integral_Span const &iv_b_w = integrals.iv_b_w;
+        Integral_Span const &iv_b_dw = integrals.iv_b_dw;
         
         // Perform scattering
         int const m = 0;
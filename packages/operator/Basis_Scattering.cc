@@ -7,9 +7,12 @@
     #include <omp.h>
 #endif
 
+#include <Eigen/Dense>
+
 #include "Angular_Discretization.hh"
 #include "Check.hh"
 #include "Cross_Section.hh"
+#include "Cross_Section_Table.hh"
 #include "Dimensional_Moments.hh"
 #include "Energy_Discretization.hh"
 #include "Material.hh"
@@ -28,6 +31,14 @@ Basis_Scattering(shared_ptr<Weak_Spatial_Discretization> spatial_discretization,
                              energy_discretization,
                              options)
 {
+    int number_of_points = spatial_discretization_->number_of_points();
+    vector<shared_ptr<Cross_Section> > sigma_s(number_of_points);
+    for (int i = 0; i < number_of_points; ++i)
+    {
+        sigma_s[i] = spatial_discretization_->point(i)->material()->sigma_s();
+    }
+    sigma_s_ = make_shared<Cross_Section_Table>(sigma_s);
+    
     check_class_invariants();
 }
 
@@ -40,12 +51,14 @@ check_class_invariants() const
     Assert(spatial_discretization_->options()->weighting
            == Weak_Spatial_Discretization_Options::Weighting::BASIS);
     
+    Assert(sigma_s_);
+    Assert(sigma_s_->number_of_points() == spatial_discretization_->number_of_points());
+    
     int number_of_points = spatial_discretization_->number_of_points();
     for (int i = 0; i < number_of_points; ++i)
     {
-        shared_ptr<Material> material = spatial_discretization_->point(i)->material();
-        Cross_Section::Dependencies dep = material->sigma_s()->dependencies();
         // Make sure angular and energy dependencies for each point are correct
+        Cross_Section::Dependencies const &dep = sigma_s_->dependencies(i);
         Assert(dep.angular == Cross_Section::Dependencies::Angular::SCATTERING_MOMENTS);
         Assert(dep.energy == Cross_Section::Dependencies::Energy::GROUP_TO_GROUP);
         Assert(dep.spatial == Cross_Section::Dependencies::Spatial::BASIS);
@@ -78,50 +91,47 @@ apply_full(vector<double> &x) const
         shared_ptr<Weight_Function> weight = spatial_discretization_->weight(i);
         int const number_of_basis_functions = weight->number_of_basis_functions();
         vector<int> const basis_function_indices = weight->basis_function_indices();
-        Weight_Function::Integrals const integrals = weight->integrals();
-        vector<double> const &iv_b_w = integrals.iv_b_w;
-        vector<double> const &iv_b_dw = integrals.iv_b_dw;
+        Weight_Function::Integrals const &integrals = weight->integrals();
+        Integral_Span const &iv_b_w = integrals.iv_b_w;
+        Integral_Span const &iv_b_dw = integrals.iv_b_dw;
         
-        // Perform scattering
+        // Perform scattering: the flux for each moment is a (nodes x groups)
+        // matrix, and the cross section a (gf x gt) matrix
         for (int m = 0; m < number_of_moments; ++m)
         {
             int l = scattering_indices[m];
             
-            for (int gt = 0; gt < number_of_groups; ++gt)
+            for (int j = 0; j < number_of_basis_functions; ++j)
             {
-                for (int n = 0; n < number_of_nodes; ++n)
+                // Get cross section information: stored in weight functions but weighted by basis functions
+                int b = basis_function_indices[j];
+                double const *sigma_s = sigma_s_->data(b);
+                int k_phi_from = number_of_nodes * number_of_groups * (m + number_of_moments * b);
+                Eigen::Map<Eigen::MatrixXd const> const phi_from(&y[k_phi_from],
+                                                                 number_of_nodes,
+                                                                 number_of_groups);
+                
+                for (int d = 0; d < number_of_dimensional_moments; ++d)
                 {
-                    for (int d = 0; d < number_of_dimensional_moments; ++d)
-                    {
-                        double sum = 0;
-                        
-                        for (int j = 0; j < number_of_basis_functions; ++j)
-                        {
-                            // Get summation constants and other basis data
-                            int b = basis_function_indices[j];
-                            double mult = (d == 0
-                                           ? iv_b_w[j]
-                                           : iv_b_dw[d - 1 + dimension * j]);
-                            
-                            // Get cross section information: stored in weight functions but weighted by basis functions
-                            vector<double> const sigma_s
-                                = spatial_discretization_->weight(b)->material()->sigma_s()->data();
-                            
-                            for (int gf = 0; gf < number_of_groups; ++gf)
-                            {
-                                int k_phi_from = n + number_of_nodes * (gf + number_of_groups * (m + number_of_moments * b));
-                                int k_sigma = d + number_of_dimensional_moments * (gf + number_of_groups * (gt + number_of_groups * l));
-                                
-                                sum += sigma_s[k_sigma] * mult * y[k_phi_from];
-                            } // from group
-                        } // basis functions
-                        
-                        int k_phi_to = n + number_of_nodes * (d + number_of_dimensional_moments * (gt + number_of_groups * (m + number_of_moments * i)));
-                        
-                        x[k_phi_to] = sum;
-                    } // dimensional moments
-                } // nodes
-            } // to group
+                    // Get summation constants
+                    double mult = (d == 0
+                                   ? iv_b_w[j]
+                                   : iv_b_dw[d - 1 + dimension * j]);
+                    int k_sigma = d + number_of_dimensional_moments * number_of_groups * number_of_groups * l;
+                    int k_phi_to = number_of_nodes * (d + number_of_dimensional_moments * number_of_groups * (m + number_of_moments * i));
+                    
+                    Eigen::Map<Eigen::MatrixXd const, 0, Eigen::Stride<Eigen::Dynamic, Eigen::Dynamic> > const sigma(&sigma_s[k_sigma],
+                                                                                                                     number_of_groups,
+                                                                                                                     number_of_groups,
+                                                                                                                     Eigen::Stride<Eigen::Dynamic, Eigen::Dynamic>(number_of_groups * number_of_dimensional_moments,
+                                                                                                                                                                   number_of_dimensional_moments));
+                    Eigen::Map<Eigen::MatrixXd, 0, Eigen::OuterStride<> > phi_to(&x[k_phi_to],
+                                                                                 number_of_nodes,
+                                                                                 number_of_groups,
+                                                                                 Eigen::OuterStride<>(number_of_nodes * number_of_dimensional_moments));
+                    phi_to.noalias() += mult * phi_from * sigma;
+                } // dimensional moments
+            } // basis functions
         } // moments
     } // weight functions
 }
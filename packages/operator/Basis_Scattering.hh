@@ -6,6 +6,8 @@
 
 #include "Full_Scattering_Operator.hh"
 
+class Cross_Section_Table;
+
 /*
   Applies scattering to a moment representation of the flux
 */
@@ -28,6 +30,9 @@ public:
     
 private: 
 
+    // Scattering cross section of each weight function
+    std::shared_ptr<Cross_Section_Table> sigma_s_;
+    
     // Apply within-group and out-of-group scattering
     virtual void apply_full(std::vector<double> &x) const override;
     
@@ -87,8 +87,8 @@ apply_full(vector<double> &x) const
         shared_ptr<Material> const material = weight->material();
         shared_ptr<Cross_Section> const sigma_f_cs = material->sigma_f();
         shared_ptr<Cross_Section> const norm_cs = material->norm();
-        vector<double> const sigma_f = sigma_f_cs->data();
-        vector<double> const norm = norm_cs->data();
+        vector<double> const &sigma_f = sigma_f_cs->data();
+        vector<double> const &norm = norm_cs->data();
         for (int o = 0; o < number_of_ordinates; ++o)
         {
             vector<double> const direction = angular_discretization_->direction(o);
@@ -81,11 +81,11 @@ apply(vector<double> &x) const
             shared_ptr<Weight_Function> weight = spatial_->weight(i);
             int number_of_basis_functions = weight->number_of_basis_functions();
             vector<int> basis_indices = weight->basis_function_indices();
-            Weight_Function::Integrals const integrals = weight->integrals();
+            Weight_Function::Integrals const &integrals = weight->integrals();
             shared_ptr<Weight_Function_Options> const weight_options = weight->options();
             double const tau = weight_options->tau;
-            vector<double> const &iv_w = integrals.iv_w;
-            vector<double> const &iv_dw = integrals.iv_dw;
+            Integral_Span const &iv_w = integrals.iv_w;
+            Integral_Span const &iv_dw = integrals.iv_dw;
         
             for (int o = 0; o < number_of_ordinates; ++o)
             {
@@ -4,6 +4,8 @@
     #include <omp.h>
 #endif
 
+#include <Eigen/Dense>
+
 #include "Angular_Discretization.hh"
 #include "Check.hh"
 #include "Energy_Discretization.hh"
@@ -38,43 +40,49 @@ Discrete_To_Moment(shared_ptr<Spatial_Discretization> spatial_discretization,
 void Discrete_To_Moment::
 apply(vector<double> &x) const
 {
-    vector<double> y(x);
+    vector<double> const y(x);
     
-    x.resize(row_size());
+    discrete_to_moment(y, x);
+}
+
+void Discrete_To_Moment::
+apply_buffered(vector<double> const &x,
+               vector<double> &y,
+               Vector_Workspace &workspace) const
+{
+    discrete_to_moment(x, y);
+}
+
+void Discrete_To_Moment::
+discrete_to_moment(vector<double> const &psi,
+                   vector<double> &phi) const
+{
+    phi.resize(row_size());
     
     int number_of_points = spatial_discretization_->number_of_points();
     int number_of_nodes = spatial_discretization_->number_of_nodes();
     int number_of_groups = energy_discretization_->number_of_groups();
     int number_of_moments = angular_discretization_->number_of_moments();
     int number_of_ordinates = angular_discretization_->number_of_ordinates();
-    vector<double> const weights = angular_discretization_->weights();
-    vector<double> const ordinates = angular_discretization_->ordinates();
 
+    // The data for each point is a column-major (nodes * groups) x ordinates
+    // matrix, which is multiplied by the transpose of the cached
+    // moments x ordinates transfer matrix
+    int const number_of_rows = number_of_nodes * number_of_groups;
+    Eigen::Map<Eigen::MatrixXd const> const transfer(angular_discretization_->discrete_to_moment_matrix().data(),
+                                                     number_of_moments,
+                                                     number_of_ordinates);
+    
     #pragma omp parallel for schedule(dynamic, 10)
     for (int i = 0; i < number_of_points; ++i)
     {
-        for (int g = 0; g < number_of_groups; ++g)
-        {
-            for (int n = 0; n < number_of_nodes; ++n)
-            {
-                for (int m = 0; m < number_of_moments; ++m)
-                {
-                    double sum = 0;
-                    
-                    for (int o = 0; o < number_of_ordinates; ++o)
-                    {
-                        int k = n + number_of_nodes * (g + number_of_groups * (o + number_of_ordinates * i));
-                        double p = angular_discretization_->moment(m, o);
-                        
-                        sum += weights[o] * p * y[k];
-                    }
-                    
-                    int k = n + number_of_nodes * (g + number_of_groups * (m + number_of_moments * i));
-                    
-                    x[k] = sum;
-                }
-            }
-        }
+        Eigen::Map<Eigen::MatrixXd const> const source(&psi[number_of_rows * number_of_ordinates * i],
+                                                       number_of_rows,
+                                                       number_of_ordinates);
+        Eigen::Map<Eigen::MatrixXd> result(&phi[number_of_rows * number_of_moments * i],
+                                           number_of_rows,
+                                           number_of_moments);
+        result.noalias() = source * transfer.transpose();
     }
 }
 
@@ -40,6 +40,13 @@ public:
 private:
     
     virtual void apply(std::vector<double> &x) const override;
+    virtual void apply_buffered(std::vector<double> const &x,
+                                std::vector<double> &y,
+                                Vector_Workspace &workspace) const override;
+
+    // Convert psi into phi, which is resized
+    void discrete_to_moment(std::vector<double> const &psi,
+                            std::vector<double> &phi) const;
 
     int row_size_;
     int column_size_;
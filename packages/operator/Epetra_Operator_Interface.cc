@@ -29,30 +29,33 @@ Apply(Epetra_MultiVector const &X,
     int const size = oper_->row_size();
     int const number_of_vectors = X.NumVectors();
     
-    vector<double> x(size * number_of_vectors);
-    X.ExtractCopy(&x[0], X.Stride());
-    
     if (number_of_vectors > 1)
     {
+        vector<double> x(size * number_of_vectors);
+        X.ExtractCopy(&x[0], X.Stride());
+        
         for (int i = 0; i < number_of_vectors; ++i)
         {
-            vector<double> x1(x.begin() + i * size, x.begin() + (i + 1) * size);
+            x_.assign(x.begin() + i * size, x.begin() + (i + 1) * size);
             
-            (*oper_)(x1);
+            (*oper_)(x_, y_, workspace_);
             
             for (int j = 0; j < size; ++j)
             {
-                Y.ReplaceGlobalValue(j, i, x1[j]);
+                Y.ReplaceGlobalValue(j, i, y_[j]);
             }
         }
     }
     else
     {
-        (*oper_)(x);
+        x_.resize(size);
+        X.ExtractCopy(&x_[0], X.Stride());
+        
+        (*oper_)(x_, y_, workspace_);
         
         for (int i = 0; i < size; ++i)
         {
-            Y.ReplaceGlobalValue(i, 0, x[i]);
+            Y.ReplaceGlobalValue(i, 0, y_[i]);
         }
     }
     
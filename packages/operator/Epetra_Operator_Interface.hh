@@ -2,6 +2,7 @@
 #define Epetra_Operator_Interface_hh
 
 #include <memory>
+#include <vector>
 
 #ifdef EPETRA_MPI
 #  include <Epetra_MpiComm.h>
@@ -13,6 +14,7 @@
 #include <Epetra_Operator.h>
 
 #include "Vector_Operator.hh"
+#include "Vector_Workspace.hh"
 
 /*
   Wraps a Vector_Operator to create an Epetra_Operator object
@@ -96,6 +98,11 @@ private:
     std::shared_ptr<Epetra_Comm> comm_;
     std::shared_ptr<Epetra_Map> map_;
     std::shared_ptr<Vector_Operator> oper_;
+
+    // Buffers reused between applications
+    mutable std::vector<double> x_;
+    mutable std::vector<double> y_;
+    mutable Vector_Workspace workspace_;
 };
 
 #endif
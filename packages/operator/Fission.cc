@@ -7,9 +7,12 @@
 #include <memory>
 #include <vector>
 
+#include <Eigen/Dense>
+
 #include "Angular_Discretization.hh"
 #include "Check.hh"
 #include "Cross_Section.hh"
+#include "Cross_Section_Table.hh"
 #include "Dimensional_Moments.hh"
 #include "Energy_Discretization.hh"
 #include "Material.hh"
@@ -28,6 +31,21 @@ Fission(shared_ptr<Spatial_Discretization> spatial_discretization,
                         energy_discretization,
                         options)
 {
+    int number_of_points = spatial_discretization_->number_of_points();
+    vector<shared_ptr<Cross_Section> > nu(number_of_points);
+    vector<shared_ptr<Cross_Section> > sigma_f(number_of_points);
+    vector<shared_ptr<Cross_Section> > chi(number_of_points);
+    for (int i = 0; i < number_of_points; ++i)
+    {
+        shared_ptr<Material> material = spatial_discretization_->point(i)->material();
+        nu[i] = material->nu();
+        sigma_f[i] = material->sigma_f();
+        chi[i] = material->chi();
+    }
+    nu_ = make_shared<Cross_Section_Table>(nu);
+    sigma_f_ = make_shared<Cross_Section_Table>(sigma_f);
+    chi_ = make_shared<Cross_Section_Table>(chi);
+    
     check_class_invariants();
 }
 
@@ -37,18 +55,23 @@ check_class_invariants() const
     Assert(spatial_discretization_);
     Assert(angular_discretization_);
     Assert(energy_discretization_);
-
+    Assert(nu_);
+    Assert(sigma_f_);
+    Assert(chi_);
+    
     int number_of_points = spatial_discretization_->number_of_points();
+    Assert(nu_->number_of_points() == number_of_points);
+    Assert(sigma_f_->number_of_points() == number_of_points);
+    Assert(chi_->number_of_points() == number_of_points);
     
     // For now, assume that all points have the same energy dependence
-    Cross_Section::Dependencies::Energy energy_dep = spatial_discretization_->point(0)->material()->sigma_f()->dependencies().energy;
+    Cross_Section::Dependencies::Energy energy_dep = sigma_f_->dependencies(0).energy;
     for (int i = 0; i < number_of_points; ++i)
     {
-        shared_ptr<Material> material = spatial_discretization_->point(i)->material();
         vector<Cross_Section::Dependencies> deps
-            = {material->nu()->dependencies(),
-               material->sigma_f()->dependencies(),
-               material->chi()->dependencies()};
+            = {nu_->dependencies(i),
+               sigma_f_->dependencies(i),
+               chi_->dependencies(i)};
         
         for (Cross_Section::Dependencies &dep : deps)
         {
@@ -71,7 +94,7 @@ check_class_invariants() const
 void Fission::
 apply_full(vector<double> &x) const
 {
-    switch (spatial_discretization_->point(0)->material()->sigma_f()->dependencies().energy)
+    switch (sigma_f_->dependencies(0).energy)
     {
     case Cross_Section::Dependencies::Energy::GROUP:
         group_full(x);
@@ -88,7 +111,7 @@ apply_full(vector<double> &x) const
 void Fission::
 apply_coherent(vector<double> &x) const
 {
-    switch (spatial_discretization_->point(0)->material()->sigma_f()->dependencies().energy)
+    switch (sigma_f_->dependencies(0).energy)
     {
     case Cross_Section::Dependencies::Energy::GROUP:
         group_coherent(x);
@@ -116,30 +139,25 @@ group_to_group_full(vector<double> &x) const
     #pragma omp parallel for schedule(dynamic, 10)
     for (int i = 0; i < number_of_points; ++i)
     {
-        shared_ptr<Cross_Section> sigma_f_cs = spatial_discretization_->point(i)->material()->sigma_f();
-        vector<double> const sigma_f = sigma_f_cs->data();
+        double const *sigma_f = sigma_f_->data(i);
         
+        // Perform fission: the zeroth moment of the flux is a (nodes x groups)
+        // matrix, and the cross section a (gf x gt) matrix
         int m = 0;
         int d = 0;
-        for (int gt = 0; gt < number_of_groups; ++gt)
-        {
-            for (int n = 0; n < number_of_nodes; ++n)
-            {
-                double sum = 0;
-                    
-                for (int gf = 0; gf < number_of_groups; ++gf)
-                {
-                    int k_phi_from = n + number_of_nodes * (gf + number_of_groups * (m + number_of_moments * i));
-                    int k_sigma = d + number_of_dimensional_moments * (gf + number_of_groups * gt);
-                    
-                    sum += sigma_f[k_sigma] * y[k_phi_from];
-                }
-                            
-                int k_phi_to = n + number_of_nodes * (gt + number_of_groups * (m + number_of_moments * i));
-                    
-                x[k_phi_to] = sum;
-            }
-        }
+        int k_phi = number_of_nodes * number_of_groups * (m + number_of_moments * i);
+        Eigen::Map<Eigen::MatrixXd const, 0, Eigen::Stride<Eigen::Dynamic, Eigen::Dynamic> > const sigma(&sigma_f[d],
+                                                                                                         number_of_groups,
+                                                                                                         number_of_groups,
+                                                                                                         Eigen::Stride<Eigen::Dynamic, Eigen::Dynamic>(number_of_groups * number_of_dimensional_moments,
+                                                                                                                                                       number_of_dimensional_moments));
+        Eigen::Map<Eigen::MatrixXd const> const phi_from(&y[k_phi],
+                                                         number_of_nodes,
+                                                         number_of_groups);
+        Eigen::Map<Eigen::MatrixXd> phi_to(&x[k_phi],
+                                           number_of_nodes,
+                                           number_of_groups);
+        phi_to.noalias() = phi_from * sigma;
     }
     
     // Zero out other moments
@@ -182,10 +200,9 @@ group_full(vector<double> &x) const
         #pragma omp parallel for schedule(dynamic, 10)
         for (int i = 0; i < number_of_points; ++i)
         {
-            shared_ptr<Material> material = spatial_discretization_->point(i)->material();
-            vector<double> const nu = material->nu()->data();
-            vector<double> const sigma_f = material->sigma_f()->data();
-            vector<double> const chi = material->chi()->data();
+            double const *nu = nu_->data(i);
+            double const *sigma_f = sigma_f_->data(i);
+            double const *chi = chi_->data(i);
             
             for (int n = 0; n < number_of_nodes; ++n)
             {
@@ -248,10 +265,9 @@ group_coherent(vector<double> &x) const
         #pragma omp parallel for schedule(dynamic, 10)
         for (int i = 0; i < number_of_points; ++i)
         {
-            shared_ptr<Material> material = spatial_discretization_->point(i)->material();
-            vector<double> const nu = material->nu()->data();
-            vector<double> const sigma_f = material->sigma_f()->data();
-            vector<double> const chi = material->chi()->data();
+            double const *nu = nu_->data(i);
+            double const *sigma_f = sigma_f_->data(i);
+            double const *chi = chi_->data(i);
             
             for (int g = 0; g < number_of_groups; ++g)
             {
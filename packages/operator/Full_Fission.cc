@@ -69,7 +69,7 @@ apply_full(vector<double> &x) const
         // Get cross section information
         shared_ptr<Weight_Function> weight = spatial_discretization_->weight(i);
         shared_ptr<Cross_Section> const sigma_f_cs = weight->material()->sigma_f();
-        vector<double> const sigma_f = sigma_f_cs->data();
+        vector<double> const &sigma_f = sigma_f_cs->data();
         int const number_of_basis_functions = weight->number_of_basis_functions();
         vector<int> const basis_function_indices = weight->basis_function_indices();
         
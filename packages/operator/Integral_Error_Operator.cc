@@ -116,7 +116,7 @@ apply(vector<double> &x) const
     for (int i = 0; i < number_of_cells; ++i)
     {
         // Get cell
-        shared_ptr<Integration_Cell> const cell = mesh_->cell(i);
+        Integration_Cell const &cell = mesh_->cell(i);
         
         // Get quadrature
         int number_of_ordinates;
@@ -239,16 +239,16 @@ apply(vector<double> &x) const
 }
 
 void Integral_Error_Operator::
-get_flux(shared_ptr<Integration_Cell> const cell,
+get_flux(Integration_Cell const &cell,
          vector<double> const &b_val,
          vector<double> const &coeff,
          vector<double> &flux) const
 {
     // Calculate flux
     flux.assign(number_per_point_, 0.);
-    for (int i = 0; i < cell->number_of_basis_functions; ++i)
+    for (int i = 0; i < cell.number_of_basis_functions; ++i)
     {
-        int const j = cell->basis_indices[i];
+        int const j = cell.basis_indices[i];
         for (int l = 0; l < number_per_point_; ++l)
         {
             int const k_f = l; // Local flux index
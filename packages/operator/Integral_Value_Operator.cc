@@ -7,7 +7,6 @@
 #include <iostream>
 
 #include "Angular_Discretization.hh"
-#include "Basis_Function.hh"
 #include "Energy_Discretization.hh"
 #include "Integration_Mesh.hh"
 #include "Weak_Spatial_Discretization.hh"
@@ -52,90 +51,100 @@ check_class_invariants() const
 
     if (initialized_)
     {
-        Assert(mesh_);
+        int number_of_cells = matrix_offsets_.size() - 1;
+        Assert(number_of_cells >= 0);
+        Assert(static_cast<int>(matrix_indices_.size()) == matrix_offsets_[number_of_cells]);
+        Assert(static_cast<int>(matrix_values_.size()) == matrix_offsets_[number_of_cells]);
     }
 }
 
 void Integral_Value_Operator::
 apply(vector<double> &x) const
+{
+    vector<double> result;
+    multiply(x,
+             result);
+    
+    // Put result into "x"
+    x.swap(result);
+}
+
+void Integral_Value_Operator::
+apply_buffered(vector<double> const &x,
+               vector<double> &y,
+               Vector_Workspace &workspace) const
+{
+    multiply(x,
+             y);
+}
+
+void Integral_Value_Operator::
+initialize_matrix() const
 {
     // Get size data
     int number_of_points = spatial_->number_of_points();
-    int number_of_groups = energy_->number_of_groups();
-    int number_of_moments = angular_->number_of_moments();
-
-    // Initialize if applicable
-    if (!initialized_)
-    {
-        mesh_ = make_shared<Integration_Mesh>(spatial_->dimension(),
-                                              number_of_points,
-                                              integration_options_,
-                                              spatial_->bases(),
-                                              spatial_->weights());
-        initialized_ = true;
-    }
 
+    // Create mesh, which is only needed to build the matrix
+    shared_ptr<Integration_Mesh> mesh
+        = make_shared<Integration_Mesh>(spatial_->dimension(),
+                                        number_of_points,
+                                        integration_options_,
+                                        spatial_->bases(),
+                                        spatial_->weights());
+    
     // Ensure row size initialization is correct
-    int number_of_cells = mesh_->number_of_cells();
+    int number_of_cells = mesh->number_of_cells();
     Assert(row_size_ == (number_of_cells
                          * angular_->number_of_moments()
                          * energy_->number_of_groups()));
+
+    // Get the row offsets from the cell connectivity
+    matrix_offsets_.resize(number_of_cells + 1);
+    matrix_offsets_[0] = 0;
+    for (int i = 0; i < number_of_cells; ++i)
+    {
+        matrix_offsets_[i + 1] = matrix_offsets_[i] + mesh->cell(i).number_of_basis_functions;
+    }
+    matrix_indices_.resize(matrix_offsets_[number_of_cells]);
+    matrix_values_.assign(matrix_offsets_[number_of_cells], 0.);
     
-    // Apply operator
-    vector<double> result(row_size_, 0.);
+    // Integrate the basis functions over each cell
     #pragma omp parallel for schedule(dynamic, 10)
     for (int i = 0; i < number_of_cells; ++i)
     {
         // Get cell
-        shared_ptr<Integration_Cell> const cell = mesh_->cell(i);
+        Integration_Cell const &cell = mesh->cell(i);
+        int const offset = matrix_offsets_[i];
         
         // Get quadrature
         int number_of_ordinates;
         vector<vector<double> > ordinates;
         vector<double> weights;
-        mesh_->get_volume_quadrature(i,
-                                     number_of_ordinates,
-                                     ordinates,
-                                     weights);
+        mesh->get_volume_quadrature(i,
+                                    number_of_ordinates,
+                                    ordinates,
+                                    weights);
 
         // Get center positions
         vector<vector<double> > basis_centers;
-        mesh_->get_basis_centers(cell,
-                                 basis_centers);
-        
+        mesh->get_basis_centers(cell,
+                                basis_centers);
+
+        // Add the weighted basis values at each quadrature point
+        vector<double> b_val;
         for (int q = 0; q < number_of_ordinates; ++q)
         {
-            // Get quadrature position and weight
-            double const weight = weights[q];
-            vector<double> const &position = ordinates[q];
+            mesh->get_basis_values(cell,
+                                   ordinates[q],
+                                   basis_centers,
+                                   b_val);
             
-            // Get volume values
-            vector<double> b_val;
-            mesh_->get_basis_values(cell,
-                                    position,
-                                    basis_centers,
-                                    b_val);
-
-            // Get flux
-            vector<double> flux;
-            get_flux(cell,
-                     b_val,
-                     x,
-                     flux);
-
-            // Add to integral
-            for (int m = 0; m < number_of_moments; ++m)
+            for (int j = 0; j < cell.number_of_basis_functions; ++j)
             {
-                for (int g = 0; g < number_of_groups; ++g)
-                {
-                    int k_res = g + number_of_groups * (m + number_of_moments * i);
-                    int k_flux = g + number_of_groups * m;
-                    
-                    result[k_res] += flux[k_flux] * weight;
-                }
+                matrix_values_[offset + j] += b_val[j] * weights[q];
             }
         }
-
+        
         // Get the volume (sum of weights)
         double volume = 0;
         for (double weight : weights)
@@ -144,43 +153,50 @@ apply(vector<double> &x) const
         }
         
         // Normalize to account for the volume
-        for (int m = 0; m < number_of_moments; ++m)
+        for (int j = 0; j < cell.number_of_basis_functions; ++j)
         {
-            for (int g = 0; g < number_of_groups; ++g)
-            {
-                int k = g + number_of_groups * (m + number_of_moments * i);
-                result[k] /= volume;
-            }
+            matrix_indices_[offset + j] = cell.basis_indices[j];
+            matrix_values_[offset + j] /= volume;
         }
     }
     
-    // Put result into "x"
-    x.swap(result);
+    initialized_ = true;
+    check_class_invariants();
 }
 
 void Integral_Value_Operator::
-get_flux(shared_ptr<Integration_Cell> const cell,
-         vector<double> const &b_val,
-         vector<double> const &coeff,
-         vector<double> &flux) const
+multiply(vector<double> const &coeff,
+         vector<double> &result) const
 {
-    // Get size information
-    int const number_of_groups = energy_->number_of_groups();
-    int const number_of_moments = angular_->number_of_moments();
-
-    // Calculate flux
-    flux.assign(number_of_groups * number_of_moments, 0.);
-    for (int i = 0; i < cell->number_of_basis_functions; ++i)
+    // Initialize on first use, once even if applications are concurrent
+    std::call_once(matrix_flag_,
+                   &Integral_Value_Operator::initialize_matrix,
+                   this);
+    
+    // Get size data
+    int const number_of_cells = matrix_offsets_.size() - 1;
+    int const block_size = (energy_->number_of_groups()
+                            * angular_->number_of_moments());
+
+    // Apply operator: the (moment, group) values for each cell and basis
+    // function are contiguous, so each nonzero scales a block
+    result.resize(row_size_);
+    #pragma omp parallel for schedule(static)
+    for (int i = 0; i < number_of_cells; ++i)
     {
-        int const j = cell->basis_indices[i];
-        for (int m = 0; m < number_of_moments; ++m)
+        double *result_block = &result[block_size * i];
+        for (int k = 0; k < block_size; ++k)
         {
-            for (int g = 0; g < number_of_groups; ++g)
+            result_block[k] = 0.;
+        }
+        
+        for (int l = matrix_offsets_[i]; l < matrix_offsets_[i + 1]; ++l)
+        {
+            double const value = matrix_values_[l];
+            double const *coeff_block = &coeff[block_size * matrix_indices_[l]];
+            for (int k = 0; k < block_size; ++k)
             {
-                int const k_f = g + number_of_groups * m; // Local flux index
-                int const k_c = g + number_of_groups * (m + number_of_moments * j); // Global coefficient index
-
-                flux[k_f] += b_val[i] * coeff[k_c];
+                result_block[k] += value * coeff_block[k];
             }
         }
     }
@@ -5,6 +5,7 @@
 #include "Vector_Operator.hh"
 
 #include <memory>
+#include <mutex>
 #include <vector>
 
 class Angular_Discretization;
@@ -38,11 +39,16 @@ public:
 private:
 
     virtual void apply(std::vector<double> &x) const override;
-    
-    void get_flux(std::shared_ptr<Integration_Cell> const cell,
-                  std::vector<double> const &b_val,
-                  std::vector<double> const &coeff,
-                  std::vector<double> &flux) const;
+    virtual void apply_buffered(std::vector<double> const &x,
+                                std::vector<double> &y,
+                                Vector_Workspace &workspace) const override;
+
+    // Build the cell average matrix from the integration mesh
+    void initialize_matrix() const;
+
+    // Multiply each (moment, group) block of the coefficients by the matrix
+    void multiply(std::vector<double> const &coeff,
+                  std::vector<double> &result) const;
     
     int row_size_;
     int column_size_;
@@ -51,9 +57,15 @@ private:
     std::shared_ptr<Weak_Spatial_Discretization> spatial_;
     std::shared_ptr<Angular_Discretization> angular_;
     std::shared_ptr<Energy_Discretization> energy_;
-    
+
+    // The map from coefficients to cell averages is linear and depends only
+    // on the mesh, so it is stored on the first application as a CSR
+    // matrix with a row for each cell and a column for each basis function
+    mutable std::once_flag matrix_flag_;
     mutable bool initialized_;
-    mutable std::shared_ptr<Integration_Mesh> mesh_;
+    mutable std::vector<int> matrix_offsets_;
+    mutable std::vector<int> matrix_indices_;
+    mutable std::vector<double> matrix_values_;
 };
 
 #endif
@@ -66,7 +66,7 @@ apply(vector<double> &x) const
     {
         shared_ptr<Cross_Section> internal_source
             = spatial_->point(i)->material()->internal_source();
-        vector<double> const data = internal_source->data();
+        vector<double> const &data = internal_source->data();
         Cross_Section::Dependencies deps = internal_source->dependencies();
 
         int d = 0;
@@ -22,6 +22,11 @@ public:
         return size_;
     }
     virtual std::string description() const override = 0;
+
+    virtual std::vector<std::shared_ptr<Vector_Operator> > children() const override
+    {
+        return {vector_operator_};
+    }
     
 protected:
 
@@ -4,8 +4,10 @@
     #include <omp.h>
 #endif
 
-#include "Check.hh"
+#include <Eigen/Dense>
+
 #include "Angular_Discretization.hh"
+#include "Check.hh"
 #include "Energy_Discretization.hh"
 #include "Spatial_Discretization.hh"
 
@@ -37,45 +39,49 @@ Moment_To_Discrete(shared_ptr<Spatial_Discretization> spatial_discretization,
 void Moment_To_Discrete::
 apply(vector<double> &x) const
 {
-    vector<double> y(x);
+    vector<double> const y(x);
     
-    x.resize(row_size());
+    moment_to_discrete(y, x);
+}
+
+void Moment_To_Discrete::
+apply_buffered(vector<double> const &x,
+               vector<double> &y,
+               Vector_Workspace &workspace) const
+{
+    moment_to_discrete(x, y);
+}
+
+void Moment_To_Discrete::
+moment_to_discrete(vector<double> const &phi,
+                   vector<double> &psi) const
+{
+    psi.resize(row_size());
     
     int number_of_points = spatial_discretization_->number_of_points();
     int number_of_nodes = spatial_discretization_->number_of_nodes();
     int number_of_groups = energy_discretization_->number_of_groups();
     int number_of_moments = angular_discretization_->number_of_moments();
     int number_of_ordinates = angular_discretization_->number_of_ordinates();
-    double angular_normalization = angular_discretization_->angular_normalization();
-    vector<int> const scattering_indices = angular_discretization_->scattering_indices();
 
+    // The data for each point is a column-major (nodes * groups) x moments
+    // matrix, which is multiplied by the transpose of the cached
+    // ordinates x moments transfer matrix
+    int const number_of_rows = number_of_nodes * number_of_groups;
+    Eigen::Map<Eigen::MatrixXd const> const transfer(angular_discretization_->moment_to_discrete_matrix().data(),
+                                                     number_of_ordinates,
+                                                     number_of_moments);
+    
     #pragma omp parallel for schedule(dynamic, 10)
     for (int i = 0; i < number_of_points; ++i)
     {
-        for (int g = 0; g < number_of_groups; ++g)
-        {
-            for (int n = 0; n < number_of_nodes; ++n)
-            {
-                for (int o = 0; o < number_of_ordinates; ++o)
-                {
-                    double sum = 0;
-                    
-                    for (int m = 0; m < number_of_moments; ++m)
-                    {
-                        int k = n + number_of_nodes * (g + number_of_groups * (m + number_of_moments * i));
-                        int l = scattering_indices[m];
-
-                        double p = angular_discretization_->moment(m, o);
-                        
-                        sum += (2 * static_cast<double>(l) + 1) / angular_normalization * p * y[k];
-                    }
-                    
-                    int k = n + number_of_nodes * (g + number_of_groups * (o + number_of_ordinates * i));
-                    
-                    x[k] = sum;
-                }
-            }
-        }
+        Eigen::Map<Eigen::MatrixXd const> const source(&phi[number_of_rows * number_of_moments * i],
+                                                       number_of_rows,
+                                                       number_of_moments);
+        Eigen::Map<Eigen::MatrixXd> result(&psi[number_of_rows * number_of_ordinates * i],
+                                           number_of_rows,
+                                           number_of_ordinates);
+        result.noalias() = source * transfer.transpose();
     }
 }
 
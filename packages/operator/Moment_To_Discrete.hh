@@ -40,6 +40,13 @@ public:
 private:
 
     virtual void apply(std::vector<double> &x) const override;
+    virtual void apply_buffered(std::vector<double> const &x,
+                                std::vector<double> &y,
+                                Vector_Workspace &workspace) const override;
+
+    // Convert phi into psi, which is resized
+    void moment_to_discrete(std::vector<double> const &phi,
+                            std::vector<double> &psi) const;
     
     bool include_dimensional_moments_;
     int row_size_;
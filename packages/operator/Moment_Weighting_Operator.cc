@@ -95,12 +95,12 @@ apply(vector<double> &x) const
         // Get weight function and data
         shared_ptr<Weight_Function> weight = spatial_->weight(i);
         int number_of_basis_functions = weight->number_of_basis_functions();
-        Weight_Function::Integrals const integrals = weight->integrals();
+        Weight_Function::Integrals const &integrals = weight->integrals();
         vector<int> basis_indices = weight->basis_function_indices();
 
-        vector<double> const &iv_w = integrals.iv_w;
-        vector<double> const &iv_b_w = integrals.iv_b_w;
-        vector<double> const &iv_b_dw = integrals.iv_b_dw;
+        Integral_Span const &iv_w = integrals.iv_w;
+        Integral_Span const &iv_b_w = integrals.iv_b_w;
+        Integral_Span const &iv_b_dw = integrals.iv_b_dw;
         
         // Get normalization constant
         double const norm = include_normalization ? iv_w[0] : 1;
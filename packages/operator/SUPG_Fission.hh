@@ -6,6 +6,8 @@
 
 #include "SUPG_Scattering_Operator.hh"
 
+class Cross_Section_Table;
+
 /*
   Applies fission to a moment representation of the flux
 */
@@ -28,6 +30,11 @@ public:
     
 private: 
     
+    // Fission cross sections of each point
+    std::shared_ptr<Cross_Section_Table> nu_;
+    std::shared_ptr<Cross_Section_Table> sigma_f_;
+    std::shared_ptr<Cross_Section_Table> chi_;
+    
     // Apply within-group and out-of-group fission
     virtual void apply_full(std::vector<double> &x) const override;
     
@@ -7,9 +7,12 @@
     #include <omp.h>
 #endif
 
+#include <Eigen/Dense>
+
 #include "Angular_Discretization.hh"
 #include "Check.hh"
 #include "Cross_Section.hh"
+#include "Cross_Section_Table.hh"
 #include "Dimensional_Moments.hh"
 #include "Energy_Discretization.hh"
 #include "Material.hh"
@@ -28,6 +31,14 @@ SUPG_Scattering(shared_ptr<Spatial_Discretization> spatial_discretization,
                         energy_discretization,
                         options)
 {
+    int number_of_points = spatial_discretization_->number_of_points();
+    vector<shared_ptr<Cross_Section> > sigma_s(number_of_points);
+    for (int i = 0; i < number_of_points; ++i)
+    {
+        sigma_s[i] = spatial_discretization_->point(i)->material()->sigma_s();
+    }
+    sigma_s_ = make_shared<Cross_Section_Table>(sigma_s);
+    
     check_class_invariants();
 }
 
@@ -37,13 +48,14 @@ check_class_invariants() const
     Assert(spatial_discretization_);
     Assert(angular_discretization_);
     Assert(energy_discretization_);
-
+    Assert(sigma_s_);
+    Assert(sigma_s_->number_of_points() == spatial_discretization_->number_of_points());
+    
     int number_of_points = spatial_discretization_->number_of_points();
     for (int i = 0; i < number_of_points; ++i)
     {
-        shared_ptr<Material> material = spatial_discretization_->point(i)->material();
-        Cross_Section::Dependencies dep = material->sigma_s()->dependencies();
         // Make sure angular and energy dependencies for each point are correct
+        Cross_Section::Dependencies const &dep = sigma_s_->dependencies(i);
         Assert(dep.angular == Cross_Section::Dependencies::Angular::SCATTERING_MOMENTS
                || dep.angular == Cross_Section::Dependencies::Angular::MOMENTS);
         Assert(dep.energy == Cross_Section::Dependencies::Energy::GROUP_TO_GROUP);
@@ -59,8 +71,7 @@ apply_full(vector<double> &x) const
     int number_of_nodes = spatial_discretization_->number_of_nodes();
     int number_of_groups = energy_discretization_->number_of_groups();
     int number_of_moments = angular_discretization_->number_of_moments();
-    int number_of_scattering_moments = angular_discretization_->number_of_scattering_moments();
-    vector<int> const scattering_indices = angular_discretization_->scattering_indices();
+    vector<int> const &scattering_indices = angular_discretization_->scattering_indices();
 
     // Get dimensional moments
     shared_ptr<Dimensional_Moments> dimensional_moments = spatial_discretization_->dimensional_moments();
@@ -75,86 +86,43 @@ apply_full(vector<double> &x) const
     for (int i = 0; i < number_of_points; ++i)
     {
         // Get cross section information
-        shared_ptr<Cross_Section> sigma_s_cs = spatial_discretization_->point(i)->material()->sigma_s();
-        vector<double> const sigma_s = sigma_s_cs->data();
-        Cross_Section::Dependencies::Angular angular_dep = sigma_s_cs->dependencies().angular;
+        double const *sigma_s = sigma_s_->data(i);
+        bool const scattering_moments
+            = sigma_s_->dependencies(i).angular == Cross_Section::Dependencies::Angular::SCATTERING_MOMENTS;
         
-        switch (angular_dep)
+        // Perform scattering: for each pair of dimensional moments, the flux
+        // is a (nodes x groups) matrix and the cross section a (gf x gt) matrix
+        for (int m = 0; m < number_of_moments; ++m)
         {
-        case Cross_Section::Dependencies::Angular::SCATTERING_MOMENTS:
-        {
-            // Perform scattering
-            for (int m = 0; m < number_of_moments; ++m)
+            int l = scattering_moments ? scattering_indices[m] : m;
+            
+            for (int d1 = 0; d1 < number_of_dimensional_moments; ++d1)
             {
-                int l = scattering_indices[m];
+                int k_phi_from = number_of_nodes * (d1 + number_of_dimensional_moments * number_of_groups * (m + number_of_moments * i));
+                Eigen::Map<Eigen::MatrixXd const, 0, Eigen::OuterStride<> > const phi_from(&y[k_phi_from],
+                                                                                           number_of_nodes,
+                                                                                           number_of_groups,
+                                                                                           Eigen::OuterStride<>(number_of_nodes * number_of_dimensional_moments));
                 
-                for (int gt = 0; gt < number_of_groups; ++gt)
-                {
-                    for (int n = 0; n < number_of_nodes; ++n)
-                    {
-                        for (int d1 = 0; d1 < number_of_dimensional_moments; ++d1)
-                        {
-                            for (int d2 = 0; d2 < number_of_dimensional_moments; ++d2)
-                            {
-                                double sum = 0;
-                                
-                                for (int gf = 0; gf < number_of_groups; ++gf)
-                                {
-                                    int k_phi_from = n + number_of_nodes * (d1 + number_of_dimensional_moments * (gf + number_of_groups * (m + number_of_moments * i)));
-                                    int k_sigma = d2 + number_of_dimensional_moments * (gf + number_of_groups * (gt + number_of_groups * l));
-                                    
-                                    sum += sigma_s[k_sigma] * y[k_phi_from];
-                                }
-
-                                int d = dimensional_indices[d1 + number_of_dimensional_moments * d2];
-                                int k_phi_to = n + number_of_nodes * (d + number_of_double_dimensional_moments * (gt + number_of_groups * (m + number_of_moments * i)));
-                                
-                                x[k_phi_to] += sum;
-                            }
-                        }
-                    }
-                }
-            }
-            break;
-        } // SCATTERING_MOMENTS
-        case Cross_Section::Dependencies::Angular::MOMENTS:
-        {
-            // Perform scattering
-            for (int m = 0; m < number_of_moments; ++m)
-            {
-                for (int gt = 0; gt < number_of_groups; ++gt)
+                for (int d2 = 0; d2 < number_of_dimensional_moments; ++d2)
                 {
-                    for (int n = 0; n < number_of_nodes; ++n)
-                    {
-                        for (int d1 = 0; d1 < number_of_dimensional_moments; ++d1)
-                        {
-                            for (int d2 = 0; d2 < number_of_dimensional_moments; ++d2)
-                            {
-                                double sum = 0;
-                                
-                                for (int gf = 0; gf < number_of_groups; ++gf)
-                                {
-                                    int k_phi_from = n + number_of_nodes * (d1 + number_of_dimensional_moments * (gf + number_of_groups * (m + number_of_moments * i)));
-                                    int k_sigma = d2 + number_of_dimensional_moments * (gf + number_of_groups * (gt + number_of_groups * m));
-                                    
-                                    sum += sigma_s[k_sigma] * y[k_phi_from];
-                                }
-
-                                int d = dimensional_indices[d1 + number_of_dimensional_moments * d2];
-                                int k_phi_to = n + number_of_nodes * (d + number_of_double_dimensional_moments * (gt + number_of_groups * (m + number_of_moments * i)));
-                                
-                                x[k_phi_to] += sum;
-                            }
-                        }
-                    }
+                    int d = dimensional_indices[d1 + number_of_dimensional_moments * d2];
+                    int k_sigma = d2 + number_of_dimensional_moments * number_of_groups * number_of_groups * l;
+                    int k_phi_to = number_of_nodes * (d + number_of_double_dimensional_moments * number_of_groups * (m + number_of_moments * i));
+                    
+                    Eigen::Map<Eigen::MatrixXd const, 0, Eigen::Stride<Eigen::Dynamic, Eigen::Dynamic> > const sigma(&sigma_s[k_sigma],
+                                                                                                                     number_of_groups,
+                                                                                                                     number_of_groups,
+                                                                                                                     Eigen::Stride<Eigen::Dynamic, Eigen::Dynamic>(number_of_groups * number_of_dimensional_moments,
+                                                                                                                                                                   number_of_dimensional_moments));
+                    Eigen::Map<Eigen::MatrixXd, 0, Eigen::OuterStride<> > phi_to(&x[k_phi_to],
+                                                                                 number_of_nodes,
+                                                                                 number_of_groups,
+                                                                                 Eigen::OuterStride<>(number_of_nodes * number_of_double_dimensional_moments));
+                    phi_to.noalias() += phi_from * sigma;
                 }
             }
-            break;
-        } // MOMENTS
-        default:
-            Assert(false);
-            break;
-        } // switch (angular_dep)
+        }
     } // points
 }
 
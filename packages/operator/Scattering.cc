@@ -7,9 +7,12 @@
     #include <omp.h>
 #endif
 
+#include <Eigen/Dense>
+
 #include "Angular_Discretization.hh"
 #include "Check.hh"
 #include "Cross_Section.hh"
+#include "Cross_Section_Table.hh"
 #include "Dimensional_Moments.hh"
 #include "Energy_Discretization.hh"
 #include "Material.hh"
@@ -28,6 +31,14 @@ Scattering(shared_ptr<Spatial_Discretization> spatial_discretization,
                         energy_discretization,
                         options)
 {
+    int number_of_points = spatial_discretization_->number_of_points();
+    vector<shared_ptr<Cross_Section> > sigma_s(number_of_points);
+    for (int i = 0; i < number_of_points; ++i)
+    {
+        sigma_s[i] = spatial_discretization_->point(i)->material()->sigma_s();
+    }
+    sigma_s_ = make_shared<Cross_Section_Table>(sigma_s);
+    
     check_class_invariants();
 }
 
@@ -37,13 +48,14 @@ check_class_invariants() const
     Assert(spatial_discretization_);
     Assert(angular_discretization_);
     Assert(energy_discretization_);
-
+    Assert(sigma_s_);
+    Assert(sigma_s_->number_of_points() == spatial_discretization_->number_of_points());
+    
     int number_of_points = spatial_discretization_->number_of_points();
     for (int i = 0; i < number_of_points; ++i)
     {
-        shared_ptr<Material> material = spatial_discretization_->point(i)->material();
-        Cross_Section::Dependencies dep = material->sigma_s()->dependencies();
         // Make sure angular and energy dependencies for each point are correct
+        Cross_Section::Dependencies const &dep = sigma_s_->dependencies(i);
         Assert(dep.angular == Cross_Section::Dependencies::Angular::SCATTERING_MOMENTS
                || dep.angular == Cross_Section::Dependencies::Angular::MOMENTS);
         Assert(dep.energy == Cross_Section::Dependencies::Energy::GROUP_TO_GROUP);
@@ -52,89 +64,72 @@ check_class_invariants() const
 
 void Scattering::
 apply_full(vector<double> &x) const
+{
+    // Copy source flux
+    vector<double> const y(x);
+    
+    scatter_full(y, x);
+}
+
+void Scattering::
+apply_buffered(vector<double> const &x,
+               vector<double> &y,
+               Vector_Workspace &workspace) const
+{
+    switch (options_.scattering_type)
+    {
+    case Options::Scattering_Type::FULL:
+        scatter_full(x, y);
+        break;
+    default:
+        Scattering_Operator::apply_buffered(x, y, workspace);
+        break;
+    }
+}
+
+void Scattering::
+scatter_full(vector<double> const &x,
+             vector<double> &y) const
 {
     // Get size information
     int number_of_points = spatial_discretization_->number_of_points();
     int number_of_nodes = spatial_discretization_->number_of_nodes();
     int number_of_groups = energy_discretization_->number_of_groups();
     int number_of_moments = angular_discretization_->number_of_moments();
-    int number_of_scattering_moments = angular_discretization_->number_of_scattering_moments();
     int number_of_dimensional_moments = spatial_discretization_->dimensional_moments()->number_of_dimensional_moments();
-    vector<int> const scattering_indices = angular_discretization_->scattering_indices();
-
-    // Copy source flux
-    vector<double> y(x);
+    vector<int> const &scattering_indices = angular_discretization_->scattering_indices();
+    
+    y.resize(row_size());
     #pragma omp parallel for schedule(dynamic, 10)
     for (int i = 0; i < number_of_points; ++i)
     {
         int d = 0;
-
+        
         // Get cross section information
-        shared_ptr<Cross_Section> sigma_s_cs = spatial_discretization_->point(i)->material()->sigma_s();
-        vector<double> const sigma_s = sigma_s_cs->data();
-        Cross_Section::Dependencies::Angular angular_dep = sigma_s_cs->dependencies().angular;
+        double const *sigma_s = sigma_s_->data(i);
+        bool const scattering_moments
+            = sigma_s_->dependencies(i).angular == Cross_Section::Dependencies::Angular::SCATTERING_MOMENTS;
         
-        switch (angular_dep)
-        {
-        case Cross_Section::Dependencies::Angular::SCATTERING_MOMENTS:
-        {
-            // Perform scattering
-            for (int m = 0; m < number_of_moments; ++m)
-            {
-                int l = scattering_indices[m];
-
-                for (int gt = 0; gt < number_of_groups; ++gt)
-                {
-                    for (int n = 0; n < number_of_nodes; ++n)
-                    {
-                        double sum = 0;
-                            
-                        for (int gf = 0; gf < number_of_groups; ++gf)
-                        {
-                            int k_phi_from = n + number_of_nodes * (gf + number_of_groups * (m + number_of_moments * i));
-                            int k_sigma = d + number_of_dimensional_moments * (gf + number_of_groups * (gt + number_of_groups * l));
-                                
-                            sum += sigma_s[k_sigma] * y[k_phi_from];
-                        }
-                            
-                        int k_phi_to = n + number_of_nodes * (gt + number_of_groups * (m + number_of_moments * i));
-                        
-                        x[k_phi_to] = sum;
-                    }
-                }
-            }
-            break;
-        } // SCATTERING_MOMENTS
-        case Cross_Section::Dependencies::Angular::MOMENTS:
+        // Perform scattering: the flux for each moment is a (nodes x groups)
+        // matrix, and the cross section is a (gf x gt) matrix
+        for (int m = 0; m < number_of_moments; ++m)
         {
-            // Perform scattering
-            for (int m = 0; m < number_of_moments; ++m)
-            {
-                for (int gt = 0; gt < number_of_groups; ++gt)
-                {
-                    for (int n = 0; n < number_of_nodes; ++n)
-                    {
-                        double sum = 0;
-                        
-                        for (int gf = 0; gf < number_of_groups; ++gf)
-                        {
-                            int k_phi_from = n + number_of_nodes * (gf + number_of_groups * (m + number_of_moments * i));
-                            int k_sigma = d + number_of_dimensional_moments * (gf + number_of_groups * (gt + number_of_groups * m));
-                            
-                            sum += sigma_s[k_sigma] * y[k_phi_from];
-                        }
-                            
-                        int k_phi_to = n + number_of_nodes * (gt + number_of_groups * (m + number_of_moments * i));
-                    
-                        x[k_phi_to] = sum;
-                    }
-                }
-            }
-            break;
-        } // MOMENTS
-        default:
-            Assert(false);
-            break;
+            int l = scattering_moments ? scattering_indices[m] : m;
+            int k_phi = number_of_nodes * number_of_groups * (m + number_of_moments * i);
+            int k_sigma = d + number_of_dimensional_moments * number_of_groups * number_of_groups * l;
+            
+            Eigen::Map<Eigen::MatrixXd const, 0, Eigen::Stride<Eigen::Dynamic, Eigen::Dynamic> > const sigma(&sigma_s[k_sigma],
+                                                                                                             number_of_groups,
+                                                                                                             number_of_groups,
+                                                                                                             Eigen::Stride<Eigen::Dynamic, Eigen::Dynamic>(number_of_groups * number_of_dimensional_moments,
+                                                                                                                                                           number_of_dimensional_moments));
+            Eigen::Map<Eigen::MatrixXd const> const phi_from(&x[k_phi],
+                                                             number_of_nodes,
+                                                             number_of_groups);
+            Eigen::Map<Eigen::MatrixXd> phi_to(&y[k_phi],
+                                               number_of_nodes,
+                                               number_of_groups);
+            phi_to.noalias() = phi_from * sigma;
         }
     }
 }
@@ -147,69 +142,34 @@ apply_coherent(vector<double> &x) const
     int number_of_nodes = spatial_discretization_->number_of_nodes();
     int number_of_groups = energy_discretization_->number_of_groups();
     int number_of_moments = angular_discretization_->number_of_moments();
-    int number_of_scattering_moments = angular_discretization_->number_of_scattering_moments();
     int number_of_dimensional_moments = spatial_discretization_->dimensional_moments()->number_of_dimensional_moments();
-    vector<int> const scattering_indices = angular_discretization_->scattering_indices();
+    vector<int> const &scattering_indices = angular_discretization_->scattering_indices();
     
     for (int i = 0; i < number_of_points; ++i)
     {
         int d = 0;
 
         // Get data
-        shared_ptr<Cross_Section> sigma_s_cs = spatial_discretization_->point(i)->material()->sigma_s();
-        vector<double> const sigma_s = sigma_s_cs->data();
-        Cross_Section::Dependencies::Angular angular_dep = sigma_s_cs->dependencies().angular;
+        double const *sigma_s = sigma_s_->data(i);
+        bool const scattering_moments
+            = sigma_s_->dependencies(i).angular == Cross_Section::Dependencies::Angular::SCATTERING_MOMENTS;
         
-        switch (angular_dep)
-        {
-        case Cross_Section::Dependencies::Angular::SCATTERING_MOMENTS:
+        // Perform scattering
+        for (int m = 0; m < number_of_moments; ++m)
         {
-            // Perform scattering
-            for (int m = 0; m < number_of_moments; ++m)
+            int l = scattering_moments ? scattering_indices[m] : m;
+            
+            for (int g = 0; g < number_of_groups; ++g)
             {
-                int l = scattering_indices[m];
-
-                for (int g = 0; g < number_of_groups; ++g)
-                {
-                    int k_sigma = d + number_of_dimensional_moments * (g + number_of_groups * (g + number_of_groups * l));
+                int k_sigma = d + number_of_dimensional_moments * (g + number_of_groups * (g + number_of_groups * l));
                 
-                    for (int n = 0; n < number_of_nodes; ++n)
-                    {
-                        double sum = 0;
-                    
-                        int k_phi = n + number_of_nodes * (g + number_of_groups * (m + number_of_moments * i));
-                        
-                        x[k_phi] = sigma_s[k_sigma] * x[k_phi];
-                    }
-                }
-            }
-            break;
-        } // SCATTERING_MOMENTS
-        case Cross_Section::Dependencies::Angular::MOMENTS:
-        {
-            // Perform scattering
-            for (int m = 0; m < number_of_moments; ++m)
-            {
-                for (int g = 0; g < number_of_groups; ++g)
+                for (int n = 0; n < number_of_nodes; ++n)
                 {
-                    int k_sigma = d + number_of_dimensional_moments * (g + number_of_groups * (g + number_of_groups * m));
-                        
-                    for (int n = 0; n < number_of_nodes; ++n)
-                    {
-                        double sum = 0;
-                            
-                        int k_phi = n + number_of_nodes * (g + number_of_groups * (m + number_of_moments * i));
-                            
-                        x[k_phi] = sigma_s[k_sigma] * x[k_phi];
-                    }
+                    int k_phi = n + number_of_nodes * (g + number_of_groups * (m + number_of_moments * i));
+                    
+                    x[k_phi] = sigma_s[k_sigma] * x[k_phi];
                 }
             }
-            break;
-        } // MOMENTS
-        default:
-            Assert(false);
-            break;
         }
     }
 }
-
@@ -6,6 +6,8 @@
 
 #include "Scattering_Operator.hh"
 
+class Cross_Section_Table;
+
 /*
   Applies scattering to a moment representation of the flux
 */
@@ -28,11 +30,21 @@ public:
     
 private: 
 
+    // Scattering cross section of each point
+    std::shared_ptr<Cross_Section_Table> sigma_s_;
+    
     // Apply within-group and out-of-group scattering
     virtual void apply_full(std::vector<double> &x) const override;
     
     // Apply only within-group scattering
     virtual void apply_coherent(std::vector<double> &x) const override;
+
+    // Apply within-group and out-of-group scattering out of place
+    virtual void apply_buffered(std::vector<double> const &x,
+                                std::vector<double> &y,
+                                Vector_Workspace &workspace) const override;
+    void scatter_full(std::vector<double> const &x,
+                      std::vector<double> &y) const;
 };
 
 #endif
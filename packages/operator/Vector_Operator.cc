@@ -1,9 +1,84 @@
 #include "Vector_Operator.hh"
 
+#include <chrono>
+
+#include "Vector_Workspace.hh"
+#include "XML_Node.hh"
+
+using std::shared_ptr;
 using std::vector;
+using std::chrono::duration;
+using std::chrono::steady_clock;
 
 Vector_Operator::
 Vector_Operator():
-    number_of_evaluations_(0)
+    number_of_evaluations_(0),
+    profiling_(false)
+{
+}
+
+void Vector_Operator::
+enable_profiling()
+{
+    profiling_ = true;
+    
+    for (shared_ptr<Vector_Operator> child : children())
+    {
+        child->enable_profiling();
+    }
+}
+
+void Vector_Operator::
+profiled_apply(vector<double> &x)
+{
+    steady_clock::time_point start = steady_clock::now();
+    apply(x);
+    steady_clock::time_point end = steady_clock::now();
+    
+    add_to_profile(duration<double>(end - start).count());
+}
+
+void Vector_Operator::
+profiled_apply_buffered(vector<double> const &x,
+                        vector<double> &y,
+                        Vector_Workspace &workspace)
+{
+    steady_clock::time_point start = steady_clock::now();
+    apply_buffered(x, y, workspace);
+    steady_clock::time_point end = steady_clock::now();
+    
+    add_to_profile(duration<double>(end - start).count());
+}
+
+void Vector_Operator::
+add_to_profile(double time)
+{
+    // Only the input and output vectors are counted, as the data touched
+    // inside the operator depends on the implementation
+    profile_.number_of_calls += 1;
+    profile_.time += time;
+    profile_.bytes += static_cast<double>(row_size() + column_size()) * sizeof(double);
+}
+
+void Vector_Operator::
+output_profile(XML_Node output_node) const
+{
+    output_node.set_attribute(description(), "description");
+    output_node.set_attribute(profile_.number_of_calls, "calls");
+    output_node.set_attribute(profile_.time, "time");
+    output_node.set_attribute(profile_.bytes, "bytes");
+    
+    for (shared_ptr<Vector_Operator> child : children())
+    {
+        child->output_profile(output_node.append_child("operator"));
+    }
+}
+
+void Vector_Operator::
+apply_buffered(vector<double> const &x,
+               vector<double> &y,
+               Vector_Workspace &workspace) const
 {
+    y.assign(x.begin(), x.end());
+    apply(y);
 }
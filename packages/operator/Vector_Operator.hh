@@ -1,11 +1,15 @@
 #ifndef Vector_Operator_hh
 #define Vector_Operator_hh
 
+#include <memory>
 #include <string>
 #include <vector>
 
 #include "Check.hh"
 
+class Vector_Workspace;
+class XML_Node;
+
 /*
   Pure virtual class to represent a vector operator
 */
@@ -13,6 +17,14 @@ class Vector_Operator
 {
 public:
 
+    // Cumulative data for the applications of the operator
+    struct Profile
+    {
+        int number_of_calls = 0;
+        double time = 0; // wall time in seconds, including children
+        double bytes = 0; // input plus output vector sizes
+    };
+    
     // Constructor
     Vector_Operator();
     
@@ -21,13 +33,44 @@ public:
     {
         Check(x.size() == column_size());
         
-        apply(x);
+        if (profiling_)
+        {
+            profiled_apply(x);
+        }
+        else
+        {
+            apply(x);
+        }
         number_of_evaluations_ += 1;
         
         Check(x.size() == row_size());
         
         return x;
     }
+
+    // Apply the operator to x and store the result in y, which must be a
+    // different vector; temporary vectors are taken from the workspace
+    std::vector<double> &operator()(std::vector<double> const &x,
+                                    std::vector<double> &y,
+                                    Vector_Workspace &workspace)
+    {
+        Check(x.size() == column_size());
+        Check(&x != &y);
+        
+        if (profiling_)
+        {
+            profiled_apply_buffered(x, y, workspace);
+        }
+        else
+        {
+            apply_buffered(x, y, workspace);
+        }
+        number_of_evaluations_ += 1;
+        
+        Check(y.size() == row_size());
+        
+        return y;
+    }
     
     // Output size
     virtual int row_size() const = 0;
@@ -47,12 +90,45 @@ public:
     {
         return number_of_evaluations_;
     }
+
+    // Operators applied by this operator
+    virtual std::vector<std::shared_ptr<Vector_Operator> > children() const
+    {
+        return std::vector<std::shared_ptr<Vector_Operator> >();
+    }
+
+    // Record a profile for this operator and its children
+    void enable_profiling();
+    Profile const &profile() const
+    {
+        return profile_;
+    }
+
+    // Output the profiles of this operator and its children as a tree
+    void output_profile(XML_Node output_node) const;
+    
+protected:
+
+    // Apply the operator out of place: by default, copies x into y and
+    // applies the operator in place
+    virtual void apply_buffered(std::vector<double> const &x,
+                                std::vector<double> &y,
+                                Vector_Workspace &workspace) const;
     
 private:
     
     virtual void apply(std::vector<double> &x) const = 0;
+
+    // Apply the operator and add the time and sizes to the profile
+    void profiled_apply(std::vector<double> &x);
+    void profiled_apply_buffered(std::vector<double> const &x,
+                                 std::vector<double> &y,
+                                 Vector_Workspace &workspace);
+    void add_to_profile(double time);
     
     int number_of_evaluations_;
+    bool profiling_;
+    Profile profile_;
 };
 
 #endif
@@ -1,5 +1,7 @@
 #include "Vector_Operator_Product.hh"
 
+#include "Vector_Workspace.hh"
+
 using std::shared_ptr;
 using std::string;
 using std::vector;
@@ -21,6 +23,19 @@ apply(vector<double> &x) const
     (*op1_)(x);
 }
 
+void Vector_Operator_Product::
+apply_buffered(vector<double> const &x,
+               vector<double> &y,
+               Vector_Workspace &workspace) const
+{
+    vector<double> &z = workspace.acquire(op2_->row_size());
+    
+    (*op2_)(x, z, workspace);
+    (*op1_)(z, y, workspace);
+    
+    workspace.release();
+}
+
 void Vector_Operator_Product::
 check_class_invariants() const
 {
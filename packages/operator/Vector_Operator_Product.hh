@@ -28,10 +28,18 @@ public:
         return op2_->column_size();
     }
     virtual std::string description() const override;
+
+    virtual std::vector<std::shared_ptr<Vector_Operator> > children() const override
+    {
+        return {op1_, op2_};
+    }
     
 private:
 
     virtual void apply(std::vector<double> &x) const override;
+    virtual void apply_buffered(std::vector<double> const &x,
+                                std::vector<double> &y,
+                                Vector_Workspace &workspace) const override;
 
     std::shared_ptr<Vector_Operator> op1_;
     std::shared_ptr<Vector_Operator> op2_;
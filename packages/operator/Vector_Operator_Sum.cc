@@ -1,5 +1,7 @@
 #include "Vector_Operator_Sum.hh"
 
+#include "Vector_Workspace.hh"
+
 using std::shared_ptr;
 using std::string;
 using std::vector;
@@ -28,6 +30,24 @@ apply(vector<double> &x) const
     }
 }
 
+void Vector_Operator_Sum::
+apply_buffered(vector<double> const &x,
+               vector<double> &y,
+               Vector_Workspace &workspace) const
+{
+    vector<double> &z = workspace.acquire(op2_->row_size());
+    
+    (*op1_)(x, y, workspace);
+    (*op2_)(x, z, workspace);
+    
+    for (int i = 0; i < row_size(); ++i)
+    {
+        y[i] += z[i];
+    }
+    
+    workspace.release();
+}
+
 void Vector_Operator_Sum::
 check_class_invariants() const
 {
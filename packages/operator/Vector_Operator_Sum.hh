@@ -29,11 +29,19 @@ public:
     virtual void check_class_invariants() const override;
 
     virtual std::string description() const override;
+
+    virtual std::vector<std::shared_ptr<Vector_Operator> > children() const override
+    {
+        return {op1_, op2_};
+    }
     
     
 private:
 
     virtual void apply(std::vector<double> &x) const override;
+    virtual void apply_buffered(std::vector<double> const &x,
+                                std::vector<double> &y,
+                                Vector_Workspace &workspace) const override;
     
     std::shared_ptr<Vector_Operator> op1_;
     std::shared_ptr<Vector_Operator> op2_;
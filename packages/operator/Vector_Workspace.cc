@@ -0,0 +1,34 @@
+#include "Vector_Workspace.hh"
+
+#include "Check.hh"
+
+using std::vector;
+
+Vector_Workspace::
+Vector_Workspace():
+    depth_(0)
+{
+}
+
+vector<double> &Vector_Workspace::
+acquire(int size)
+{
+    if (depth_ == vectors_.size())
+    {
+        vectors_.emplace_back();
+    }
+    
+    vector<double> &x = vectors_[depth_];
+    x.resize(size);
+    depth_ += 1;
+    
+    return x;
+}
+
+void Vector_Workspace::
+release()
+{
+    Check(depth_ > 0);
+    
+    depth_ -= 1;
+}
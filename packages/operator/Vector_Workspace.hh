@@ -0,0 +1,40 @@
+#ifndef Vector_Workspace_hh
+#define Vector_Workspace_hh
+
+#include <deque>
+#include <vector>
+
+/*
+  Pool of temporary vectors for out-of-place operator application
+
+  Vectors are taken and returned in stack order, so nested operators reuse
+  the same storage on each application instead of allocating new vectors.
+*/
+class Vector_Workspace
+{
+public:
+
+    // Constructor
+    Vector_Workspace();
+    
+    // Take a vector of the given size with unspecified contents
+    std::vector<double> &acquire(int size);
+
+    // Return the most recently taken vector to the pool
+    void release();
+
+    // Number of vectors currently taken
+    int depth() const
+    {
+        return depth_;
+    }
+    
+private:
+
+    int depth_;
+    
+    // Deque so that references stay valid as the pool grows
+    std::deque<std::vector<double> > vectors_;
+};
+
+#endif
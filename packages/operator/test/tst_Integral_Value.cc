@@ -0,0 +1,282 @@
+#include <iostream>
+#include <vector>
+
+#include "Boundary_Source.hh"
+#include "Cartesian_Plane.hh"
+#include "Check_Equality.hh"
+#include "Constructive_Solid_Geometry.hh"
+#include "Energy_Discretization.hh"
+#include "Integral_Value_Operator.hh"
+#include "Integration_Mesh.hh"
+#include "LDFE_Quadrature.hh"
+#include "Material.hh"
+#include "Material_Factory.hh"
+#include "Random_Number_Generator.hh"
+#include "Region.hh"
+#include "Vector_Workspace.hh"
+#include "Weak_Spatial_Discretization.hh"
+#include "Weak_Spatial_Discretization_Factory.hh"
+
+using namespace std;
+namespace ce = Check_Equality;
+
+// Compare the cell averages from the stored Integral_Value_Operator matrix
+// to a direct quadrature of the flux over each cell
+
+Random_Number_Generator<double> rng(0, // lower bound
+                                    1, // upper bound
+                                    511); // seed
+
+// Get a square with a single material and reflective boundaries
+void
+get_discretizations(int num_dimensional_points,
+                    shared_ptr<Angular_Discretization> &angular,
+                    shared_ptr<Energy_Discretization> &energy,
+                    shared_ptr<Weak_Spatial_Discretization> &spatial)
+{
+    // Initialize angular and energy discretizations
+    int dimension = 2;
+    int number_of_scattering_moments = 2;
+    angular = make_shared<LDFE_Quadrature>(dimension,
+                                           number_of_scattering_moments,
+                                           1); // rule
+    int number_of_groups = 2;
+    energy = make_shared<Energy_Discretization>(number_of_groups);
+
+    // Initialize material
+    Material_Factory material_factory(angular,
+                                      energy);
+    vector<shared_ptr<Material> > materials
+        = {material_factory.get_standard_material(0, // index
+                                                  {1.0, 2.0}, // sigma_t
+                                                  {0.5, 0.1, 0.0, 1.5, // sigma_s
+                                                   0.05, 0.01, 0.0, 0.15},
+                                                  {0.0, 0.0}, // nu
+                                                  {0.0, 0.0}, // sigma_f
+                                                  {0.0, 0.0}, // chi
+                                                  {0.0, 0.0})}; // internal source
+
+    // Initialize boundary source
+    Boundary_Source::Dependencies dependencies;
+    vector<shared_ptr<Boundary_Source> > boundary_sources
+        = {make_shared<Boundary_Source>(0, // index
+                                        dependencies,
+                                        angular,
+                                        energy,
+                                        vector<double>({0.0, 0.0}), // source
+                                        vector<double>({1.0, 1.0}))}; // alpha
+
+    // Initialize boundary planes
+    int number_of_surfaces = 4;
+    vector<shared_ptr<Surface> > surfaces(number_of_surfaces);
+    vector<shared_ptr<Cartesian_Plane> > boundary_surfaces(number_of_surfaces);
+    vector<int> surface_dimensions = {0, 0, 1, 1};
+    vector<double> surface_positions = {-1.0, 1.0, -1.0, 1.0};
+    vector<double> surface_normals = {-1.0, 1.0, -1.0, 1.0};
+    for (int i = 0; i < number_of_surfaces; ++i)
+    {
+        boundary_surfaces[i]
+            = make_shared<Cartesian_Plane>(i, // index
+                                           dimension,
+                                           Surface::Surface_Type::BOUNDARY,
+                                           surface_dimensions[i],
+                                           surface_positions[i],
+                                           surface_normals[i]);
+        surfaces[i] = boundary_surfaces[i];
+        surfaces[i]->set_boundary_source(boundary_sources[0]);
+    }
+
+    // Initialize region and solid geometry
+    vector<Surface::Relation> surface_relations(number_of_surfaces,
+                                                Surface::Relation::NEGATIVE);
+    vector<shared_ptr<Region> > regions
+        = {make_shared<Region>(0, // index
+                               materials[0],
+                               surface_relations,
+                               surfaces)};
+    shared_ptr<Constructive_Solid_Geometry> solid
+        = make_shared<Constructive_Solid_Geometry>(dimension,
+                                                   surfaces,
+                                                   regions,
+                                                   materials,
+                                                   boundary_sources);
+
+    // Initialize spatial discretization
+    shared_ptr<Weight_Function_Options> weight_options
+        = make_shared<Weight_Function_Options>();
+    shared_ptr<Weak_Spatial_Discretization_Options> weak_options
+        = make_shared<Weak_Spatial_Discretization_Options>();
+    weak_options->integration_ordinates = 8;
+    weak_options->limits = {{-1.0, 1.0}, {-1.0, 1.0}};
+    weak_options->solid = solid;
+    weak_options->dimensional_cells = {num_dimensional_points - 1, num_dimensional_points - 1};
+    weak_options->identical_basis_functions = Weak_Spatial_Discretization_Options::Identical_Basis_Functions::TRUE;
+    weak_options->weighting = Weak_Spatial_Discretization_Options::Weighting::FLAT;
+    Weak_Spatial_Discretization_Factory spatial_factory(solid,
+                                                        boundary_surfaces);
+    spatial
+        = spatial_factory.get_simple_discretization(num_dimensional_points,
+                                                    3, // radius num intervals
+                                                    true, // basis mls
+                                                    true, // weight mls
+                                                    "wendland11", // basis type
+                                                    "wendland11", // weight type
+                                                    weight_options,
+                                                    weak_options);
+}
+
+// Integrate the flux over each cell with the mesh quadrature and divide by
+// the cell volume
+void
+get_direct_values(shared_ptr<Integration_Mesh_Options> options,
+                  shared_ptr<Weak_Spatial_Discretization> spatial,
+                  shared_ptr<Angular_Discretization> angular,
+                  shared_ptr<Energy_Discretization> energy,
+                  vector<double> const &coefficients,
+                  vector<double> &result)
+{
+    int number_of_groups = energy->number_of_groups();
+    int number_of_moments = angular->number_of_moments();
+    Integration_Mesh mesh(spatial->dimension(),
+                          spatial->number_of_points(),
+                          options,
+                          spatial->bases(),
+                          spatial->weights());
+    int number_of_cells = mesh.number_of_cells();
+
+    result.assign(number_of_cells * number_of_moments * number_of_groups, 0.);
+    for (int i = 0; i < number_of_cells; ++i)
+    {
+        Integration_Cell const &cell = mesh.cell(i);
+        int number_of_ordinates;
+        vector<vector<double> > ordinates;
+        vector<double> weights;
+        mesh.get_volume_quadrature(i,
+                                   number_of_ordinates,
+                                   ordinates,
+                                   weights);
+        vector<vector<double> > basis_centers;
+        mesh.get_basis_centers(cell,
+                               basis_centers);
+
+        double volume = 0;
+        vector<double> b_val;
+        for (int q = 0; q < number_of_ordinates; ++q)
+        {
+            volume += weights[q];
+            mesh.get_basis_values(cell,
+                                  ordinates[q],
+                                  basis_centers,
+                                  b_val);
+
+            for (int j = 0; j < cell.number_of_basis_functions; ++j)
+            {
+                int b = cell.basis_indices[j];
+
+                for (int m = 0; m < number_of_moments; ++m)
+                {
+                    for (int g = 0; g < number_of_groups; ++g)
+                    {
+                        int k_res = g + number_of_groups * (m + number_of_moments * i);
+                        int k_coeff = g + number_of_groups * (m + number_of_moments * b);
+
+                        result[k_res] += b_val[j] * coefficients[k_coeff] * weights[q];
+                    }
+                }
+            }
+        }
+
+        for (int m = 0; m < number_of_moments; ++m)
+        {
+            for (int g = 0; g < number_of_groups; ++g)
+            {
+                int k_res = g + number_of_groups * (m + number_of_moments * i);
+                result[k_res] /= volume;
+            }
+        }
+    }
+}
+
+int
+test_integral_values(int num_dimensional_points,
+                     int num_value_cells)
+{
+    int checksum = 0;
+    cout << "test_integral_values running for ";
+    cout << num_dimensional_points;
+    cout << " dimensional points and ";
+    cout << num_value_cells;
+    cout << " value cells";
+    cout << endl;
+
+    // Get discretizations and operator
+    shared_ptr<Angular_Discretization> angular;
+    shared_ptr<Energy_Discretization> energy;
+    shared_ptr<Weak_Spatial_Discretization> spatial;
+    get_discretizations(num_dimensional_points,
+                        angular,
+                        energy,
+                        spatial);
+    shared_ptr<Integration_Mesh_Options> options
+        = make_shared<Integration_Mesh_Options>();
+    options->identical_basis_functions = true;
+    options->integration_ordinates = 8;
+    options->limits = {{-1.0, 1.0}, {-1.0, 1.0}};
+    options->dimensional_cells = {num_value_cells, num_value_cells};
+    shared_ptr<Integral_Value_Operator> oper
+        = make_shared<Integral_Value_Operator>(options,
+                                               spatial,
+                                               angular,
+                                               energy);
+
+    // Get random coefficients
+    vector<double> coefficients(oper->column_size());
+    for (double &c : coefficients)
+    {
+        c = rng.scalar();
+    }
+
+    // Apply in place, out of place, and directly
+    vector<double> result = coefficients;
+    (*oper)(result);
+    Vector_Workspace workspace;
+    vector<double> buffered_result(oper->row_size());
+    (*oper)(coefficients,
+            buffered_result,
+            workspace);
+    vector<double> direct_result;
+    get_direct_values(options,
+                      spatial,
+                      angular,
+                      energy,
+                      coefficients,
+                      direct_result);
+
+    double tolerance = 1e-12;
+    if (!ce::approx(direct_result, result, tolerance))
+    {
+        cout << "integral values differ from direct quadrature" << endl;
+        checksum += 1;
+    }
+    if (!ce::equal(result, buffered_result))
+    {
+        cout << "buffered integral values differ" << endl;
+        checksum += 1;
+    }
+    if (checksum == 0)
+    {
+        cout << "test_passed" << endl;
+    }
+
+    return checksum;
+}
+
+int main()
+{
+    int checksum = 0;
+
+    checksum += test_integral_values(5, 4);
+    checksum += test_integral_values(5, 7);
+
+    return checksum;
+}
@@ -9,7 +9,9 @@
 #include "Combined_SUPG_Fission.hh"
 #include "Combined_SUPG_Scattering.hh"
 #include "Constructive_Solid_Geometry.hh"
+#include "Cross_Section.hh"
 #include "Cylinder_2D.hh"
+#include "Dimensional_Moments.hh"
 #include "Discrete_Normalization_Operator.hh"
 #include "Energy_Discretization.hh"
 #include "Fission.hh"
@@ -762,12 +764,153 @@ check_supg_operators(int num_dimensional_points)
     return checksum;
 }
 
+// Apply SUPG scattering and fission by indexing the material data of each
+// point directly, as a reference for the cross section table operators
+void
+apply_supg_reference(shared_ptr<Angular_Discretization> angular,
+                     shared_ptr<Energy_Discretization> energy,
+                     shared_ptr<Weak_Spatial_Discretization> spatial,
+                     vector<double> const &x,
+                     vector<double> &y)
+{
+    int number_of_points = spatial->number_of_points();
+    int number_of_nodes = spatial->number_of_nodes();
+    int number_of_groups = energy->number_of_groups();
+    int number_of_moments = angular->number_of_moments();
+    vector<int> const scattering_indices = angular->scattering_indices();
+    shared_ptr<Dimensional_Moments> dimensional_moments = spatial->dimensional_moments();
+    int number_of_dimensional_moments = dimensional_moments->number_of_dimensional_moments();
+    int number_of_double_dimensional_moments = dimensional_moments->number_of_double_dimensional_moments();
+    vector<int> const dimensional_indices = dimensional_moments->dimensional_indices();
+    
+    y.assign(number_of_points * number_of_nodes * number_of_groups * number_of_moments * number_of_double_dimensional_moments, 0);
+    for (int i = 0; i < number_of_points; ++i)
+    {
+        shared_ptr<Material> material = spatial->point(i)->material();
+        shared_ptr<Cross_Section> sigma_s_cs = material->sigma_s();
+        shared_ptr<Cross_Section> sigma_f_cs = material->sigma_f();
+        Assert(sigma_f_cs->dependencies().energy == Cross_Section::Dependencies::Energy::GROUP_TO_GROUP);
+        vector<double> const sigma_s = sigma_s_cs->data();
+        vector<double> const sigma_f = sigma_f_cs->data();
+        bool scattering_moments = (sigma_s_cs->dependencies().angular
+                                   == Cross_Section::Dependencies::Angular::SCATTERING_MOMENTS);
+        
+        for (int m = 0; m < number_of_moments; ++m)
+        {
+            int l = scattering_moments ? scattering_indices[m] : m;
+            
+            for (int d1 = 0; d1 < number_of_dimensional_moments; ++d1)
+            {
+                for (int d2 = 0; d2 < number_of_dimensional_moments; ++d2)
+                {
+                    int d = dimensional_indices[d1 + number_of_dimensional_moments * d2];
+                    
+                    for (int gt = 0; gt < number_of_groups; ++gt)
+                    {
+                        for (int n = 0; n < number_of_nodes; ++n)
+                        {
+                            double sum = 0;
+                            
+                            for (int gf = 0; gf < number_of_groups; ++gf)
+                            {
+                                int k_phi_from = n + number_of_nodes * (d1 + number_of_dimensional_moments * (gf + number_of_groups * (m + number_of_moments * i)));
+                                int k_sigma_s = d2 + number_of_dimensional_moments * (gf + number_of_groups * (gt + number_of_groups * l));
+                                
+                                sum += sigma_s[k_sigma_s] * x[k_phi_from];
+                                
+                                if (m == 0)
+                                {
+                                    int k_sigma_f = d2 + number_of_dimensional_moments * (gf + number_of_groups * gt);
+                                    
+                                    sum += sigma_f[k_sigma_f] * x[k_phi_from];
+                                }
+                            }
+                            
+                            int k_phi_to = n + number_of_nodes * (d + number_of_double_dimensional_moments * (gt + number_of_groups * (m + number_of_moments * i)));
+                            
+                            y[k_phi_to] += sum;
+                        }
+                    }
+                }
+            }
+        }
+    }
+}
+
+// Check SUPG_Scattering and SUPG_Fission against the reference
+int
+check_supg_tables(int num_dimensional_points)
+{
+    int checksum = 0;
+    double tau = 0.9;
+    cout << "check_supg_tables running for ";
+    cout << num_dimensional_points;
+    cout << " dimensional points";
+    cout << endl;
+    
+    shared_ptr<Angular_Discretization> angular;
+    shared_ptr<Energy_Discretization> energy;
+    shared_ptr<Constructive_Solid_Geometry> solid;
+    shared_ptr<Weak_Spatial_Discretization> spatial;
+    get_discretizations(true, // supg
+                        false, // use_flux
+                        false, // equivalent_materials
+                        num_dimensional_points,
+                        tau,
+                        angular,
+                        energy,
+                        solid,
+                        spatial);
+    Assert(spatial->dimensional_moments()->number_of_dimensional_moments() > 1);
+    
+    shared_ptr<Vector_Operator> S
+        = make_shared<SUPG_Scattering>(spatial,
+                                       angular,
+                                       energy);
+    shared_ptr<Vector_Operator> F
+        = make_shared<SUPG_Fission>(spatial,
+                                    angular,
+                                    energy);
+    shared_ptr<Vector_Operator> oper = S + F;
+    
+    // Get random input, including the dimensional moments
+    vector<double> coefficients(oper->column_size());
+    for (double &c : coefficients)
+    {
+        c = 2 * rng.scalar() - 1;
+    }
+    
+    // Apply the operators and the reference
+    vector<double> result = coefficients;
+    (*oper)(result);
+    vector<double> reference;
+    apply_supg_reference(angular,
+                         energy,
+                         spatial,
+                         coefficients,
+                         reference);
+    
+    double tolerance = 1e-12;
+    if (ce::approx(reference, result, tolerance))
+    {
+        cout << "test_passed" << endl;
+    }
+    else
+    {
+        cout << "supg table results differ from reference" << endl;
+        checksum += 1;
+    }
+    
+    return checksum;
+}
+
 int main()
 {
     int checksum = 0;
 
     checksum += check_all_operators(9);
     checksum += check_supg_operators(9);
+    checksum += check_supg_tables(5);
     
     return checksum;
 }
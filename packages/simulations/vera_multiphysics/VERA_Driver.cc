@@ -50,7 +50,8 @@ run_transport(bool include_crack,
               double pincell_power,
               XML_Node input_node,
               shared_ptr<VERA_Temperature> temperature,
-              int num_threads)
+              int num_threads,
+              shared_ptr<Weak_Spatial_Discretization> &spatial)
 {
     // Get energy discretization
     Energy_Discretization_Parser energy_parser;
@@ -90,15 +91,23 @@ run_transport(bool include_crack,
     vector<shared_ptr<Cartesian_Plane> > boundary_surfaces
         = solid->cartesian_boundary_surfaces();
     
-    // Get spatial discretization
-    Weak_Spatial_Discretization_Parser spatial_parser(solid,
-                                                      boundary_surfaces);
-    // omp_set_num_threads(num_threads);
-    shared_ptr<Weak_Spatial_Discretization> spatial
-        = spatial_parser.get_weak_discretization(input_node.get_child("spatial_discretization"));
-    // omp_set_num_threads(1);
+    // Get spatial discretization, or only integrate the cross sections for
+    // the new temperature if the geometric integrals are already known
+    if (spatial && spatial->options()->external_integral_calculation)
+    {
+        spatial->update_materials(solid);
+    }
+    else
+    {
+        Weak_Spatial_Discretization_Parser spatial_parser(solid,
+                                                          boundary_surfaces);
+        // omp_set_num_threads(num_threads);
+        spatial = spatial_parser.get_weak_discretization(input_node.get_child("spatial_discretization"));
+        // omp_set_num_threads(1);
+    }
     
-    // Get transport discretization
+    // Get transport discretization, which with the sweep and solver below
+    // copies the cross sections and is created again for each temperature
     shared_ptr<Transport_Discretization> transport
         = make_shared<Transport_Discretization>(spatial,
                                                 angular,
@@ -329,6 +338,9 @@ void run_test(XML_Node input_node,
     // Get result pointer
     shared_ptr<VERA_Transport_Result> result;
 
+    // The spatial discretization is kept between iterations
+    shared_ptr<Weak_Spatial_Discretization> spatial;
+
     // Get total desired power
     bool include_crack
         = input_node.get_child("heat").get_attribute<bool>("include_crack");
@@ -351,7 +363,8 @@ void run_test(XML_Node input_node,
                             pincell_power,
                             input_node.get_child("transport"),
                             temperature,
-                            num_threads);
+                            num_threads,
+                            spatial);
         eigenvalue_history.push_back(result->result()->k_eigenvalue);
         cout << "end transport calculation " << i << endl;
         
@@ -238,6 +238,14 @@ output(XML_Node output_node) const
                   result_);
 }
 
+vector<shared_ptr<Vector_Operator> > Krylov_Eigenvalue::
+operators() const
+{
+    vector<shared_ptr<Vector_Operator> > opers = {fission_operator_, flux_operator_};
+    opers.insert(opers.end(), value_operators_.begin(), value_operators_.end());
+    return opers;
+}
+
 void Krylov_Eigenvalue::
 check_class_invariants() const
 {
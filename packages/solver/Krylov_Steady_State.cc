@@ -144,6 +144,14 @@ output(XML_Node output_node) const
                   result_);
 }
 
+vector<shared_ptr<Vector_Operator> > Krylov_Steady_State::
+operators() const
+{
+    vector<shared_ptr<Vector_Operator> > opers = {source_operator_, flux_operator_};
+    opers.insert(opers.end(), value_operators_.begin(), value_operators_.end());
+    return opers;
+}
+
 void Krylov_Steady_State::
 check_class_invariants() const
 {
@@ -42,6 +42,7 @@ public:
     {
         return result_;
     }
+    virtual std::vector<std::shared_ptr<Vector_Operator> > operators() const override;
     
 protected:
     
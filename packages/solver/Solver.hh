@@ -5,6 +5,7 @@
 #include <string>
 #include <vector>
 
+class Vector_Operator;
 class XML_Node;
 
 /*
@@ -53,6 +54,12 @@ public:
     virtual void check_class_invariants() const = 0;
 
     virtual std::shared_ptr<Result> result() const = 0;
+
+    // Operators applied by the solver
+    virtual std::vector<std::shared_ptr<Vector_Operator> > operators() const
+    {
+        return std::vector<std::shared_ptr<Vector_Operator> >();
+    }
     
 protected:
     
@@ -5,6 +5,7 @@
 #include "Basis_Fission.hh"
 #include "Basis_Scattering.hh"
 #include "Boundary_Source_Toggle.hh"
+#include "Check.hh"
 #include "Combined_SUPG_Fission.hh"
 #include "Combined_SUPG_Scattering.hh"
 #include "Dimensional_Moments.hh"
@@ -201,10 +202,22 @@ get_standard_source_operators(shared_ptr<Sweep_Operator> Linv,
                                               Linv);
     
     // Get combined operators
-    source_operator
-        = D * LinvB * M * Q;
-    flux_operator
-        = D * LinvI * M * (S + F) * Wm;
+    switch (Linv->sweep_type())
+    {
+    case Sweep_Operator::Sweep_Type::ORDINATE:
+        source_operator
+            = D * LinvB * M * Q;
+        flux_operator
+            = D * LinvI * M * (S + F) * Wm;
+        break;
+    case Sweep_Operator::Sweep_Type::MOMENT:
+        // Sweep converts to and from moments for each ordinate
+        source_operator
+            = LinvB * Q;
+        flux_operator
+            = LinvI * (S + F) * Wm;
+        break;
+    }
 }
 
 void Solver_Factory::
@@ -212,6 +225,9 @@ get_supg_source_operators(shared_ptr<Sweep_Operator> Linv,
                           shared_ptr<Vector_Operator> &source_operator,
                           shared_ptr<Vector_Operator> &flux_operator) const
 {
+    // Moment sweeps only include the standard moment-to-discrete operator
+    AssertMsg(Linv->sweep_type() == Sweep_Operator::Sweep_Type::ORDINATE, "moment sweep not compatible with SUPG");
+    
     // Check that this problem is SUPG
     bool include_supg = spatial_->options()->include_supg;
     Assert(include_supg);
@@ -318,6 +334,9 @@ get_supg_combined_source_operators(shared_ptr<Sweep_Operator> Linv,
                                    shared_ptr<Vector_Operator> &source_operator,
                                    shared_ptr<Vector_Operator> &flux_operator) const
 {
+    // Moment sweeps only include the standard moment-to-discrete operator
+    AssertMsg(Linv->sweep_type() == Sweep_Operator::Sweep_Type::ORDINATE, "moment sweep not compatible with SUPG");
+    
     // Check that this problem is SUPG
     bool include_supg = spatial_->options()->include_supg;
     Assert(include_supg);
@@ -488,10 +507,22 @@ get_full_source_operators(shared_ptr<Sweep_Operator> Linv,
                                               Linv);
     
     // Get combined operators
-    source_operator
-        = D * LinvB * M * Q;
-    flux_operator
-        = D * LinvI * M * (S + F);
+    switch (Linv->sweep_type())
+    {
+    case Sweep_Operator::Sweep_Type::ORDINATE:
+        source_operator
+            = D * LinvB * M * Q;
+        flux_operator
+            = D * LinvI * M * (S + F);
+        break;
+    case Sweep_Operator::Sweep_Type::MOMENT:
+        // Sweep converts to and from moments for each ordinate
+        source_operator
+            = LinvB * Q;
+        flux_operator
+            = LinvI * (S + F);
+        break;
+    }
 }
 
 void Solver_Factory::
@@ -499,6 +530,9 @@ get_supg_full_source_operators(shared_ptr<Sweep_Operator> Linv,
                                shared_ptr<Vector_Operator> &source_operator,
                                shared_ptr<Vector_Operator> &flux_operator) const
 {
+    // Moment sweeps only include the standard moment-to-discrete operator
+    AssertMsg(Linv->sweep_type() == Sweep_Operator::Sweep_Type::ORDINATE, "moment sweep not compatible with SUPG");
+    
     // Check that this problem is SUPG
     bool include_supg = spatial_->options()->include_supg;
     Assert(include_supg);
@@ -730,10 +764,22 @@ get_standard_eigenvalue_operators(shared_ptr<Sweep_Operator> Linv,
                                               Linv);
     
     // Get combined operators
-    fission_operator
-        = D * LinvI * M * F * W;
-    flux_operator
-        = D * LinvI * M * S * W;
+    switch (Linv->sweep_type())
+    {
+    case Sweep_Operator::Sweep_Type::ORDINATE:
+        fission_operator
+            = D * LinvI * M * F * W;
+        flux_operator
+            = D * LinvI * M * S * W;
+        break;
+    case Sweep_Operator::Sweep_Type::MOMENT:
+        // Sweep converts to and from moments for each ordinate
+        fission_operator
+            = LinvI * F * W;
+        flux_operator
+            = LinvI * S * W;
+        break;
+    }
 }
 
 void Solver_Factory::
@@ -741,6 +787,9 @@ get_supg_eigenvalue_operators(shared_ptr<Sweep_Operator> Linv,
                               shared_ptr<Vector_Operator> &fission_operator,
                               shared_ptr<Vector_Operator> &flux_operator) const
 {
+    // Moment sweeps only include the standard moment-to-discrete operator
+    AssertMsg(Linv->sweep_type() == Sweep_Operator::Sweep_Type::ORDINATE, "moment sweep not compatible with SUPG");
+    
     // Check that this problem is SUPG
     bool include_supg = spatial_->options()->include_supg;
     Assert(include_supg);
@@ -827,6 +876,9 @@ get_supg_combined_eigenvalue_operators(shared_ptr<Sweep_Operator> Linv,
                                        shared_ptr<Vector_Operator> &fission_operator,
                                        shared_ptr<Vector_Operator> &flux_operator) const
 {
+    // Moment sweeps only include the standard moment-to-discrete operator
+    AssertMsg(Linv->sweep_type() == Sweep_Operator::Sweep_Type::ORDINATE, "moment sweep not compatible with SUPG");
+    
     // Check that this problem is SUPG
     bool include_supg = spatial_->options()->include_supg;
     Assert(include_supg);
@@ -965,10 +1017,22 @@ get_full_eigenvalue_operators(shared_ptr<Sweep_Operator> Linv,
                                               Linv);
     
     // Get combined operators
-    fission_operator
-        = D * LinvI * M * F;
-    flux_operator
-        = D * LinvI * M * S;
+    switch (Linv->sweep_type())
+    {
+    case Sweep_Operator::Sweep_Type::ORDINATE:
+        fission_operator
+            = D * LinvI * M * F;
+        flux_operator
+            = D * LinvI * M * S;
+        break;
+    case Sweep_Operator::Sweep_Type::MOMENT:
+        // Sweep converts to and from moments for each ordinate
+        fission_operator
+            = LinvI * F;
+        flux_operator
+            = LinvI * S;
+        break;
+    }
 }
 
 void Solver_Factory::
@@ -976,6 +1040,9 @@ get_supg_full_eigenvalue_operators(shared_ptr<Sweep_Operator> Linv,
                                    shared_ptr<Vector_Operator> &fission_operator,
                                    shared_ptr<Vector_Operator> &flux_operator) const
 {
+    // Moment sweeps only include the standard moment-to-discrete operator
+    AssertMsg(Linv->sweep_type() == Sweep_Operator::Sweep_Type::ORDINATE, "moment sweep not compatible with SUPG");
+    
     // Check that this problem is SUPG
     bool include_supg = spatial_->options()->include_supg;
     Assert(include_supg);
@@ -1236,10 +1303,22 @@ get_strong_source_operators(shared_ptr<Sweep_Operator> Linv,
                                               Linv);
     
     // Get combined operators
-    source_operator
-        = D * LinvB * M * Q;
-    flux_operator
-        = D * LinvI * M * (S + F) * Wm;
+    switch (Linv->sweep_type())
+    {
+    case Sweep_Operator::Sweep_Type::ORDINATE:
+        source_operator
+            = D * LinvB * M * Q;
+        flux_operator
+            = D * LinvI * M * (S + F) * Wm;
+        break;
+    case Sweep_Operator::Sweep_Type::MOMENT:
+        // Sweep converts to and from moments for each ordinate
+        source_operator
+            = LinvB * Q;
+        flux_operator
+            = LinvI * (S + F) * Wm;
+        break;
+    }
 }
 
 void Solver_Factory::
@@ -1309,10 +1388,22 @@ get_strong_basis_source_operators(shared_ptr<Sweep_Operator> Linv,
                                               Linv);
     
     // Get combined operators
-    source_operator
-        = D * LinvB * M * Q;
-    flux_operator
-        = D * LinvI * M * (S + F);
+    switch (Linv->sweep_type())
+    {
+    case Sweep_Operator::Sweep_Type::ORDINATE:
+        source_operator
+            = D * LinvB * M * Q;
+        flux_operator
+            = D * LinvI * M * (S + F);
+        break;
+    case Sweep_Operator::Sweep_Type::MOMENT:
+        // Sweep converts to and from moments for each ordinate
+        source_operator
+            = LinvB * Q;
+        flux_operator
+            = LinvI * (S + F);
+        break;
+    }
 }
 
 void Solver_Factory::
@@ -1381,10 +1472,22 @@ get_strong_eigenvalue_operators(shared_ptr<Sweep_Operator> Linv,
                                               Linv);
     
     // Get combined operators
-    fission_operator
-        = D * LinvI * M * F * W;
-    flux_operator
-        = D * LinvI * M * S * W;
+    switch (Linv->sweep_type())
+    {
+    case Sweep_Operator::Sweep_Type::ORDINATE:
+        fission_operator
+            = D * LinvI * M * F * W;
+        flux_operator
+            = D * LinvI * M * S * W;
+        break;
+    case Sweep_Operator::Sweep_Type::MOMENT:
+        // Sweep converts to and from moments for each ordinate
+        fission_operator
+            = LinvI * F * W;
+        flux_operator
+            = LinvI * S * W;
+        break;
+    }
 }
 
 void Solver_Factory::
@@ -1442,8 +1545,20 @@ get_strong_basis_eigenvalue_operators(shared_ptr<Sweep_Operator> Linv,
                                               Linv);
     
     // Get combined operators
-    fission_operator
-        = D * LinvI * M * F;
-    flux_operator
-        = D * LinvI * M * S;
+    switch (Linv->sweep_type())
+    {
+    case Sweep_Operator::Sweep_Type::ORDINATE:
+        fission_operator
+            = D * LinvI * M * F;
+        flux_operator
+            = D * LinvI * M * S;
+        break;
+    case Sweep_Operator::Sweep_Type::MOMENT:
+        // Sweep converts to and from moments for each ordinate
+        fission_operator
+            = LinvI * F;
+        flux_operator
+            = LinvI * S;
+        break;
+    }
 }
@@ -6,6 +6,7 @@
 #include "Spatial_Discretization.hh"
 #include "Transport_Discretization.hh"
 #include "Vector_Operator.hh"
+#include "Vector_Workspace.hh"
 #include "XML_Node.hh"
 
 using namespace std;
@@ -98,14 +99,15 @@ solve()
     double error = 1;
     {
         vector<double> x_old;
+        Vector_Workspace workspace;
         double error_old = 1;
         for (int it = 0; it < options_.max_iterations; ++it)
         {
             print_iteration(it);
 
-            // Perform sweep to get new phi
-            x_old = x;
-            (*flux_operator_)(x);
+            // Perform sweep to get new phi, reusing the old storage
+            x_old.swap(x);
+            (*flux_operator_)(x_old, x, workspace);
 
             // Add first-flight source to phi
             for (int i = 0; i < phi_size; ++i)
@@ -172,6 +174,14 @@ output(XML_Node output_node) const
                   result_);
 }
 
+vector<shared_ptr<Vector_Operator> > Source_Iteration::
+operators() const
+{
+    vector<shared_ptr<Vector_Operator> > opers = {source_operator_, flux_operator_};
+    opers.insert(opers.end(), value_operators_.begin(), value_operators_.end());
+    return opers;
+}
+
 void Source_Iteration::
 check_class_invariants() const
 {
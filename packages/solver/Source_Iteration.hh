@@ -37,6 +37,7 @@ public:
     {
         return result_;
     }
+    virtual std::vector<std::shared_ptr<Vector_Operator> > operators() const override;
     virtual void output(XML_Node output_node) const override;
     
     virtual void check_class_invariants() const override;
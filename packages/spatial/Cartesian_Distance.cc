@@ -146,6 +146,62 @@ laplacian_distance(vector<double> const &r,
     return (dimension_ - 1) / dist;
 }
 
+void Cartesian_Distance::
+batch_distance(int number_of_points,
+               double const *r,
+               vector<double> const &r0,
+               double *distances) const
+{
+    #pragma omp simd
+    for (int i = 0; i < number_of_points; ++i)
+    {
+        distances[i] = 0;
+    }
+    for (int d = 0; d < dimension_; ++d)
+    {
+        double const *r_d = r + number_of_points * d;
+        double const r0_d = r0[d];
+        #pragma omp simd
+        for (int i = 0; i < number_of_points; ++i)
+        {
+            double const k = r_d[i] - r0_d;
+            distances[i] += k * k;
+        }
+    }
+    #pragma omp simd
+    for (int i = 0; i < number_of_points; ++i)
+    {
+        distances[i] = sqrt(distances[i]);
+    }
+}
+
+void Cartesian_Distance::
+batch_gradient_distance(int number_of_points,
+                        double const *r,
+                        vector<double> const &r0,
+                        double *distances,
+                        double *gradients) const
+{
+    batch_distance(number_of_points,
+                   r,
+                   r0,
+                   distances);
+    
+    // Gradient is set to one at the center, as in gradient_distance
+    for (int d = 0; d < dimension_; ++d)
+    {
+        double const *r_d = r + number_of_points * d;
+        double *gradients_d = gradients + number_of_points * d;
+        double const r0_d = r0[d];
+        #pragma omp simd
+        for (int i = 0; i < number_of_points; ++i)
+        {
+            double const dist = distances[i];
+            gradients_d[i] = dist == 0. ? 1. : (r_d[i] - r0_d) / dist;
+        }
+    }
+}
+
 void Cartesian_Distance::
 check_class_invariants() const
 {
@@ -33,6 +33,16 @@ public:
     
     virtual double laplacian_distance(std::vector<double> const &r,
                                       std::vector<double> const &r0) const override;
+
+    virtual void batch_distance(int number_of_points,
+                                double const *r,
+                                std::vector<double> const &r0,
+                                double *distances) const override;
+    virtual void batch_gradient_distance(int number_of_points,
+                                         double const *r,
+                                         std::vector<double> const &r0,
+                                         double *distances,
+                                         double *gradients) const override;
     
     virtual std::string description() const override
     {
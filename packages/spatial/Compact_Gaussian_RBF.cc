@@ -49,3 +49,31 @@ dd_value(double r) const
         return 0.;
     }
 }
+
+void Compact_Gaussian_RBF::
+batch_values(int number_of_points,
+             double const *r,
+             double *values) const
+{
+    #pragma omp simd
+    for (int i = 0; i < number_of_points; ++i)
+    {
+        values[i] = r[i] < radius_ ? k1_ * exp(-r[i] * r[i]) - k2_ : 0.;
+    }
+}
+
+void Compact_Gaussian_RBF::
+batch_gradient_values(int number_of_points,
+                      double const *r,
+                      double *values,
+                      double *d_values) const
+{
+    #pragma omp simd
+    for (int i = 0; i < number_of_points; ++i)
+    {
+        bool const inside = r[i] < radius_;
+        double const e = k1_ * exp(-r[i] * r[i]);
+        values[i] = inside ? e - k2_ : 0.;
+        d_values[i] = inside ? -2 * r[i] * e : 0.;
+    }
+}
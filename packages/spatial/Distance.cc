@@ -1,6 +1,53 @@
 #include "Distance.hh"
 
+using std::vector;
+
 Distance::
 Distance()
 {
 }
+
+void Distance::
+batch_distance(int number_of_points,
+               double const *r,
+               vector<double> const &r0,
+               double *distances) const
+{
+    int dim = dimension();
+    vector<double> position(dim);
+    for (int i = 0; i < number_of_points; ++i)
+    {
+        for (int d = 0; d < dim; ++d)
+        {
+            position[d] = r[i + number_of_points * d];
+        }
+        distances[i] = distance(position,
+                                r0);
+    }
+}
+
+void Distance::
+batch_gradient_distance(int number_of_points,
+                        double const *r,
+                        vector<double> const &r0,
+                        double *distances,
+                        double *gradients) const
+{
+    int dim = dimension();
+    vector<double> position(dim);
+    for (int i = 0; i < number_of_points; ++i)
+    {
+        for (int d = 0; d < dim; ++d)
+        {
+            position[d] = r[i + number_of_points * d];
+        }
+        distances[i] = distance(position,
+                                r0);
+        vector<double> const gradient = gradient_distance(position,
+                                                          r0);
+        for (int d = 0; d < dim; ++d)
+        {
+            gradients[i + number_of_points * d] = gradient[d];
+        }
+    }
+}
@@ -34,6 +34,18 @@ public:
     virtual double laplacian_distance(std::vector<double> const &r,
                                       std::vector<double> const &r0) const = 0;
 
+    // Distances and gradients for several points at once, with coordinate d
+    // of point i at r[i + number_of_points * d] (gradients use the same layout)
+    virtual void batch_distance(int number_of_points,
+                                double const *r,
+                                std::vector<double> const &r0,
+                                double *distances) const;
+    virtual void batch_gradient_distance(int number_of_points,
+                                         double const *r,
+                                         std::vector<double> const &r0,
+                                         double *distances,
+                                         double *gradients) const;
+
     virtual std::string description() const = 0;
     
     virtual void check_class_invariants() const = 0;
@@ -24,3 +24,30 @@ dd_value(double r) const
 {
     return (-2 + 4 * r * r) * exp(- r * r);
 }
+
+void Gaussian_RBF::
+batch_values(int number_of_points,
+             double const *r,
+             double *values) const
+{
+    #pragma omp simd
+    for (int i = 0; i < number_of_points; ++i)
+    {
+        values[i] = exp(-r[i] * r[i]);
+    }
+}
+
+void Gaussian_RBF::
+batch_gradient_values(int number_of_points,
+                      double const *r,
+                      double *values,
+                      double *d_values) const
+{
+    #pragma omp simd
+    for (int i = 0; i < number_of_points; ++i)
+    {
+        double const e = exp(-r[i] * r[i]);
+        values[i] = e;
+        d_values[i] = -2 * r[i] * e;
+    }
+}
@@ -22,6 +22,15 @@ public:
     // Second derivative of the basis function
     virtual double dd_value(double r) const override;
 
+    // Vectorized values and derivatives
+    virtual void batch_values(int number_of_points,
+                              double const *r,
+                              double *values) const override;
+    virtual void batch_gradient_values(int number_of_points,
+                                       double const *r,
+                                       double *values,
+                                       double *d_values) const override;
+
     virtual std::string description() const override
     {
         return "gaussian";
@@ -0,0 +1,174 @@
+#include "Integral_Arena.hh"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+
+#include "Check.hh"
+
+using namespace std;
+
+namespace // anonymous
+{
+    // Identifies the file format
+    char const cache_identifier[8] = {'i', 'b', 'e', 'x', 'i', 'n', 't', '1'};
+    
+    struct Cache_Header
+    {
+        char identifier[8];
+        uint64_t key;
+        uint64_t size;
+    };
+} // namespace
+
+Integral_Arena::
+Integral_Arena(int dimension,
+               vector<int> const &number_of_basis_functions,
+               vector<int> const &number_of_boundary_surfaces):
+    dimension_(dimension),
+    number_of_points_(number_of_basis_functions.size()),
+    number_of_basis_functions_(number_of_basis_functions),
+    number_of_boundary_surfaces_(number_of_boundary_surfaces)
+{
+    // Get offsets into the data for each weight function
+    offsets_.resize(number_of_points_ + 1);
+    offsets_[0] = 0;
+    for (int i = 0; i < number_of_points_; ++i)
+    {
+        int number_of_bases = number_of_basis_functions_[i];
+        int number_of_surfaces = number_of_boundary_surfaces_[i];
+        int local_size = (number_of_surfaces // is_w
+                          + number_of_surfaces * number_of_bases // is_b_w
+                          + 1 // iv_w
+                          + dimension_ // iv_dw
+                          + number_of_bases // iv_b_w
+                          + 2 * number_of_bases * dimension_ // iv_b_dw, iv_db_w
+                          + number_of_bases * dimension_ * dimension_); // iv_db_dw
+        offsets_[i + 1] = offsets_[i] + local_size;
+    }
+    
+    // Allocate data
+    data_.assign(offsets_[number_of_points_], 0.);
+
+    check_class_invariants();
+}
+
+void Integral_Arena::
+zero()
+{
+    data_.assign(data_.size(), 0.);
+}
+
+void Integral_Arena::
+get_integrals(int i,
+              Weight_Function::Integrals &integrals)
+{
+    Assert(i >= 0 && i < number_of_points_);
+    
+    int number_of_bases = number_of_basis_functions_[i];
+    int number_of_surfaces = number_of_boundary_surfaces_[i];
+    double *data = data_.data() + offsets_[i];
+    
+    // Set spans in the order given in the class description
+    integrals.arena = shared_from_this();
+    integrals.is_w = Integral_Span(data, number_of_surfaces);
+    data += integrals.is_w.size();
+    integrals.is_b_w = Integral_Span(data, number_of_surfaces * number_of_bases);
+    data += integrals.is_b_w.size();
+    integrals.iv_w = Integral_Span(data, 1);
+    data += integrals.iv_w.size();
+    integrals.iv_dw = Integral_Span(data, dimension_);
+    data += integrals.iv_dw.size();
+    integrals.iv_b_w = Integral_Span(data, number_of_bases);
+    data += integrals.iv_b_w.size();
+    integrals.iv_b_dw = Integral_Span(data, number_of_bases * dimension_);
+    data += integrals.iv_b_dw.size();
+    integrals.iv_db_w = Integral_Span(data, number_of_bases * dimension_);
+    data += integrals.iv_db_w.size();
+    integrals.iv_db_dw = Integral_Span(data, number_of_bases * dimension_ * dimension_);
+    data += integrals.iv_db_dw.size();
+    
+    Check(data == data_.data() + offsets_[i + 1]);
+}
+
+bool Integral_Arena::
+read(string const &filename,
+     uint64_t key)
+{
+    return read_cache(filename,
+                      key,
+                      data_);
+}
+
+bool Integral_Arena::
+write(string const &filename,
+      uint64_t key) const
+{
+    return write_cache(filename,
+                       key,
+                       data_);
+}
+
+bool Integral_Arena::
+read_cache(string const &filename,
+           uint64_t key,
+           vector<double> &data)
+{
+    ifstream file(filename, ios::binary);
+    if (!file)
+    {
+        return false;
+    }
+
+    // Check that the cache matches the expected data
+    Cache_Header header;
+    file.read(reinterpret_cast<char *>(&header), sizeof(header));
+    if (!file
+        || memcmp(header.identifier, cache_identifier, sizeof(cache_identifier)) != 0
+        || header.key != key
+        || header.size != data.size())
+    {
+        return false;
+    }
+
+    // Read data into a temporary so a truncated file leaves the data unchanged
+    vector<double> temp_data(data.size());
+    file.read(reinterpret_cast<char *>(temp_data.data()), temp_data.size() * sizeof(double));
+    if (!file)
+    {
+        return false;
+    }
+    
+    // Copy rather than swap so existing spans stay valid
+    copy(temp_data.begin(), temp_data.end(), data.begin());
+    return true;
+}
+
+bool Integral_Arena::
+write_cache(string const &filename,
+            uint64_t key,
+            vector<double> const &data)
+{
+    ofstream file(filename, ios::binary | ios::trunc);
+    if (!file)
+    {
+        return false;
+    }
+
+    Cache_Header header;
+    memcpy(header.identifier, cache_identifier, sizeof(cache_identifier));
+    header.key = key;
+    header.size = data.size();
+    file.write(reinterpret_cast<char const *>(&header), sizeof(header));
+    file.write(reinterpret_cast<char const *>(data.data()), data.size() * sizeof(double));
+    return static_cast<bool>(file);
+}
+
+void Integral_Arena::
+check_class_invariants() const
+{
+    Assert(static_cast<int>(number_of_basis_functions_.size()) == number_of_points_);
+    Assert(static_cast<int>(number_of_boundary_surfaces_.size()) == number_of_points_);
+    Assert(static_cast<int>(offsets_.size()) == number_of_points_ + 1);
+    Assert(static_cast<int>(data_.size()) == offsets_[number_of_points_]);
+}
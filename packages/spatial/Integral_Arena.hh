@@ -0,0 +1,79 @@
+#ifndef Integral_Arena_hh
+#define Integral_Arena_hh
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "Weight_Function.hh"
+
+/*
+  Contiguous storage for the integrals of a set of weight functions
+
+  The integrals for weight function i are stored in the range
+  [offsets[i], offsets[i + 1]) of a single array, in the order
+  is_w, is_b_w, iv_w, iv_dw, iv_b_w, iv_b_dw, iv_db_w, iv_db_dw.
+  The Weight_Function::Integrals returned by get_integrals() hold spans into
+  this array and a pointer back to the arena, so the storage lives as long as
+  any weight function that uses it.
+*/
+class Integral_Arena : public std::enable_shared_from_this<Integral_Arena>
+{
+public:
+
+    // Allocate zeroed integrals for each weight function
+    Integral_Arena(int dimension,
+                   std::vector<int> const &number_of_basis_functions,
+                   std::vector<int> const &number_of_boundary_surfaces);
+
+    // Number of weight functions
+    int number_of_points() const
+    {
+        return number_of_points_;
+    }
+
+    // Total number of integral values
+    int size() const
+    {
+        return data_.size();
+    }
+    
+    // Set all integrals to zero
+    void zero();
+    
+    // Get spans into the integrals of weight function i
+    void get_integrals(int i,
+                       Weight_Function::Integrals &integrals);
+
+    // Binary cache of the integral data, keyed by a hash of everything the
+    // integrals depend on. The file is a fixed header followed by the raw
+    // data, so it can also be memory mapped. Read returns false, leaving the
+    // data unchanged, if the file is missing or was written for another key;
+    // write returns false if the file could not be written.
+    bool read(std::string const &filename,
+              std::uint64_t key);
+    bool write(std::string const &filename,
+               std::uint64_t key) const;
+
+    // Read or write other data in the same format as the integral cache
+    static bool read_cache(std::string const &filename,
+                           std::uint64_t key,
+                           std::vector<double> &data);
+    static bool write_cache(std::string const &filename,
+                            std::uint64_t key,
+                            std::vector<double> const &data);
+
+    void check_class_invariants() const;
+    
+private:
+
+    int dimension_;
+    int number_of_points_;
+    std::vector<int> number_of_basis_functions_;
+    std::vector<int> number_of_boundary_surfaces_;
+    std::vector<int> offsets_;
+    std::vector<double> data_;
+};
+
+#endif
@@ -0,0 +1,84 @@
+#ifndef Integral_Span_hh
+#define Integral_Span_hh
+
+#include <vector>
+
+/*
+  Non-owning view of a contiguous range of integral data
+
+  The data is owned by an Integral_Arena, which should be kept alive for as
+  long as the span is in use.
+*/
+class Integral_Span
+{
+public:
+
+    Integral_Span():
+        data_(nullptr),
+        size_(0)
+    {
+    }
+    Integral_Span(double *data,
+                  int size):
+        data_(data),
+        size_(size)
+    {
+    }
+    
+    // Size and data access
+    int size() const
+    {
+        return size_;
+    }
+    bool empty() const
+    {
+        return size_ == 0;
+    }
+    double *data()
+    {
+        return data_;
+    }
+    double const *data() const
+    {
+        return data_;
+    }
+    double &operator[](int i)
+    {
+        return data_[i];
+    }
+    double const &operator[](int i) const
+    {
+        return data_[i];
+    }
+    
+    // Iterators
+    double *begin()
+    {
+        return data_;
+    }
+    double *end()
+    {
+        return data_ + size_;
+    }
+    double const *begin() const
+    {
+        return data_;
+    }
+    double const *end() const
+    {
+        return data_ + size_;
+    }
+    
+    // Copy the data into a vector
+    std::vector<double> to_vector() const
+    {
+        return std::vector<double>(data_, data_ + size_);
+    }
+    
+private:
+    
+    double *data_;
+    int size_;
+};
+
+#endif
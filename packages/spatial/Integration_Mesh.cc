@@ -32,6 +32,7 @@ Integration_Mesh(int dimension,
     // Initialize mesh
     initialize_mesh();
     initialize_connectivity();
+    initialize_local_basis_indices();
 
     // Check to ensure sufficient number of cells
     if (number_of_nodes_ < number_of_points_
@@ -54,8 +55,14 @@ Integration_Mesh(int dimension,
     {
         weight_normalization_ = weights[0]->function()->normalization();
     }
-    
-    
+
+    // The error-controlled quadrature is refined as each cell is integrated
+    number_of_unconverged_cells_ = 0;
+    if (options_->adaptive_quadrature
+        && options_->quadrature_tolerance > 0)
+    {
+        cell_refined_.assign(number_of_cells_, 0);
+    }
 }
 
 void Integration_Mesh::
@@ -88,10 +95,6 @@ initialize_mesh()
     
     // Initialize nodes
     nodes_.resize(number_of_nodes_);
-    for (shared_ptr<Integration_Node> &node : nodes_)
-    {
-        node = make_shared<Integration_Node>();
-    }
     switch (dimension_)
     {
     case 1:
@@ -100,8 +103,8 @@ initialize_mesh()
         for (int i = 0; i < dimensional_nodes_[0]; ++i)
         {
             double index = i;
-            shared_ptr<Integration_Node> node = nodes_[i];
-            node->position = {options_->limits[di][0] + intervals_[di] * i};
+            Integration_Node &node = nodes_[i];
+            node.position = {options_->limits[di][0] + intervals_[di] * i};
         }
         break;
     }
@@ -114,8 +117,8 @@ initialize_mesh()
             for (int j = 0; j < dimensional_nodes_[1]; ++j)
             {
                 int index = j + dimensional_nodes_[1] * i;
-                shared_ptr<Integration_Node> node = nodes_[index];
-                node->position = {options_->limits[di][0] + intervals_[di] * i,
+                Integration_Node &node = nodes_[index];
+                node.position = {options_->limits[di][0] + intervals_[di] * i,
                                   options_->limits[dj][0] + intervals_[dj] * j};
             }
         }
@@ -133,8 +136,8 @@ initialize_mesh()
                 for (int k = 0; k < dimensional_nodes_[2]; ++k)
                 {
                     int index = k + dimensional_nodes_[2] * (j + dimensional_nodes_[1] * i);
-                    shared_ptr<Integration_Node> node = nodes_[index];
-                    node->position = {options_->limits[di][0] + intervals_[di] * i,
+                    Integration_Node &node = nodes_[index];
+                    node.position = {options_->limits[di][0] + intervals_[di] * i,
                                       options_->limits[dj][0] + intervals_[dj] * j,
                                       options_->limits[dk][0] + intervals_[dk] * k};
                 }
@@ -148,10 +151,6 @@ initialize_mesh()
 
     // Initialize cells
     cells_.resize(number_of_cells_);
-    for (shared_ptr<Integration_Cell> &cell : cells_)
-    {
-        cell = make_shared<Integration_Cell>();
-    }
     switch (dimension_)
     {
     case 1:
@@ -160,15 +159,15 @@ initialize_mesh()
         for (int i = 0; i < options_->dimensional_cells[di]; ++i)
         {
             int index = i;
-            shared_ptr<Integration_Cell> cell = cells_[index];
+            Integration_Cell &cell = cells_[index];
             
             // Set upper and lower limits
-            cell->limits.resize(dimension_);
+            cell.limits.resize(dimension_);
             for (int d = 0; d < dimension_; ++d)
             {
                 int l0 = index;
                 int l1 = l0 + 1;
-                cell->limits[d] = {options_->limits[d][0] + intervals_[d] * l0,
+                cell.limits[d] = {options_->limits[d][0] + intervals_[d] * l0,
                                    options_->limits[d][0] + intervals_[d] * l1};
             }
                 
@@ -176,9 +175,9 @@ initialize_mesh()
             for (int ni = i; ni <= i + 1; ++ni)
             {
                 int n_index = ni;
-                shared_ptr<Integration_Node> node = nodes_[n_index];
-                node->neighboring_cells.push_back(index);
-                cell->neighboring_nodes.push_back(n_index);
+                Integration_Node &node = nodes_[n_index];
+                node.neighboring_cells.push_back(index);
+                cell.neighboring_nodes.push_back(n_index);
             }
         }
         break;
@@ -193,15 +192,15 @@ initialize_mesh()
             {
                 int index = j + options_->dimensional_cells[dj] * i;
                 vector<int> indices = {i, j};
-                shared_ptr<Integration_Cell> cell = cells_[index];
+                Integration_Cell &cell = cells_[index];
                 
                 // Set upper and lower limits
-                cell->limits.resize(dimension_);
+                cell.limits.resize(dimension_);
                 for (int d = 0; d < dimension_; ++d)
                 {
                     int l0 = indices[d];
                     int l1 = l0 + 1;
-                    cell->limits[d] = {options_->limits[d][0] + intervals_[d] * l0,
+                    cell.limits[d] = {options_->limits[d][0] + intervals_[d] * l0,
                                        options_->limits[d][0] + intervals_[d] * l1};
                 }
                 
@@ -211,9 +210,9 @@ initialize_mesh()
                     for (int nj = j; nj <= j + 1; ++nj)
                     {
                         int n_index = nj + dimensional_nodes_[dj] * ni;
-                        shared_ptr<Integration_Node> node = nodes_[n_index];
-                        node->neighboring_cells.push_back(index);
-                        cell->neighboring_nodes.push_back(n_index);
+                        Integration_Node &node = nodes_[n_index];
+                        node.neighboring_cells.push_back(index);
+                        cell.neighboring_nodes.push_back(n_index);
                     }
                 }
             }
@@ -233,7 +232,7 @@ initialize_mesh()
                 {
                     int index = k + options_->dimensional_cells[dk] * (j + options_->dimensional_cells[dj] * i);
                     vector<int> indices = {i, j, k};
-                    shared_ptr<Integration_Cell> cell = cells_[index];
+                    Integration_Cell &cell = cells_[index];
                     
                     // Set neighboring nodes and cells
                     for (int ni = i; ni <= i + 1; ++ni)
@@ -243,20 +242,20 @@ initialize_mesh()
                             for (int nk = k; nk <= k + 1; ++nk)
                             {
                                 int n_index = nk + dimensional_nodes_[dk] * (nj + dimensional_nodes_[dj] * ni);
-                                shared_ptr<Integration_Node> node = nodes_[n_index];
-                                node->neighboring_cells.push_back(index);
-                                cell->neighboring_nodes.push_back(n_index);
+                                Integration_Node &node = nodes_[n_index];
+                                node.neighboring_cells.push_back(index);
+                                cell.neighboring_nodes.push_back(n_index);
                             }
                         }
                     }
                 
                     // Set upper and lower limits
-                    cell->limits.resize(dimension_);
+                    cell.limits.resize(dimension_);
                     for (int d = 0; d < dimension_; ++d)
                     {
                         int l0 = indices[d];
                         int l1 = l0 + 1;
-                        cell->limits[d] = {options_->limits[d][0] + intervals_[d] * l0,
+                        cell.limits[d] = {options_->limits[d][0] + intervals_[d] * l0,
                                            options_->limits[d][0] + intervals_[d] * l1};
                     }
                 }
@@ -287,8 +286,8 @@ initialize_mesh()
         surfaces_[1]->normal = 1;
         surfaces_[0]->neighboring_cell = 0;
         surfaces_[1]->neighboring_cell = number_of_cells_ - 1;
-        nodes_[0]->neighboring_surfaces.push_back(0);
-        nodes_[dimensional_nodes_[0] - 1]->neighboring_surfaces.push_back(1);
+        nodes_[0].neighboring_surfaces.push_back(0);
+        nodes_[dimensional_nodes_[0] - 1].neighboring_surfaces.push_back(1);
         break;
     }
     case 2:
@@ -318,8 +317,8 @@ initialize_mesh()
                 for (int nj = j; nj <= j + 1; ++nj)
                 {
                     int n_index = nj + dimensional_nodes_[dj] * ni;
-                    shared_ptr<Integration_Node> node = nodes_[n_index];
-                    node->neighboring_surfaces.push_back(index);
+                    Integration_Node &node = nodes_[n_index];
+                    node.neighboring_surfaces.push_back(index);
                 }
 
                 index += 1;
@@ -343,8 +342,8 @@ initialize_mesh()
                 for (int ni = i; ni <= i + 1; ++ni)
                 {
                     int n_index = nj + dimensional_nodes_[dj] * ni;
-                    shared_ptr<Integration_Node> node = nodes_[n_index];
-                    node->neighboring_surfaces.push_back(index);
+                    Integration_Node &node = nodes_[n_index];
+                    node.neighboring_surfaces.push_back(index);
                 }
                 
                 index += 1;
@@ -385,8 +384,8 @@ initialize_mesh()
                         for (int nk = k; nk <= k + 1; ++nk)
                         {
                             int n_index = nk + dimensional_nodes_[dk] * (nj + dimensional_nodes_[dj] * ni);
-                            shared_ptr<Integration_Node> node = nodes_[n_index];
-                            node->neighboring_surfaces.push_back(index);
+                            Integration_Node &node = nodes_[n_index];
+                            node.neighboring_surfaces.push_back(index);
                         }
                     }
 
@@ -416,8 +415,8 @@ initialize_mesh()
                         for (int nk = k; nk <= k + 1; ++nk)
                         {
                             int n_index = nk + dimensional_nodes_[dk] * (nj + dimensional_nodes_[dj] * ni);
-                            shared_ptr<Integration_Node> node = nodes_[n_index];
-                            node->neighboring_surfaces.push_back(index);
+                            Integration_Node &node = nodes_[n_index];
+                            node.neighboring_surfaces.push_back(index);
                         }
                     }
 
@@ -447,8 +446,8 @@ initialize_mesh()
                         for (int nj = j; nj <= j + 1; ++nj)
                         {
                             int n_index = nk + dimensional_nodes_[dk] * (nj + dimensional_nodes_[dj] * ni);
-                            shared_ptr<Integration_Node> node = nodes_[n_index];
-                            node->neighboring_surfaces.push_back(index);
+                            Integration_Node &node = nodes_[n_index];
+                            node.neighboring_surfaces.push_back(index);
                         }
                     }
                     
@@ -465,7 +464,7 @@ initialize_mesh()
     vector<vector<double> > kd_positions(number_of_nodes_, vector<double>(dimension_));
     for (int i = 0; i < number_of_nodes_; ++i)
     {
-        kd_positions[i] = nodes_[i]->position;
+        kd_positions[i] = nodes_[i].position;
     }
     node_tree_ = make_shared<KD_Tree>(dimension_,
                                       number_of_nodes_,
@@ -478,132 +477,89 @@ initialize_mesh()
 void Integration_Mesh::
 initialize_connectivity()
 {
-    // Get weight function connectivity
+    // Get the cells and surfaces that intersect each weight function
+    vector<vector<int> > weight_cells(number_of_points_);
+    vector<vector<int> > weight_surfaces(number_of_points_);
+    #pragma omp parallel for schedule(dynamic, 64)
     for (int i = 0; i < number_of_points_; ++i)
     {
-        // Get weight function data
         shared_ptr<Weight_Function> const weight = weights_[i];
-        double const radius = get_inclusive_radius(weight->radius());
-        vector<double> const position = weight->position();
-        
-        // Add weight function to containing cell
-        int containing_cell_index = get_cell_at_position(position);
-        cells_[containing_cell_index]->weight_indices.push_back(i);
-        
-        // Find nodes that intersect with the weight function
-        vector<int> intersecting_nodes;
-        vector<double> distances;
-        int number_of_intersecting_nodes
-            = node_tree_->radius_search(radius,
-                                        position,
-                                        intersecting_nodes,
-                                        distances);
-        
-        // Add weight indices to cells and surfaces
-        for (int j = 0; j < number_of_intersecting_nodes; ++j)
-        {
-            shared_ptr<Integration_Node> node = nodes_[intersecting_nodes[j]];
-            
-            for (int c_index : node->neighboring_cells)
-            {
-                cells_[c_index]->weight_indices.push_back(i);
-            }
-            
-            for (int s_index : node->neighboring_surfaces)
-            {
-                surfaces_[s_index]->weight_indices.push_back(i);
-            }
-        }
-        
+        get_intersections(get_inclusive_radius(weight->radius()),
+                          weight->position(),
+                          weight_cells[i],
+                          weight_surfaces[i]);
     }
+    get_adjacency(number_of_cells_,
+                  weight_cells,
+                  cell_weight_offsets_,
+                  cell_weight_indices_);
+    vector<int> surface_weight_offsets;
+    vector<int> surface_weight_indices;
+    get_adjacency(number_of_surfaces_,
+                  weight_surfaces,
+                  surface_weight_offsets,
+                  surface_weight_indices);
     
-    // Get basis function connectivity
-    if (!options_->identical_basis_functions)
+    // Get the cells and surfaces that intersect each basis function
+    vector<int> surface_basis_offsets;
+    vector<int> surface_basis_indices;
+    if (options_->identical_basis_functions)
+    {
+        surface_basis_offsets = surface_weight_offsets;
+        surface_basis_indices = surface_weight_indices;
+    }
+    else
     {
+        vector<vector<int> > basis_cells(number_of_points_);
+        vector<vector<int> > basis_surfaces(number_of_points_);
+        #pragma omp parallel for schedule(dynamic, 64)
         for (int i = 0; i < number_of_points_; ++i)
         {
-            // Get basis function data
             shared_ptr<Basis_Function> const basis = bases_[i];
-            double radius = get_inclusive_radius(basis->radius());
-            vector<double> const position = basis->position();
-
-            // Add weight function to containing cell
-            int containing_cell_index = get_cell_at_position(position);
-            cells_[containing_cell_index]->basis_indices.push_back(i);
-            
-            // Find nodes that intersect with the basis function
-            vector<int> intersecting_nodes;
-            vector<double> distances;
-            int number_of_intersecting_nodes
-                = node_tree_->radius_search(radius,
-                                            position,
-                                            intersecting_nodes,
-                                            distances);
-        
-            // Add basis indices to cells and surfaces
-            for (int j = 0; j < number_of_intersecting_nodes; ++j)
-            {
-                shared_ptr<Integration_Node> node = nodes_[intersecting_nodes[j]];
-            
-                for (int c_index : node->neighboring_cells)
-                {
-                    cells_[c_index]->basis_indices.push_back(i);
-                }
-
-                for (int s_index : node->neighboring_surfaces)
-                {
-                    surfaces_[s_index]->basis_indices.push_back(i);
-                }
-            }
+            get_intersections(get_inclusive_radius(basis->radius()),
+                              basis->position(),
+                              basis_cells[i],
+                              basis_surfaces[i]);
         }
+        get_adjacency(number_of_cells_,
+                      basis_cells,
+                      cell_basis_offsets_,
+                      cell_basis_indices_);
+        get_adjacency(number_of_surfaces_,
+                      basis_surfaces,
+                      surface_basis_offsets,
+                      surface_basis_indices);
     }
     
-    // Remove duplicate volume indices
+    // Point the cells to their indices, which for identical basis
+    // functions are the weight function indices
+    vector<int> const &cell_basis_offsets
+        = options_->identical_basis_functions ? cell_weight_offsets_ : cell_basis_offsets_;
+    vector<int> const &cell_basis_indices
+        = options_->identical_basis_functions ? cell_weight_indices_ : cell_basis_indices_;
+    #pragma omp parallel for
     for (int i = 0; i < number_of_cells_; ++i)
     {
-        shared_ptr<Integration_Cell> cell = cells_[i];
-        
-        // Remove duplicate weight indices
-        sort(cell->weight_indices.begin(), cell->weight_indices.end());
-        cell->weight_indices.erase(unique(cell->weight_indices.begin(), cell->weight_indices.end()), cell->weight_indices.end());
-        cell->number_of_weight_functions = cell->weight_indices.size();
-
-        // Remove duplicate basis indices
-        if (options_->identical_basis_functions)
-        {
-            cell->basis_indices = cell->weight_indices;
-            cell->number_of_basis_functions = cell->number_of_weight_functions;
-        }
-        else
-        {
-            sort(cell->basis_indices.begin(), cell->basis_indices.end());
-            cell->basis_indices.erase(unique(cell->basis_indices.begin(), cell->basis_indices.end()), cell->basis_indices.end());
-            cell->number_of_basis_functions = cell->basis_indices.size();
-        }
+        Integration_Cell &cell = cells_[i];
+        cell.number_of_weight_functions = cell_weight_offsets_[i + 1] - cell_weight_offsets_[i];
+        cell.number_of_basis_functions = cell_basis_offsets[i + 1] - cell_basis_offsets[i];
+        cell.weight_indices = Integration_Indices(cell_weight_indices_.data() + cell_weight_offsets_[i],
+                                                  cell.number_of_weight_functions);
+        cell.basis_indices = Integration_Indices(cell_basis_indices.data() + cell_basis_offsets[i],
+                                                 cell.number_of_basis_functions);
     }
     
-    // Remove duplicate surface indices
+    // Copy the indices into the surfaces, which may also be created
+    // outside of the mesh
     for (int i = 0; i < number_of_surfaces_; ++i)
     {
         shared_ptr<Integration_Surface> surface = surfaces_[i];
-
-        // Remove duplicate weight indices
-        sort(surface->weight_indices.begin(), surface->weight_indices.end());
-        surface->weight_indices.erase(unique(surface->weight_indices.begin(), surface->weight_indices.end()), surface->weight_indices.end());
+        surface->weight_indices.assign(surface_weight_indices.begin() + surface_weight_offsets[i],
+                                       surface_weight_indices.begin() + surface_weight_offsets[i + 1]);
+        surface->basis_indices.assign(surface_basis_indices.begin() + surface_basis_offsets[i],
+                                      surface_basis_indices.begin() + surface_basis_offsets[i + 1]);
         surface->number_of_weight_functions = surface->weight_indices.size();
-
-        // Remove duplicate basis indices
-        if (options_->identical_basis_functions)
-        {
-            surface->basis_indices = surface->weight_indices;
-            surface->number_of_basis_functions = surface->number_of_weight_functions;
-        }
-        else
-        {
-            sort(surface->basis_indices.begin(), surface->basis_indices.end());
-            surface->basis_indices.erase(unique(surface->basis_indices.begin(), surface->basis_indices.end()), surface->basis_indices.end());
-            surface->number_of_basis_functions = surface->basis_indices.size();
-        }
+        surface->number_of_basis_functions = surface->basis_indices.size();
     }
 
     // If applicable, change the number of integration ordinates
@@ -612,13 +568,13 @@ initialize_connectivity()
         // Get background cell integration ordinates
         for (int i = 0; i < number_of_cells_; ++i)
         {
-            shared_ptr<Integration_Cell> cell = cells_[i];
+            Integration_Cell &cell = cells_[i];
             
             // Find minimum radius
             double min_radius = 0.5 * numeric_limits<double>::max();
-            for (int j = 0; j < cell->number_of_weight_functions; ++j)
+            for (int j = 0; j < cell.number_of_weight_functions; ++j)
             {
-                int const k = cell->weight_indices[j];
+                int const k = cell.weight_indices[j];
                 shared_ptr<Weight_Function> const weight = weights_[k];
                 double const radius = weight->radius();
                 
@@ -629,9 +585,9 @@ initialize_connectivity()
             }
             if (!options_->identical_basis_functions)
             {
-                for (int j = 0; j < cell->number_of_basis_functions; ++j)
+                for (int j = 0; j < cell.number_of_basis_functions; ++j)
                 {
-                    int const k = cell->basis_indices[j];
+                    int const k = cell.basis_indices[j];
                     shared_ptr<Basis_Function> const basis = bases_[k];
                     double const radius = basis->radius();
                     
@@ -646,7 +602,7 @@ initialize_connectivity()
             double max_length = 0.0;
             for (int d = 0; d < dimension_; ++d)
             {
-                double length = cell->limits[d][1] - cell->limits[d][0];
+                double length = cell.limits[d][1] - cell.limits[d][0];
                 if (length > max_length)
                 {
                     max_length = length;
@@ -664,21 +620,21 @@ initialize_connectivity()
             int const global_integration_ordinates = options_->integration_ordinates;
             if (expected_number > global_integration_ordinates)
             {
-                cell->number_of_integration_ordinates = expected_number;
+                cell.number_of_integration_ordinates = expected_number;
             }
             else
             {
-                cell->number_of_integration_ordinates = global_integration_ordinates;
+                cell.number_of_integration_ordinates = global_integration_ordinates;
             }
 
             // Print adaptive information for debug
             // for (int d = 0; d < dimension_; ++d)
             // {
-            //     cout << setw(14) << cell->limits[d][0];
+            //     cout << setw(14) << cell.limits[d][0];
             // }
             // cout << setw(14) << max_length;
             // cout << setw(14) << min_radius;
-            // cout << setw(6) << cell->number_of_integration_ordinates;
+            // cout << setw(6) << cell.number_of_integration_ordinates;
             // cout << endl;
         }
         
@@ -716,13 +672,13 @@ initialize_connectivity()
             }
             
             // Find min surface length
-            shared_ptr<Integration_Cell> cell = cells_[surface->neighboring_cell];
+            Integration_Cell const &cell = cells_[surface->neighboring_cell];
             double min_length = 0.5 * numeric_limits<double>::max();
             for (int d = 0; d < dimension_; ++d)
             {
                 if (d != surface->dimension)
                 {
-                    double length = cell->limits[d][1] - cell->limits[d][0];
+                    double length = cell.limits[d][1] - cell.limits[d][0];
                     if (length < min_length)
                     {
                         min_length = length;
@@ -750,9 +706,9 @@ initialize_connectivity()
         // Set number of integration ordinates for each cell and surface to global value
         for (int i = 0; i < number_of_cells_; ++i)
         {
-            shared_ptr<Integration_Cell> cell = cells_[i];
+            Integration_Cell &cell = cells_[i];
 
-            cell->number_of_integration_ordinates = options_->integration_ordinates;
+            cell.number_of_integration_ordinates = options_->integration_ordinates;
         }
         for (int i = 0; i < number_of_surfaces_; ++i)
         {
@@ -765,6 +721,93 @@ initialize_connectivity()
 
 }
 
+void Integration_Mesh::
+get_intersections(double radius,
+                  vector<double> const &position,
+                  vector<int> &cells,
+                  vector<int> &surfaces) const
+{
+    // Add the containing cell
+    cells.assign(1, get_cell_at_position(position));
+    surfaces.clear();
+    
+    // Find nodes that intersect with the function
+    vector<int> intersecting_nodes;
+    vector<double> distances;
+    int number_of_intersecting_nodes
+        = node_tree_->radius_search(radius,
+                                    position,
+                                    intersecting_nodes,
+                                    distances);
+    
+    // Add the cells and surfaces that neighbor these nodes
+    for (int j = 0; j < number_of_intersecting_nodes; ++j)
+    {
+        Integration_Node const &node = nodes_[intersecting_nodes[j]];
+        cells.insert(cells.end(),
+                     node.neighboring_cells.begin(),
+                     node.neighboring_cells.end());
+        surfaces.insert(surfaces.end(),
+                        node.neighboring_surfaces.begin(),
+                        node.neighboring_surfaces.end());
+    }
+
+    // Remove duplicates
+    sort(cells.begin(), cells.end());
+    cells.erase(unique(cells.begin(), cells.end()), cells.end());
+    sort(surfaces.begin(), surfaces.end());
+    surfaces.erase(unique(surfaces.begin(), surfaces.end()), surfaces.end());
+}
+
+void Integration_Mesh::
+get_adjacency(int number_of_entities,
+              vector<vector<int> > const &function_entities,
+              vector<int> &offsets,
+              vector<int> &indices) const
+{
+    int const number_of_functions = function_entities.size();
+    
+    // Count the functions in each entity
+    offsets.assign(number_of_entities + 1, 0);
+    #pragma omp parallel for
+    for (int i = 0; i < number_of_functions; ++i)
+    {
+        for (int e : function_entities[i])
+        {
+            #pragma omp atomic
+            offsets[e + 1] += 1;
+        }
+    }
+    for (int e = 0; e < number_of_entities; ++e)
+    {
+        offsets[e + 1] += offsets[e];
+    }
+    
+    // Fill in the function indices
+    indices.resize(offsets[number_of_entities]);
+    vector<int> positions(offsets.begin(), offsets.end() - 1);
+    #pragma omp parallel for
+    for (int i = 0; i < number_of_functions; ++i)
+    {
+        for (int e : function_entities[i])
+        {
+            int position;
+            #pragma omp atomic capture
+            position = positions[e]++;
+            indices[position] = i;
+        }
+    }
+    
+    // Sort the indices for each entity so the result is independent of
+    // the thread ordering
+    #pragma omp parallel for schedule(dynamic, 64)
+    for (int e = 0; e < number_of_entities; ++e)
+    {
+        sort(indices.begin() + offsets[e],
+             indices.begin() + offsets[e + 1]);
+    }
+}
+
 double Integration_Mesh::
 get_inclusive_radius(double radius) const
 {
@@ -851,8 +894,8 @@ get_cell_at_position(vector<double> const &position) const
     //     Assert(dim_indices[d] >= 0);
     //     Assert(dim_indices[d] < options_->dimensional_cells[d]);
         
-    //     double const distance_from_start = position[d] - cells_[index]->limits[d][0];
-    //     double const distance_from_end = cells_[index]->limits[d][1] - position[d];
+    //     double const distance_from_start = position[d] - cells_[index].limits[d][0];
+    //     double const distance_from_end = cells_[index].limits[d][1] - position[d];
 
     //     Assert(distance_from_start > -options_->boundary_tolerance);
     //     Assert(distance_from_end > -options_->boundary_tolerance);
@@ -867,11 +910,25 @@ get_volume_quadrature(int i,
                       int &number_of_ordinates,
                       vector<vector<double> > &ordinates,
                       vector<double> &weights) const
+{
+    Integration_Cell const &cell = cells_[i];
+    get_cell_quadrature(cell,
+                        cell.number_of_integration_ordinates,
+                        ordinates,
+                        weights);
+
+    // Set number of ordinates
+    number_of_ordinates = weights.size();
+}
+
+void Integration_Mesh::
+get_cell_quadrature(Integration_Cell const &cell,
+                    int number_of_integration_ordinates,
+                    vector<vector<double> > &ordinates,
+                    vector<double> &weights) const
 {
     // Get limits of integration
-    shared_ptr<Integration_Cell> const cell = cells_[i];
-    vector<vector<double> > const &limits = cell->limits;
-    int const number_of_integration_ordinates = cell->number_of_integration_ordinates;
+    vector<vector<double> > const &limits = cell.limits;
     int const dx = 0;
     int const dy = 1;
     int const dz = 2;
@@ -936,9 +993,187 @@ get_volume_quadrature(int i,
                                                 ordinates);
         break;
     }
+}
 
-    // Set number of ordinates
-    number_of_ordinates = weights.size();
+void Integration_Mesh::
+get_volume_values(int i,
+                  vector<vector<double> > const &basis_centers,
+                  vector<vector<double> > const &weight_centers,
+                  vector<vector<int> > const &weight_basis_indices,
+                  Integration_Cell_Values &values)
+{
+    Assert(i >= 0 && i < number_of_cells_);
+    
+    // Refine the quadrature only once per cell, and only for the cells
+    // that are actually integrated
+    if (!cell_refined_.empty() && !cell_refined_[i])
+    {
+        refine_volume_values(i,
+                             basis_centers,
+                             weight_centers,
+                             weight_basis_indices,
+                             values);
+        return;
+    }
+    
+    Integration_Cell const &cell = cells_[i];
+    get_cell_quadrature(cell,
+                        cell.number_of_integration_ordinates,
+                        values.ordinates,
+                        values.weights);
+    get_volume_values(cell,
+                      values.ordinates,
+                      basis_centers,
+                      weight_centers,
+                      values.b_val,
+                      values.b_grad,
+                      values.w_val,
+                      values.w_grad);
+}
+
+void Integration_Mesh::
+refine_volume_values(int i,
+                     vector<vector<double> > const &basis_centers,
+                     vector<vector<double> > const &weight_centers,
+                     vector<vector<int> > const &weight_basis_indices,
+                     Integration_Cell_Values &values)
+{
+    Integration_Cell &cell = cells_[i];
+    int const maximum_ordinates = options_->maximum_integration_ordinates;
+    double const tolerance = options_->quadrature_tolerance;
+    
+    // Increase the number of ordinates until the integrals from two
+    // successive orders agree, relative to the largest integral
+    int number_of_ordinates = options_->integration_ordinates;
+    vector<double> integrals;
+    get_error_integrals(cell,
+                        number_of_ordinates,
+                        basis_centers,
+                        weight_centers,
+                        weight_basis_indices,
+                        values,
+                        integrals);
+    bool converged = number_of_ordinates >= maximum_ordinates;
+    Integration_Cell_Values next_values;
+    vector<double> next_integrals;
+    while (!converged && number_of_ordinates < maximum_ordinates)
+    {
+        number_of_ordinates
+            = min(maximum_ordinates,
+                  number_of_ordinates + max(2, number_of_ordinates / 2));
+        get_error_integrals(cell,
+                            number_of_ordinates,
+                            basis_centers,
+                            weight_centers,
+                            weight_basis_indices,
+                            next_values,
+                            next_integrals);
+        
+        double scale = 0;
+        double error = 0;
+        for (int k = 0; k < integrals.size(); ++k)
+        {
+            scale = max(scale, abs(next_integrals[k]));
+            error = max(error, abs(next_integrals[k] - integrals[k]));
+        }
+        converged = error <= tolerance * scale;
+        
+        // Keep the finer order, which is the more accurate of the two
+        std::swap(values, next_values);
+        integrals.swap(next_integrals);
+    }
+    
+    cell.number_of_integration_ordinates = number_of_ordinates;
+    cell_refined_[i] = converged ? 1 : 2;
+    if (!converged)
+    {
+        #pragma omp atomic
+        number_of_unconverged_cells_ += 1;
+    }
+}
+
+void Integration_Mesh::
+copy_volume_quadrature(int i,
+                       int template_index)
+{
+    Assert(i >= 0 && i < number_of_cells_);
+    Assert(template_index >= 0 && template_index < number_of_cells_);
+    
+    if (cell_refined_.empty() || cell_refined_[i] || i == template_index)
+    {
+        return;
+    }
+    AssertMsg(cell_refined_[template_index], "template cell must be integrated first");
+    
+    cells_[i].number_of_integration_ordinates = cells_[template_index].number_of_integration_ordinates;
+    cell_refined_[i] = cell_refined_[template_index];
+    if (cell_refined_[i] == 2)
+    {
+        #pragma omp atomic
+        number_of_unconverged_cells_ += 1;
+    }
+}
+
+void Integration_Mesh::
+get_error_integrals(Integration_Cell const &cell,
+                    int number_of_integration_ordinates,
+                    vector<vector<double> > const &basis_centers,
+                    vector<vector<double> > const &weight_centers,
+                    vector<vector<int> > const &weight_basis_indices,
+                    Integration_Cell_Values &values,
+                    vector<double> &integrals) const
+{
+    int const number_of_weights = cell.number_of_weight_functions;
+    int const number_of_bases = cell.number_of_basis_functions;
+    
+    // Get quadrature and values
+    get_cell_quadrature(cell,
+                        number_of_integration_ordinates,
+                        values.ordinates,
+                        values.weights);
+    get_volume_values(cell,
+                      values.ordinates,
+                      basis_centers,
+                      weight_centers,
+                      values.b_val,
+                      values.b_grad,
+                      values.w_val,
+                      values.w_grad);
+    vector<double> const &weights = values.weights;
+    vector<double> const &b_vals = values.b_val;
+    vector<double> const &b_grads = values.b_grad;
+    vector<double> const &w_vals = values.w_val;
+    vector<double> const &w_grads = values.w_grad;
+
+    // Integrate w_i, b_j w_i and grad b_j . grad w_i for each pair
+    integrals.assign(number_of_weights * (1 + 2 * number_of_bases), 0);
+    int const number_of_ordinates = weights.size();
+    for (int q = 0; q < number_of_ordinates; ++q)
+    {
+        double const weight = weights[q];
+        double const *w_val = &w_vals[number_of_weights * q];
+        double const *w_grad = &w_grads[dimension_ * number_of_weights * q];
+        double const *b_val = &b_vals[number_of_bases * q];
+        double const *b_grad = &b_grads[dimension_ * number_of_bases * q];
+        for (int i = 0; i < number_of_weights; ++i)
+        {
+            int const k0 = i * (1 + 2 * number_of_bases);
+            integrals[k0] += weight * w_val[i];
+            for (int j = 0; j < number_of_bases; ++j)
+            {
+                if (weight_basis_indices[i][j] != Weight_Function::Errors::DOES_NOT_EXIST)
+                {
+                    double grad_product = 0;
+                    for (int d = 0; d < dimension_; ++d)
+                    {
+                        grad_product += b_grad[d + dimension_ * j] * w_grad[d + dimension_ * i];
+                    }
+                    integrals[k0 + 1 + 2 * j] += weight * b_val[j] * w_val[i];
+                    integrals[k0 + 2 + 2 * j] += weight * grad_product;
+                }
+            }
+        }
+    }
 }
 
 void Integration_Mesh::
@@ -949,8 +1184,8 @@ get_surface_quadrature(int i,
 {
     // Get limits of integration
     shared_ptr<Integration_Surface> const surface = surfaces_[i];
-    shared_ptr<Integration_Cell> const cell = cells_[surface->neighboring_cell];
-    vector<vector<double> > const &limits = cell->limits;
+    Integration_Cell const &cell = cells_[surface->neighboring_cell];
+    vector<vector<double> > const &limits = cell.limits;
     int const number_of_integration_ordinates = surface->number_of_integration_ordinates;
     int const dx = 0;
     int const dy = 1;
@@ -1123,18 +1358,18 @@ get_surface_quadrature(int i,
 }
 
 void Integration_Mesh::
-get_basis_values(shared_ptr<Integration_Cell> const cell,
+get_basis_values(Integration_Cell const &cell,
                  vector<double> const &position,
                  vector<vector<double> > const &basis_centers,
                  vector<double> &b_val) const
 {
     // Initialize values 
-    b_val.resize(cell->number_of_basis_functions);
+    b_val.resize(cell.number_of_basis_functions);
     
     // Get values for basis functions at quadrature point
-    for (int j = 0; j < cell->number_of_basis_functions; ++j)
+    for (int j = 0; j < cell.number_of_basis_functions; ++j)
     {
-        shared_ptr<Meshless_Function> const func = bases_[cell->basis_indices[j]]->function()->base_function();
+        shared_ptr<Meshless_Function> const func = bases_[cell.basis_indices[j]]->function()->base_function();
                 
         b_val[j] = func->value(position);
     }
@@ -1150,7 +1385,7 @@ get_basis_values(shared_ptr<Integration_Cell> const cell,
 }
 
 void Integration_Mesh::
-get_volume_values(shared_ptr<Integration_Cell> const cell,
+get_volume_values(Integration_Cell const &cell,
                   vector<double> const &position,
                   vector<vector<double> > const &basis_centers,
                   vector<vector<double> > const &weight_centers,
@@ -1160,15 +1395,15 @@ get_volume_values(shared_ptr<Integration_Cell> const cell,
                   vector<vector<double> > &w_grad) const
 {
     // Initialize values 
-    b_val.resize(cell->number_of_basis_functions);
-    b_grad.resize(cell->number_of_basis_functions);
-    w_val.resize(cell->number_of_weight_functions);
-    w_grad.resize(cell->number_of_weight_functions);
+    b_val.resize(cell.number_of_basis_functions);
+    b_grad.resize(cell.number_of_basis_functions);
+    w_val.resize(cell.number_of_weight_functions);
+    w_grad.resize(cell.number_of_weight_functions);
 
     // Get values for weight functions at quadrature point
-    for (int j = 0; j < cell->number_of_weight_functions; ++j)
+    for (int j = 0; j < cell.number_of_weight_functions; ++j)
     {
-        shared_ptr<Meshless_Function> const func = weights_[cell->weight_indices[j]]->function()->base_function();
+        shared_ptr<Meshless_Function> const func = weights_[cell.weight_indices[j]]->function()->base_function();
         
         w_val[j] = func->value(position);
         w_grad[j] = func->gradient_value(position);
@@ -1193,9 +1428,9 @@ get_volume_values(shared_ptr<Integration_Cell> const cell,
     else
     {
         // Get values for basis functions at quadrature point
-        for (int j = 0; j < cell->number_of_basis_functions; ++j)
+        for (int j = 0; j < cell.number_of_basis_functions; ++j)
         {
-            shared_ptr<Meshless_Function> const func = bases_[cell->basis_indices[j]]->function()->base_function();
+            shared_ptr<Meshless_Function> const func = bases_[cell.basis_indices[j]]->function()->base_function();
                 
             b_val[j] = func->value(position);
             b_grad[j] = func->gradient_value(position);
@@ -1214,6 +1449,106 @@ get_volume_values(shared_ptr<Integration_Cell> const cell,
     }
 }
 
+void Integration_Mesh::
+get_volume_values(Integration_Cell const &cell,
+                  vector<vector<double> > const &positions,
+                  vector<vector<double> > const &basis_centers,
+                  vector<vector<double> > const &weight_centers,
+                  vector<double> &b_val,
+                  vector<double> &b_grad,
+                  vector<double> &w_val,
+                  vector<double> &w_grad) const
+{
+    int number_of_positions = positions.size();
+    int number_of_weights = cell.number_of_weight_functions;
+    int number_of_bases = cell.number_of_basis_functions;
+    
+    // Store positions by dimension so each function is evaluated at all
+    // points in a single vectorized call
+    vector<double> r(number_of_positions * dimension_);
+    for (int q = 0; q < number_of_positions; ++q)
+    {
+        for (int d = 0; d < dimension_; ++d)
+        {
+            r[q + number_of_positions * d] = positions[q][d];
+        }
+    }
+    vector<double> values(number_of_positions);
+    vector<double> gradients(number_of_positions * dimension_);
+    
+    // Get values for weight functions at all points
+    w_val.resize(number_of_positions * number_of_weights);
+    w_grad.resize(number_of_positions * number_of_weights * dimension_);
+    for (int j = 0; j < number_of_weights; ++j)
+    {
+        shared_ptr<Meshless_Function> const func = weights_[cell.weight_indices[j]]->function()->base_function();
+        func->batch_gradient_values(number_of_positions,
+                                    r.data(),
+                                    values.data(),
+                                    gradients.data());
+        for (int q = 0; q < number_of_positions; ++q)
+        {
+            int k = j + number_of_weights * q;
+            w_val[k] = values[q];
+            for (int d = 0; d < dimension_; ++d)
+            {
+                w_grad[d + dimension_ * k] = gradients[q + number_of_positions * d];
+            }
+        }
+    }
+    
+    // Normalize weight functions
+    if (apply_weight_normalization_)
+    {
+        weight_normalization_->batch_gradient_values(positions,
+                                                     weight_centers,
+                                                     w_val,
+                                                     w_grad,
+                                                     w_val,
+                                                     w_grad);
+    }
+    
+    if (options_->identical_basis_functions)
+    {
+        b_val = w_val;
+        b_grad = w_grad;
+    }
+    else
+    {
+        // Get values for basis functions at all points
+        b_val.resize(number_of_positions * number_of_bases);
+        b_grad.resize(number_of_positions * number_of_bases * dimension_);
+        for (int j = 0; j < number_of_bases; ++j)
+        {
+            shared_ptr<Meshless_Function> const func = bases_[cell.basis_indices[j]]->function()->base_function();
+            func->batch_gradient_values(number_of_positions,
+                                        r.data(),
+                                        values.data(),
+                                        gradients.data());
+            for (int q = 0; q < number_of_positions; ++q)
+            {
+                int k = j + number_of_bases * q;
+                b_val[k] = values[q];
+                for (int d = 0; d < dimension_; ++d)
+                {
+                    b_grad[d + dimension_ * k] = gradients[q + number_of_positions * d];
+                }
+            }
+        }
+
+        // Normalize basis functions
+        if (apply_basis_normalization_)
+        {
+            basis_normalization_->batch_gradient_values(positions,
+                                                        basis_centers,
+                                                        b_val,
+                                                        b_grad,
+                                                        b_val,
+                                                        b_grad);
+        }
+    }
+}
+
 void Integration_Mesh::
 get_surface_values(shared_ptr<Integration_Surface> const surface,
                    vector<double> const &position,
@@ -1267,18 +1602,16 @@ get_surface_values(shared_ptr<Integration_Surface> const surface,
 }
 
 void Integration_Mesh::
-get_cell_basis_indices(shared_ptr<Integration_Cell> const cell,
+get_cell_basis_indices(Integration_Cell const &cell,
                        vector<vector<int> > &indices) const
 {
-    indices.assign(cell->number_of_weight_functions,
-                   vector<int>(cell->number_of_basis_functions, -1));
-    for (int i = 0; i < cell->number_of_weight_functions; ++i)
+    indices.resize(cell.number_of_weight_functions);
+    for (int i = 0; i < cell.number_of_weight_functions; ++i)
     {
-        shared_ptr<Weight_Function> const weight = weights_[cell->weight_indices[i]];
-        for (int j = 0; j < cell->number_of_basis_functions; ++j)
-        {
-            indices[i][j] = weight->local_basis_index(cell->basis_indices[j]);
-        }
+        get_local_basis_indices(cell.weight_indices[i],
+                                cell.number_of_basis_functions,
+                                cell.basis_indices.begin(),
+                                indices[i]);
     }
 }
 
@@ -1286,15 +1619,72 @@ void Integration_Mesh::
 get_surface_basis_indices(shared_ptr<Integration_Surface> const surface,
                           vector<vector<int> > &indices) const
 {
-    indices.assign(surface->number_of_weight_functions,
-                   vector<int>(surface->number_of_basis_functions, -1));
+    indices.resize(surface->number_of_weight_functions);
     for (int i = 0; i < surface->number_of_weight_functions; ++i)
     {
-        shared_ptr<Weight_Function> const weight = weights_[surface->weight_indices[i]];
-        for (int j = 0; j < surface->number_of_basis_functions; ++j)
+        get_local_basis_indices(surface->weight_indices[i],
+                                surface->number_of_basis_functions,
+                                surface->basis_indices.data(),
+                                indices[i]);
+    }
+}
+
+void Integration_Mesh::
+initialize_local_basis_indices()
+{
+    // Store the global basis indices of each weight function in sorted
+    // order, along with their local indices
+    weight_basis_offsets_.resize(number_of_points_ + 1);
+    weight_basis_offsets_[0] = 0;
+    for (int i = 0; i < number_of_points_; ++i)
+    {
+        weight_basis_offsets_[i + 1] = weight_basis_offsets_[i] + weights_[i]->number_of_basis_functions();
+    }
+    weight_basis_global_.resize(weight_basis_offsets_[number_of_points_]);
+    weight_basis_local_.resize(weight_basis_offsets_[number_of_points_]);
+    #pragma omp parallel for schedule(dynamic, 64)
+    for (int i = 0; i < number_of_points_; ++i)
+    {
+        vector<int> const &basis_indices = weights_[i]->basis_function_indices();
+        int const number_of_basis_functions = basis_indices.size();
+        vector<pair<int, int> > global_local(number_of_basis_functions);
+        for (int j = 0; j < number_of_basis_functions; ++j)
+        {
+            global_local[j] = {basis_indices[j], j};
+        }
+        sort(global_local.begin(), global_local.end());
+        
+        int const offset = weight_basis_offsets_[i];
+        for (int j = 0; j < number_of_basis_functions; ++j)
+        {
+            weight_basis_global_[offset + j] = global_local[j].first;
+            weight_basis_local_[offset + j] = global_local[j].second;
+        }
+    }
+}
+
+void Integration_Mesh::
+get_local_basis_indices(int weight_index,
+                        int number_of_basis_functions,
+                        int const *basis_indices,
+                        vector<int> &local_indices) const
+{
+    // Both lists of global indices are sorted, so a merge finds the
+    // local index of each basis function
+    int k = weight_basis_offsets_[weight_index];
+    int const k_end = weight_basis_offsets_[weight_index + 1];
+    local_indices.resize(number_of_basis_functions);
+    for (int j = 0; j < number_of_basis_functions; ++j)
+    {
+        int const global_index = basis_indices[j];
+        Check(j == 0 || basis_indices[j - 1] < global_index);
+        while (k < k_end && weight_basis_global_[k] < global_index)
         {
-            indices[i][j] = weight->local_basis_index(surface->basis_indices[j]);
+            ++k;
         }
+        local_indices[j] = (k < k_end && weight_basis_global_[k] == global_index
+                            ? weight_basis_local_[k]
+                            : Weight_Function::Errors::DOES_NOT_EXIST);
     }
 }
 
@@ -1312,27 +1702,27 @@ get_weight_surface_indices(shared_ptr<Integration_Surface> const surface,
 }
 
 void Integration_Mesh::
-get_basis_centers(shared_ptr<Integration_Cell> const cell,
+get_basis_centers(Integration_Cell const &cell,
                   vector<vector<double> > &basis_positions) const
 {
-    int const number_of_basis_functions = cell->number_of_basis_functions;
+    int const number_of_basis_functions = cell.number_of_basis_functions;
     basis_positions.resize(number_of_basis_functions);
     for (int i = 0; i < number_of_basis_functions; ++i)
     {
-        basis_positions[i] = bases_[cell->basis_indices[i]]->position();
+        basis_positions[i] = bases_[cell.basis_indices[i]]->position();
     }
 }
 
 void Integration_Mesh::
-get_basis_weight_centers(shared_ptr<Integration_Cell> const cell,
+get_basis_weight_centers(Integration_Cell const &cell,
                          vector<vector<double> > &basis_positions,
                          vector<vector<double> > &weight_positions) const
 {
-    int const number_of_weight_functions = cell->number_of_weight_functions;
+    int const number_of_weight_functions = cell.number_of_weight_functions;
     weight_positions.resize(number_of_weight_functions);
     for (int i = 0; i < number_of_weight_functions; ++i)
     {
-        weight_positions[i] = weights_[cell->weight_indices[i]]->position();
+        weight_positions[i] = weights_[cell.weight_indices[i]]->position();
     }
 
     if (options_->identical_basis_functions)
@@ -1341,11 +1731,11 @@ get_basis_weight_centers(shared_ptr<Integration_Cell> const cell,
     }
     else
     {
-        int const number_of_basis_functions = cell->number_of_basis_functions;
+        int const number_of_basis_functions = cell.number_of_basis_functions;
         basis_positions.resize(number_of_basis_functions);
         for (int i = 0; i < number_of_basis_functions; ++i)
         {
-            basis_positions[i] = bases_[cell->basis_indices[i]]->position();
+            basis_positions[i] = bases_[cell.basis_indices[i]]->position();
         }
     }
 }
@@ -1384,6 +1774,7 @@ initialize_from_weak_options(std::shared_ptr<Weak_Spatial_Discretization_Options
     adaptive_quadrature = weak_options->adaptive_quadrature;
     minimum_radius_ordinates = weak_options->minimum_radius_ordinates;
     maximum_integration_ordinates = weak_options->maximum_integration_ordinates;
+    quadrature_tolerance = weak_options->quadrature_tolerance;
     integration_ordinates = weak_options->integration_ordinates;
     limits = weak_options->limits;
     dimensional_cells = weak_options->dimensional_cells;
@@ -1401,14 +1792,15 @@ get_total_max_points() const
     int ind_func = 6;
     int ind_maxfunc = 7;
     int ind_minfunc = 8;
+    int ind_unconv = 9;
     
-    vector<int> values(9, 0);
+    vector<int> values(10, 0);
     values[ind_mnv] = 100000000;
     values[ind_mns] = 100000000;
     values[ind_minfunc] = 1000000;
-    for (shared_ptr<Integration_Cell> cell : cells_)
+    for (Integration_Cell const &cell : cells_)
     {
-        int num = pow(cell->number_of_integration_ordinates, dimension_);
+        int num = pow(cell.number_of_integration_ordinates, dimension_);
         values[ind_tv] += num;
         if (num > values[ind_mxv])
         {
@@ -1419,8 +1811,8 @@ get_total_max_points() const
             values[ind_mnv] = num;
         }
 
-        num = cell->number_of_weight_functions;
-        values[ind_func] += cell->number_of_weight_functions;
+        num = cell.number_of_weight_functions;
+        values[ind_func] += cell.number_of_weight_functions;
         if (num > values[ind_maxfunc])
         {
             values[ind_maxfunc] = num;
@@ -1432,6 +1824,7 @@ get_total_max_points() const
         
     }
     values[ind_func] = int(static_cast<double>(values[ind_func]) / static_cast<double>(number_of_cells_));
+    values[ind_unconv] = number_of_unconverged_cells_;
     
     for (shared_ptr<Integration_Surface> surface : surfaces_)
     {
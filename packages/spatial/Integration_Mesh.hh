@@ -17,6 +17,7 @@ struct Integration_Mesh_Options
     int minimum_radius_ordinates = 12;
     int integration_ordinates = 8;
     int maximum_integration_ordinates = 128;
+    double quadrature_tolerance = 0; // if positive, adaptive quadrature is error-controlled
     double boundary_tolerance = 1e-10;
     std::vector<std::vector<double> > limits;
     std::vector<int> dimensional_cells;
@@ -24,6 +25,47 @@ struct Integration_Mesh_Options
     void initialize_from_weak_options(std::shared_ptr<Weak_Spatial_Discretization_Options> weak_options);
 };
 
+// Non-owning view of the function indices for a cell, which are stored
+// contiguously in the Integration_Mesh
+class Integration_Indices
+{
+public:
+    
+    Integration_Indices():
+        data_(nullptr),
+        size_(0)
+    {
+    }
+    Integration_Indices(int const *data,
+                        int size):
+        data_(data),
+        size_(size)
+    {
+    }
+
+    int size() const
+    {
+        return size_;
+    }
+    int operator[](int i) const
+    {
+        return data_[i];
+    }
+    int const *begin() const
+    {
+        return data_;
+    }
+    int const *end() const
+    {
+        return data_ + size_;
+    }
+    
+private:
+    
+    int const *data_;
+    int size_;
+};
+
 // Cartesian cell
 struct Integration_Cell
 {
@@ -36,13 +78,25 @@ struct Integration_Cell
     // Intersections
     int number_of_basis_functions;
     int number_of_weight_functions;
-    std::vector<int> basis_indices;
-    std::vector<int> weight_indices;
+    Integration_Indices basis_indices;
+    Integration_Indices weight_indices;
 
     // Integration
     int number_of_integration_ordinates;
 };
 
+// Quadrature and basis/weight values for a cell, stored as in the batch
+// Integration_Mesh::get_volume_values
+struct Integration_Cell_Values
+{
+    std::vector<std::vector<double> > ordinates;
+    std::vector<double> weights;
+    std::vector<double> b_val;
+    std::vector<double> b_grad;
+    std::vector<double> w_val;
+    std::vector<double> w_grad;
+};
+
 // Single point in the mesh
 struct Integration_Node
 {
@@ -84,6 +138,11 @@ public:
                      std::vector<std::shared_ptr<Basis_Function> > const &bases,
                      std::vector<std::shared_ptr<Weight_Function> > const &weights);
 
+    // The cells hold views into the index arrays of this mesh, which would
+    // dangle in a copy
+    Integration_Mesh(Integration_Mesh const &) = delete;
+    Integration_Mesh &operator=(Integration_Mesh const &) = delete;
+
     // Access data
     int dimension() const
     {
@@ -105,7 +164,7 @@ public:
     {
         return number_of_nodes_;
     }
-    std::shared_ptr<Integration_Cell> const cell(int index) const
+    Integration_Cell const &cell(int index) const
     {
         return cells_[index];
     }
@@ -113,7 +172,7 @@ public:
     {
         return surfaces_[index];
     }
-    std::shared_ptr<Integration_Node> const node(int index) const
+    Integration_Node const &node(int index) const
     {
         return nodes_[index];
     }
@@ -128,12 +187,33 @@ public:
                                 std::vector<std::vector<double> > &ordinates,
                                 std::vector<double> &weights) const;
 
+    // Get the quadrature and the values at the quadrature points of a cell;
+    // for error-controlled adaptive quadrature, the first call for each cell
+    // increases the number of ordinates until the integrals converge
+    void get_volume_values(int i, // cell index
+                           std::vector<std::vector<double> > const &basis_centers,
+                           std::vector<std::vector<double> > const &weight_centers,
+                           std::vector<std::vector<int> > const &weight_basis_indices,
+                           Integration_Cell_Values &values);
+
+    // Use the quadrature of a translated template cell that was already
+    // integrated, so the copied cells need not be refined themselves
+    void copy_volume_quadrature(int i, // cell index
+                                int template_index);
+
+    // Number of cells whose quadrature reached the maximum number of
+    // ordinates without converging
+    int number_of_unconverged_cells() const
+    {
+        return number_of_unconverged_cells_;
+    }
+
     // Get values at a single specified point
-    void get_basis_values(std::shared_ptr<Integration_Cell> const cell,
+    void get_basis_values(Integration_Cell const &cell,
                           std::vector<double> const &position,
                           std::vector<std::vector<double> > const &basis_centers,
                           std::vector<double> &b_val) const;
-    void get_volume_values(std::shared_ptr<Integration_Cell> const cell,
+    void get_volume_values(Integration_Cell const &cell,
                            std::vector<double> const &position,
                            std::vector<std::vector<double> > const &basis_centers,
                            std::vector<std::vector<double> > const &weight_centers,
@@ -141,6 +221,18 @@ public:
                            std::vector<std::vector<double> > &b_grad,
                            std::vector<double> &w_val,
                            std::vector<std::vector<double> > &w_grad) const;
+
+    // Get values at all specified points of a cell at once, stored as
+    // val[i + number_of_functions * q] and
+    // grad[d + dimension * (i + number_of_functions * q)]
+    void get_volume_values(Integration_Cell const &cell,
+                           std::vector<std::vector<double> > const &positions,
+                           std::vector<std::vector<double> > const &basis_centers,
+                           std::vector<std::vector<double> > const &weight_centers,
+                           std::vector<double> &b_val,
+                           std::vector<double> &b_grad,
+                           std::vector<double> &w_val,
+                           std::vector<double> &w_grad) const;
     void get_surface_values(std::shared_ptr<Integration_Surface> const surface,
                             std::vector<double> const &position,
                             std::vector<std::vector<double> > const &basis_centers,
@@ -149,7 +241,7 @@ public:
                             std::vector<double> &w_val) const;
     
     // Indexing methods
-    void get_cell_basis_indices(std::shared_ptr<Integration_Cell> const cell,
+    void get_cell_basis_indices(Integration_Cell const &cell,
                                  std::vector<std::vector<int> > &basis_indices) const;
     void get_surface_basis_indices(std::shared_ptr<Integration_Surface> const surface,
                                    std::vector<std::vector<int> > &basis_indices) const;
@@ -157,9 +249,9 @@ public:
                                     std::vector<int> &surface_indices) const;
 
     // Get the positions of the centers basis/weight functions
-    void get_basis_centers(std::shared_ptr<Integration_Cell> const cell,
+    void get_basis_centers(Integration_Cell const &cell,
                            std::vector<std::vector<double> > &basis_positions) const;
-    void get_basis_weight_centers(std::shared_ptr<Integration_Cell> const cell,
+    void get_basis_weight_centers(Integration_Cell const &cell,
                                   std::vector<std::vector<double> > &basis_positions,
                                   std::vector<std::vector<double> > &weight_positions) const;
     void get_basis_weight_centers(std::shared_ptr<Integration_Surface> const surface,
@@ -177,8 +269,53 @@ private:
     // Initialization methods
     void initialize_mesh();
     void initialize_connectivity();
+    void initialize_local_basis_indices();
     double get_inclusive_radius(double radius) const;
 
+    // Get the local index within a weight function of each basis function
+    // in a sorted list of global basis indices
+    void get_local_basis_indices(int weight_index,
+                                 int number_of_basis_functions,
+                                 int const *basis_indices,
+                                 std::vector<int> &local_indices) const;
+    
+    // Get the sorted cells and surfaces that intersect a function
+    void get_intersections(double radius,
+                           std::vector<double> const &position,
+                           std::vector<int> &cells,
+                           std::vector<int> &surfaces) const;
+
+    // Invert the entities for each function into compressed lists of the
+    // sorted functions for each entity
+    void get_adjacency(int number_of_entities,
+                       std::vector<std::vector<int> > const &function_entities,
+                       std::vector<int> &offsets,
+                       std::vector<int> &indices) const;
+
+    // Quadrature for a cell with a given number of ordinates per dimension
+    void get_cell_quadrature(Integration_Cell const &cell,
+                             int number_of_integration_ordinates,
+                             std::vector<std::vector<double> > &ordinates,
+                             std::vector<double> &weights) const;
+
+    // Increase the number of ordinates of a cell until the integrals from
+    // two successive orders agree, keeping the values of the finer order
+    void refine_volume_values(int i, // cell index
+                              std::vector<std::vector<double> > const &basis_centers,
+                              std::vector<std::vector<double> > const &weight_centers,
+                              std::vector<std::vector<int> > const &weight_basis_indices,
+                              Integration_Cell_Values &values);
+
+    // Integrals of the weight functions and basis/weight products in a
+    // cell, used to estimate the quadrature error, and the values used
+    void get_error_integrals(Integration_Cell const &cell,
+                             int number_of_integration_ordinates,
+                             std::vector<std::vector<double> > const &basis_centers,
+                             std::vector<std::vector<double> > const &weight_centers,
+                             std::vector<std::vector<int> > const &weight_basis_indices,
+                             Integration_Cell_Values &values,
+                             std::vector<double> &integrals) const;
+
     // Input data
     int dimension_;
     int number_of_points_;
@@ -190,6 +327,7 @@ private:
     int number_of_nodes_;
     int number_of_cells_;
     int number_of_surfaces_;
+    int number_of_unconverged_cells_;
     bool apply_basis_normalization_;
     bool apply_weight_normalization_;
     double max_interval_;
@@ -198,8 +336,16 @@ private:
     std::shared_ptr<KD_Tree> node_tree_;
     std::shared_ptr<Meshless_Normalization> basis_normalization_;
     std::shared_ptr<Meshless_Normalization> weight_normalization_;
-    std::vector<std::shared_ptr<Integration_Cell> > cells_;
-    std::vector<std::shared_ptr<Integration_Node> > nodes_;
+    std::vector<int> weight_basis_offsets_;
+    std::vector<int> weight_basis_global_; // sorted global basis indices for each weight
+    std::vector<int> weight_basis_local_; // corresponding local basis indices
+    std::vector<int> cell_weight_offsets_;
+    std::vector<int> cell_weight_indices_;
+    std::vector<int> cell_basis_offsets_;
+    std::vector<int> cell_basis_indices_;
+    std::vector<Integration_Cell> cells_;
+    std::vector<int> cell_refined_; // 0: not refined, 1: converged, 2: unconverged
+    std::vector<Integration_Node> nodes_;
     std::vector<std::shared_ptr<Integration_Surface> > surfaces_;
 };
 
@@ -135,6 +135,17 @@ laplacian_value(vector<double> const &r) const
     return res;
 }
 
+string Legendre_Function::
+description() const
+{
+    string desc = "legendre";
+    for (int order : order_)
+    {
+        desc += "_" + to_string(order);
+    }
+    return desc;
+}
+
 void Legendre_Function::
 output(XML_Node output_node) const
 {
@@ -47,6 +47,7 @@ public:
                             std::vector<double> const &r) const override;
     virtual std::vector<double> gradient_value(std::vector<double> const &r) const override;
     virtual double laplacian_value(std::vector<double> const &r) const override;
+    virtual std::string description() const override;
     virtual void output(XML_Node output_node) const override;
     virtual void check_class_invariants() const override;
     
@@ -12,6 +12,7 @@ namespace vf = Vector_Functions;
 
 using std::make_shared;
 using std::shared_ptr;
+using std::string;
 using std::vector;
 
 Linear_MLS_Function::
@@ -251,6 +252,12 @@ gradient_values(vector<double> const &position,
                                         grad_vals);
 }
 
+string Linear_MLS_Function::
+description() const
+{
+    return "linear_mls_" + function_->description();
+}
+
 void Linear_MLS_Function::
 output(XML_Node output_node) const
 {
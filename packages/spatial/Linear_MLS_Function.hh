@@ -65,6 +65,7 @@ public:
         return function_;
     }
     virtual std::shared_ptr<Meshless_Normalization> normalization() const override;
+    virtual std::string description() const override;
     virtual void output(XML_Node output_node) const override;
     virtual void check_class_invariants() const override;
 
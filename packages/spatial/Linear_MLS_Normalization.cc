@@ -1,14 +1,43 @@
 #include "Linear_MLS_Normalization.hh"
 
-#include "Linear_Algebra.hh"
-#include "Matrix_Functions.hh"
-#include "Vector_Functions.hh"
+#include "Check.hh"
+#include "MLS_Kernel.hh"
 
-namespace la = Linear_Algebra;
-namespace mf = Matrix_Functions;
-namespace vf = Vector_Functions;
 using std::vector;
 
+namespace // anonymous
+{
+    // Linear polynomials 1, x, y, z
+    template<int dimension_>
+    struct Linear_Polynomial
+    {
+        template<class Vector>
+        static void polynomial(double const *position,
+                               Vector &poly)
+        {
+            poly(0) = 1.;
+            for (int d = 0; d < dimension_; ++d)
+            {
+                poly(d + 1) = position[d];
+            }
+        }
+        
+        template<class Gradient>
+        static void grad_polynomial(double const *position,
+                                    Gradient &grad_poly)
+        {
+            grad_poly.setZero();
+            for (int d = 0; d < dimension_; ++d)
+            {
+                grad_poly(d + 1, d) = 1.;
+            }
+        }
+    };
+
+    template<int dimension_>
+    using Linear_Kernel = MLS_Kernel<dimension_, dimension_ + 1, Linear_Polynomial<dimension_> >;
+} // namespace
+
 Linear_MLS_Normalization::
 Linear_MLS_Normalization(int dimension):
     dimension_(dimension),
@@ -47,71 +76,30 @@ get_values(vector<double> const &position,
            vector<double> const &base_values,
            vector<double> &values) const
 {
-    // Get size information
-    int number_of_functions = base_values.size();
-    Check(position.size() == dimension_);
-    Check(center_positions.size() == number_of_functions);
-
-    // Resize but don't assign in case base_values and values are the same
-    values.resize(number_of_functions);
-    
-    // Get polynomial value at evaluation position
-    vector<double> p_position(number_of_polynomials_);
-    get_polynomial(position,
-                   p_position);
-
-    // Get polynomial values at centers
-    vector<vector<double> > p_center(number_of_functions, vector<double>(number_of_polynomials_));
-    for (int i = 0; i < number_of_functions; ++i)
+    switch (dimension_)
     {
-        get_polynomial(center_positions[i],
-                       p_center[i]);
+    case 1:
+        Linear_Kernel<1>::get_values(position,
+                                     center_positions,
+                                     base_values,
+                                     values);
+        break;
+    case 2:
+        Linear_Kernel<2>::get_values(position,
+                                     center_positions,
+                                     base_values,
+                                     values);
+        break;
+    case 3:
+        Linear_Kernel<3>::get_values(position,
+                                     center_positions,
+                                     base_values,
+                                     values);
+        break;
+    default:
+        AssertMsg(false, "dimension not found");
     }
-    
-    // Get A matrix
-    vector<double> a_mat(number_of_polynomials_ * number_of_polynomials_);
-    for (int i = 0; i < number_of_functions; ++i)
-    {
-        double const weight = base_values[i];
-        vector<double> const &poly = p_center[i];
-        for (int j = 0; j < number_of_polynomials_; ++j)
-        {
-            for (int k = 0; k < number_of_polynomials_; ++k)
-            {
-                int l = j + number_of_polynomials_ * k;
-                a_mat[l] += weight * poly[j] * poly[k];
-            }
-        }
-    }
-    
-    // Get inverse of A
-    vector<double> a_inv_mat(number_of_polynomials_ * number_of_polynomials_);
-    la::direct_inverse(a_mat,
-                       a_inv_mat);
-    
-    // Get values of basis function
-    for (int i = 0; i < number_of_functions; ++i)
-    {
-        // Get B vector
-        vector<double> b_vec(number_of_polynomials_);
-        {
-            double const weight = base_values[i];
-            vector<double> const &poly = p_center[i];
-            for (int j = 0; j < number_of_polynomials_; ++j)
-            {
-                b_vec[j] = weight * poly[j];
-            }
-        }
-
-        // Get value of function
-        values[i] = vf::dot(p_position,
-                            mf::square_matrix_vector_product(number_of_polynomials_,
-                                                             a_inv_mat,
-                                                             b_vec));
-    }
-    
 }
-           
 
 void Linear_MLS_Normalization::
 get_gradient_values(vector<double> const &position,
@@ -121,132 +109,72 @@ get_gradient_values(vector<double> const &position,
                     vector<double> &values,
                     vector<vector<double> > &gradient_values) const
 {
-    // Get size information
-    int number_of_functions = base_values.size();
-    Check(position.size() == dimension_);
-    Check(center_positions.size() == number_of_functions);
-    Check(grad_base_values.size() == number_of_functions);
-
-    // Resize but don't assign in case values and base values are the same
-    values.resize(number_of_functions);
-    gradient_values.resize(number_of_functions);
-    for (int i = 0; i < number_of_functions; ++i)
+    switch (dimension_)
     {
-        gradient_values[i].resize(dimension_);
+    case 1:
+        Linear_Kernel<1>::get_gradient_values(position,
+                                              center_positions,
+                                              base_values,
+                                              grad_base_values,
+                                              values,
+                                              gradient_values);
+        break;
+    case 2:
+        Linear_Kernel<2>::get_gradient_values(position,
+                                              center_positions,
+                                              base_values,
+                                              grad_base_values,
+                                              values,
+                                              gradient_values);
+        break;
+    case 3:
+        Linear_Kernel<3>::get_gradient_values(position,
+                                              center_positions,
+                                              base_values,
+                                              grad_base_values,
+                                              values,
+                                              gradient_values);
+        break;
+    default:
+        AssertMsg(false, "dimension not found");
     }
+}
 
-    // Get polynomial value at evaluation position
-    vector<double> p_position(number_of_polynomials_);
-    get_polynomial(position,
-                   p_position);
-    vector<vector<double> > grad_p_position(dimension_,
-                                            vector<double>(number_of_polynomials_));
-    get_grad_polynomial(position,
-                        grad_p_position);
-
-    
-    // Get polynomial values at centers
-    vector<vector<double> > p_center(number_of_functions, vector<double>(number_of_polynomials_));
-    for (int i = 0; i < number_of_functions; ++i)
-    {
-        get_polynomial(center_positions[i],
-                       p_center[i]);
-    }
-    
-    // Get A matrix
-    vector<double> a_mat(number_of_polynomials_ * number_of_polynomials_);
-    vector<vector<double> > grad_a_mat(dimension_,
-                                       vector<double>(number_of_polynomials_ * number_of_polynomials_));
-    for (int i = 0; i < number_of_functions; ++i)
-    {
-        double const weight = base_values[i];
-        vector<double> const &poly = p_center[i];
-        for (int j = 0; j < number_of_polynomials_; ++j)
-        {
-            for (int k = 0; k < number_of_polynomials_; ++k)
-            {
-                int l = j + number_of_polynomials_ * k;
-                a_mat[l] += weight * poly[j] * poly[k];
-            }
-        }
-
-        for (int d = 0; d < dimension_; ++d)
-        {
-            double const d_weight = grad_base_values[i][d];
-            for (int j = 0; j < number_of_polynomials_; ++j)
-            {
-                for (int k = 0; k < number_of_polynomials_; ++k)
-                {
-                    int l = j + number_of_polynomials_ * k;
-                    grad_a_mat[d][l] += d_weight * poly[j] * poly[k];
-                }
-            }
-        }
-    }
-    
-    // Get inverse of A
-    vector<double> a_inv_mat(number_of_polynomials_ * number_of_polynomials_);
-    la::direct_inverse(a_mat,
-                       a_inv_mat);
-    vector<vector<double> > grad_a_inv_mat(dimension_,
-                                           vector<double>(number_of_polynomials_ * number_of_polynomials_));
-    for (int d = 0; d < dimension_; ++d)
+void Linear_MLS_Normalization::
+batch_gradient_values(vector<vector<double> > const &positions,
+                      vector<vector<double> > const &center_positions,
+                      vector<double> const &base_values,
+                      vector<double> const &grad_base_values,
+                      vector<double> &values,
+                      vector<double> &gradient_values) const
+{
+    switch (dimension_)
     {
-        vector<double> &mat = grad_a_inv_mat[d];
-        mat = mf::square_matrix_matrix_product(number_of_polynomials_,
-                                               grad_a_mat[d],
-                                               a_inv_mat);
-        mat = mf::square_matrix_matrix_product(number_of_polynomials_,
-                                               a_inv_mat,
-                                               mat);
-        mat = vf::multiply(mat,
-                           -1.);
+    case 1:
+        Linear_Kernel<1>::batch_gradient_values(positions,
+                                                center_positions,
+                                                base_values,
+                                                grad_base_values,
+                                                values,
+                                                gradient_values);
+        break;
+    case 2:
+        Linear_Kernel<2>::batch_gradient_values(positions,
+                                                center_positions,
+                                                base_values,
+                                                grad_base_values,
+                                                values,
+                                                gradient_values);
+        break;
+    case 3:
+        Linear_Kernel<3>::batch_gradient_values(positions,
+                                                center_positions,
+                                                base_values,
+                                                grad_base_values,
+                                                values,
+                                                gradient_values);
+        break;
+    default:
+        AssertMsg(false, "dimension not found");
     }
-    
-    // Get values of basis function
-    for (int i = 0; i < number_of_functions; ++i)
-    {
-        // Get B vector
-        vector<double> b_vec(number_of_polynomials_);
-        double const weight = base_values[i];
-        vector<double> const &poly = p_center[i];
-        for (int j = 0; j < number_of_polynomials_; ++j)
-        {
-            b_vec[j] = weight * poly[j];
-        }
-        
-        // Get value of function
-        values[i] = vf::dot(p_position,
-                            mf::square_matrix_vector_product(number_of_polynomials_,
-                                                             a_inv_mat,
-                                                             b_vec));
-
-        for (int d = 0; d < dimension_; ++d)
-        {
-            // Get d_B vector
-            vector<double> d_b_vec(number_of_polynomials_);
-            double const d_weight = grad_base_values[i][d];
-
-            for (int j = 0; j < number_of_polynomials_; ++j)
-            {
-                d_b_vec[j] = d_weight * poly[j];
-            }
-            
-            // Get gradient values of function
-
-            double t1 = vf::dot(grad_p_position[d],
-                                mf::square_matrix_vector_product(number_of_polynomials_,
-                                                                 a_inv_mat,
-                                                                 b_vec));
-            double t2 = vf::dot(p_position,
-                                mf::square_matrix_vector_product(number_of_polynomials_,
-                                                                 grad_a_inv_mat[d],
-                                                                 b_vec));
-            double t3 = vf::dot(p_position,
-                                mf::square_matrix_vector_product(number_of_polynomials_,
-                                                                 a_inv_mat,
-                                                                 d_b_vec));
-            gradient_values[i][d] = t1 + t2 + t3;
-        }
-    }
-}    
+}
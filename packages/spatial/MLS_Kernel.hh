@@ -0,0 +1,250 @@
+#ifndef MLS_Kernel_hh
+#define MLS_Kernel_hh
+
+#include <vector>
+
+#include <Eigen/Dense>
+#include <Eigen/StdVector>
+
+#include "Check.hh"
+
+/*
+  Fixed-size moving least squares normalization
+
+  The Polynomial class provides the static methods
+    polynomial(position, poly): poly(j) is polynomial j at position
+    grad_polynomial(position, grad_poly): grad_poly(j, d) is the derivative
+      of polynomial j in dimension d at position
+
+  The moment matrix and its derivatives are fixed-size, so apart from the
+  center polynomials (computed once per call) nothing is allocated in the
+  batch interface, which works on flat arrays.
+  Because the moment matrix A is symmetric, the normalized value
+  p^T A^-1 w_i p_i is computed as w_i c^T p_i with c = A^-1 p, and the
+  gradient as w_i e_d^T p_i + dw_i c^T p_i with e_d = A^-1 (dp - dA c).
+  As in Meshless_Normalization, the values may be the same vectors as the
+  base values.
+*/
+template<int dimension_, int number_of_polynomials_, class Polynomial>
+class MLS_Kernel
+{
+public:
+
+    typedef Eigen::Matrix<double, number_of_polynomials_, 1> Vector;
+    typedef Eigen::Matrix<double, number_of_polynomials_, number_of_polynomials_> Matrix;
+    typedef Eigen::Matrix<double, number_of_polynomials_, dimension_> Gradient;
+    typedef std::vector<Vector, Eigen::aligned_allocator<Vector> > Vector_Set;
+
+    // Normalized values at a single position
+    static void get_values(std::vector<double> const &position,
+                           std::vector<std::vector<double> > const &center_positions,
+                           std::vector<double> const &base_values,
+                           std::vector<double> &values)
+    {
+        Vector_Set p_center;
+        get_center_polynomials(center_positions,
+                               p_center);
+        get_values(position,
+                   p_center,
+                   base_values,
+                   values);
+    }
+
+    // Normalized values and gradients at a single position
+    static void get_gradient_values(std::vector<double> const &position,
+                                    std::vector<std::vector<double> > const &center_positions,
+                                    std::vector<double> const &base_values,
+                                    std::vector<std::vector<double> > const &grad_base_values,
+                                    std::vector<double> &values,
+                                    std::vector<std::vector<double> > &gradient_values)
+    {
+        Vector_Set p_center;
+        get_center_polynomials(center_positions,
+                               p_center);
+        get_gradient_values(position,
+                            p_center,
+                            base_values,
+                            grad_base_values,
+                            values,
+                            gradient_values);
+    }
+
+    // Normalized values and gradients at several positions with the same
+    // centers, stored as in Meshless_Normalization::batch_gradient_values
+    static void batch_gradient_values(std::vector<std::vector<double> > const &positions,
+                                      std::vector<std::vector<double> > const &center_positions,
+                                      std::vector<double> const &base_values,
+                                      std::vector<double> const &grad_base_values,
+                                      std::vector<double> &values,
+                                      std::vector<double> &gradient_values)
+    {
+        int number_of_positions = positions.size();
+        int number_of_functions = center_positions.size();
+        int size = number_of_positions * number_of_functions;
+        Check(base_values.size() == size);
+        Check(grad_base_values.size() == size * dimension_);
+
+        Vector_Set p_center;
+        get_center_polynomials(center_positions,
+                               p_center);
+        values.resize(size);
+        gradient_values.resize(size * dimension_);
+        for (int q = 0; q < number_of_positions; ++q)
+        {
+            Check(positions[q].size() == dimension_);
+            int k = number_of_functions * q;
+            get_gradient_values(&positions[q][0],
+                                p_center,
+                                &base_values[k],
+                                &grad_base_values[dimension_ * k],
+                                &values[k],
+                                &gradient_values[dimension_ * k]);
+        }
+    }
+
+private:
+
+    static void get_center_polynomials(std::vector<std::vector<double> > const &center_positions,
+                                       Vector_Set &p_center)
+    {
+        int number_of_functions = center_positions.size();
+        p_center.resize(number_of_functions);
+        for (int i = 0; i < number_of_functions; ++i)
+        {
+            Check(center_positions[i].size() == dimension_);
+            Polynomial::polynomial(&center_positions[i][0],
+                                   p_center[i]);
+        }
+    }
+
+    static void get_values(std::vector<double> const &position,
+                           Vector_Set const &p_center,
+                           std::vector<double> const &base_values,
+                           std::vector<double> &values)
+    {
+        int number_of_functions = base_values.size();
+        Check(position.size() == dimension_);
+        Check(p_center.size() == number_of_functions);
+
+        // Get A matrix
+        Matrix a_mat = Matrix::Zero();
+        for (int i = 0; i < number_of_functions; ++i)
+        {
+            a_mat.noalias() += base_values[i] * p_center[i] * p_center[i].transpose();
+        }
+
+        // Get c = A^-1 p
+        Vector p_position;
+        Polynomial::polynomial(&position[0],
+                               p_position);
+        Vector const c = a_mat.inverse() * p_position;
+
+        // Get values of basis functions
+        values.resize(number_of_functions);
+        for (int i = 0; i < number_of_functions; ++i)
+        {
+            values[i] = base_values[i] * c.dot(p_center[i]);
+        }
+    }
+
+    static void get_gradient_values(std::vector<double> const &position,
+                                    Vector_Set const &p_center,
+                                    std::vector<double> const &base_values,
+                                    std::vector<std::vector<double> > const &grad_base_values,
+                                    std::vector<double> &values,
+                                    std::vector<std::vector<double> > &gradient_values)
+    {
+        int number_of_functions = base_values.size();
+        Check(position.size() == dimension_);
+        Check(grad_base_values.size() == number_of_functions);
+
+        // Pack the gradients by function, then dimension
+        std::vector<double> grad_base(number_of_functions * dimension_);
+        for (int i = 0; i < number_of_functions; ++i)
+        {
+            for (int d = 0; d < dimension_; ++d)
+            {
+                grad_base[d + dimension_ * i] = grad_base_values[i][d];
+            }
+        }
+        std::vector<double> gradients(number_of_functions * dimension_);
+        values.resize(number_of_functions);
+        get_gradient_values(&position[0],
+                            p_center,
+                            &base_values[0],
+                            &grad_base[0],
+                            &values[0],
+                            &gradients[0]);
+        gradient_values.resize(number_of_functions);
+        for (int i = 0; i < number_of_functions; ++i)
+        {
+            gradient_values[i].assign(&gradients[dimension_ * i],
+                                      &gradients[dimension_ * (i + 1)]);
+        }
+    }
+
+    // Gradients are indexed by function, then dimension
+    static void get_gradient_values(double const *position,
+                                    Vector_Set const &p_center,
+                                    double const *base_values,
+                                    double const *grad_base_values,
+                                    double *values,
+                                    double *gradient_values)
+    {
+        int number_of_functions = p_center.size();
+
+        // Get A matrix and its derivatives
+        Matrix a_mat = Matrix::Zero();
+        Matrix grad_a_mat[dimension_];
+        for (int d = 0; d < dimension_; ++d)
+        {
+            grad_a_mat[d].setZero();
+        }
+        for (int i = 0; i < number_of_functions; ++i)
+        {
+            Matrix const pp = p_center[i] * p_center[i].transpose();
+            a_mat.noalias() += base_values[i] * pp;
+            for (int d = 0; d < dimension_; ++d)
+            {
+                grad_a_mat[d].noalias() += grad_base_values[d + dimension_ * i] * pp;
+            }
+        }
+        Matrix const a_inv_mat = a_mat.inverse();
+
+        // Get c = A^-1 p and e_d = A^-1 (dp_d - dA_d c)
+        Vector p_position;
+        Gradient grad_p_position;
+        Polynomial::polynomial(position,
+                               p_position);
+        Polynomial::grad_polynomial(position,
+                                    grad_p_position);
+        Vector const c = a_inv_mat * p_position;
+        Gradient e;
+        for (int d = 0; d < dimension_; ++d)
+        {
+            e.col(d).noalias() = a_inv_mat * (grad_p_position.col(d) - grad_a_mat[d] * c);
+        }
+
+        // Get values of basis functions, reading the base values for each
+        // function before writing in case the arrays are the same
+        for (int i = 0; i < number_of_functions; ++i)
+        {
+            double const weight = base_values[i];
+            double d_weight[dimension_];
+            for (int d = 0; d < dimension_; ++d)
+            {
+                d_weight[d] = grad_base_values[d + dimension_ * i];
+            }
+
+            Vector const &poly = p_center[i];
+            double const c_poly = c.dot(poly);
+            values[i] = weight * c_poly;
+            for (int d = 0; d < dimension_; ++d)
+            {
+                gradient_values[d + dimension_ * i] = weight * e.col(d).dot(poly) + d_weight[d] * c_poly;
+            }
+        }
+    }
+};
+
+#endif
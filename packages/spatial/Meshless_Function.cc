@@ -20,6 +20,51 @@ inside_radius(vector<double> const &r) const
     return dist2 < radius() * radius();
 }
 
+void Meshless_Function::
+batch_values(int number_of_points,
+             double const *r,
+             double *values) const
+{
+    // Reuse the position across points and calls
+    int dim = dimension();
+    thread_local vector<double> position;
+    position.resize(dim);
+    for (int i = 0; i < number_of_points; ++i)
+    {
+        for (int d = 0; d < dim; ++d)
+        {
+            position[d] = r[i + number_of_points * d];
+        }
+        values[i] = value(position);
+    }
+}
+
+void Meshless_Function::
+batch_gradient_values(int number_of_points,
+                      double const *r,
+                      double *values,
+                      double *gradients) const
+{
+    // Get the derivatives one at a time to avoid allocating a gradient for
+    // each point
+    int dim = dimension();
+    thread_local vector<double> position;
+    position.resize(dim);
+    for (int i = 0; i < number_of_points; ++i)
+    {
+        for (int d = 0; d < dim; ++d)
+        {
+            position[d] = r[i + number_of_points * d];
+        }
+        values[i] = value(position);
+        for (int d = 0; d < dim; ++d)
+        {
+            gradients[i + number_of_points * d] = d_value(d,
+                                                          position);
+        }
+    }
+}
+
 void Meshless_Function::
 values(vector<double> const &r,
        vector<int> &indices,
@@ -2,6 +2,7 @@
 #define Meshless_Function_hh
 
 #include <memory>
+#include <string>
 #include <vector>
 
 class Meshless_Normalization;
@@ -40,6 +41,17 @@ public:
     virtual std::vector<double> gradient_value(std::vector<double> const &r) const = 0;
     virtual double laplacian_value(std::vector<double> const &r) const = 0;
 
+    // Values and gradients of this function at several points at once, with
+    // coordinate d of point i at r[i + number_of_points * d] (gradients use
+    // the same layout)
+    virtual void batch_values(int number_of_points,
+                              double const *r,
+                              double *values) const;
+    virtual void batch_gradient_values(int number_of_points,
+                                       double const *r,
+                                       double *values,
+                                       double *gradients) const;
+
     // Values and derivatives of all the meshless functions (including neighbors): disabled if !depends_on_neighbors
     virtual void values(std::vector<double> const &r,
                         std::vector<int> &indices,
@@ -59,6 +71,7 @@ public:
     virtual std::shared_ptr<Meshless_Normalization> normalization() const;
     
     // Input checking and output methods
+    virtual std::string description() const = 0;
     virtual void output(XML_Node output_node) const = 0;
     virtual void check_class_invariants() const = 0;
 
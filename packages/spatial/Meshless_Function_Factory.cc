@@ -1,7 +1,10 @@
 #include "Meshless_Function_Factory.hh"
 
+#include <algorithm>
 #include <cmath>
+#include <cstdint>
 #include <iostream>
+#include <limits>
 #include <numeric>
 
 #include "Cartesian_Distance.hh"
@@ -97,6 +100,173 @@ get_cartesian_points(int dimension,
     }
 }
 
+void Meshless_Function_Factory::
+get_morton_ordering(int dimension,
+                    int number_of_points,
+                    vector<vector<double> > const &points,
+                    vector<int> &order) const
+{
+    Assert(dimension >= 1 && dimension <= 3);
+    
+    // Get bounding box of points
+    vector<double> lower(dimension, numeric_limits<double>::max());
+    vector<double> upper(dimension, -numeric_limits<double>::max());
+    for (int i = 0; i < number_of_points; ++i)
+    {
+        for (int d = 0; d < dimension; ++d)
+        {
+            lower[d] = min(lower[d], points[i][d]);
+            upper[d] = max(upper[d], points[i][d]);
+        }
+    }
+    
+    // Interleave the bits of the integer coordinates of each point
+    int const number_of_bits = 63 / dimension;
+    double const max_coordinate = static_cast<double>((uint64_t(1) << number_of_bits) - 1);
+    vector<uint64_t> codes(number_of_points, 0);
+    for (int i = 0; i < number_of_points; ++i)
+    {
+        for (int d = 0; d < dimension; ++d)
+        {
+            double length = upper[d] - lower[d];
+            double fraction = length > 0 ? (points[i][d] - lower[d]) / length : 0;
+            uint64_t coordinate = static_cast<uint64_t>(fraction * max_coordinate);
+            for (int b = 0; b < number_of_bits; ++b)
+            {
+                codes[i] |= ((coordinate >> b) & uint64_t(1)) << (d + dimension * b);
+            }
+        }
+    }
+    
+    // Sort points by code
+    order.resize(number_of_points);
+    iota(order.begin(), order.end(), 0);
+    stable_sort(order.begin(), order.end(),
+                [&codes](int i1, int i2)
+                {
+                    return codes[i1] < codes[i2];
+                });
+}
+
+void Meshless_Function_Factory::
+get_rcm_ordering(shared_ptr<KD_Tree> kd_tree,
+                 int dimension,
+                 int number_of_points,
+                 int number_of_neighbors,
+                 vector<vector<double> > const &points,
+                 vector<int> &order) const
+{
+    // Get symmetric nearest neighbor graph
+    int local_number_of_neighbors = min(number_of_neighbors, number_of_points);
+    vector<vector<int> > graph(number_of_points);
+    for (int i = 0; i < number_of_points; ++i)
+    {
+        vector<int> indices;
+        vector<double> squared_distances;
+        kd_tree->find_neighbors(local_number_of_neighbors,
+                                points[i],
+                                indices,
+                                squared_distances);
+        for (int j : indices)
+        {
+            if (j != i)
+            {
+                graph[i].push_back(j);
+                graph[j].push_back(i);
+            }
+        }
+    }
+    vector<int> degree(number_of_points);
+    for (int i = 0; i < number_of_points; ++i)
+    {
+        sort(graph[i].begin(), graph[i].end());
+        graph[i].erase(unique(graph[i].begin(), graph[i].end()), graph[i].end());
+        degree[i] = graph[i].size();
+    }
+    
+    // Get starting points for each connected component in order of degree
+    vector<int> starts(number_of_points);
+    iota(starts.begin(), starts.end(), 0);
+    stable_sort(starts.begin(), starts.end(),
+                [&degree](int i1, int i2)
+                {
+                    return degree[i1] < degree[i2];
+                });
+    
+    // Perform breadth-first search, visiting neighbors in order of degree
+    order.clear();
+    order.reserve(number_of_points);
+    vector<bool> visited(number_of_points, false);
+    for (int start : starts)
+    {
+        if (visited[start])
+        {
+            continue;
+        }
+        visited[start] = true;
+        order.push_back(start);
+        for (int k = order.size() - 1; k < order.size(); ++k)
+        {
+            int i = order[k];
+            vector<int> next;
+            for (int j : graph[i])
+            {
+                if (!visited[j])
+                {
+                    visited[j] = true;
+                    next.push_back(j);
+                }
+            }
+            stable_sort(next.begin(), next.end(),
+                        [&degree](int i1, int i2)
+                        {
+                            return degree[i1] < degree[i2];
+                        });
+            order.insert(order.end(), next.begin(), next.end());
+        }
+    }
+    Assert(static_cast<int>(order.size()) == number_of_points);
+    
+    // Reverse the Cuthill-McKee order
+    reverse(order.begin(), order.end());
+}
+
+void Meshless_Function_Factory::
+reorder_points(vector<int> const &order,
+               vector<vector<double> > &points) const
+{
+    Assert(order.size() == points.size());
+    
+    vector<vector<double> > old_points;
+    old_points.swap(points);
+    points.resize(order.size());
+    for (int i = 0; i < order.size(); ++i)
+    {
+        points[i] = old_points[order[i]];
+    }
+}
+
+void Meshless_Function_Factory::
+reorder_point_data(vector<int> const &order,
+                   vector<double> &data) const
+{
+    int number_of_points = order.size();
+    Assert(number_of_points > 0);
+    Assert(data.size() % number_of_points == 0);
+    int block_size = data.size() / number_of_points;
+    
+    vector<double> old_data;
+    old_data.swap(data);
+    data.resize(old_data.size());
+    for (int i = 0; i < number_of_points; ++i)
+    {
+        for (int k = 0; k < block_size; ++k)
+        {
+            data[k + block_size * i] = old_data[k + block_size * order[i]];
+        }
+    }
+}
+
 void Meshless_Function_Factory::
 get_radii_nearest(shared_ptr<KD_Tree> kd_tree,
                   int dimension,
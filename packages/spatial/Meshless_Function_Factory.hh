@@ -29,6 +29,29 @@ public:
                               int &number_of_points,
                               std::vector<std::vector<double> > &points) const;
     
+    // Get order of points along a Morton (Z-order) space-filling curve
+    void get_morton_ordering(int dimension,
+                             int number_of_points,
+                             std::vector<std::vector<double> > const &points,
+                             std::vector<int> &order) const;
+
+    // Get reverse Cuthill-McKee order of the graph that connects each
+    // point to its "number_of_neighbors" nearest points
+    void get_rcm_ordering(std::shared_ptr<KD_Tree> kd_tree,
+                          int dimension,
+                          int number_of_points,
+                          int number_of_neighbors,
+                          std::vector<std::vector<double> > const &points,
+                          std::vector<int> &order) const;
+
+    // Put points into the given order, so that new point i is old point order[i]
+    void reorder_points(std::vector<int> const &order,
+                        std::vector<std::vector<double> > &points) const;
+
+    // Put data stored in equal blocks for each point into the same order
+    void reorder_point_data(std::vector<int> const &order,
+                            std::vector<double> &data) const;
+    
     // Find "number_of_neighbors" nearest points
     // Radius for each point is the distance to the furthest
     // neighbor times the multiplier
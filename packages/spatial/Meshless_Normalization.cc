@@ -1,6 +1,59 @@
 #include "Meshless_Normalization.hh"
 
+#include "Check.hh"
+
+using std::vector;
+
 Meshless_Normalization::
 Meshless_Normalization()
 {
 }
+
+void Meshless_Normalization::
+batch_gradient_values(vector<vector<double> > const &positions,
+                      vector<vector<double> > const &center_positions,
+                      vector<double> const &base_values,
+                      vector<double> const &grad_base_values,
+                      vector<double> &values,
+                      vector<double> &gradient_values) const
+{
+    int number_of_positions = positions.size();
+    int number_of_functions = center_positions.size();
+    int size = number_of_positions * number_of_functions;
+    Check(number_of_positions > 0);
+    int dimension = positions[0].size();
+    Check(base_values.size() == size);
+    Check(grad_base_values.size() == size * dimension);
+    
+    // Fall back to the values at a single position
+    values.resize(size);
+    gradient_values.resize(size * dimension);
+    vector<double> local_values(number_of_functions);
+    vector<vector<double> > local_gradients(number_of_functions, vector<double>(dimension));
+    for (int q = 0; q < number_of_positions; ++q)
+    {
+        int k = number_of_functions * q;
+        for (int i = 0; i < number_of_functions; ++i)
+        {
+            local_values[i] = base_values[i + k];
+            for (int d = 0; d < dimension; ++d)
+            {
+                local_gradients[i][d] = grad_base_values[d + dimension * (i + k)];
+            }
+        }
+        get_gradient_values(positions[q],
+                            center_positions,
+                            local_values,
+                            local_gradients,
+                            local_values,
+                            local_gradients);
+        for (int i = 0; i < number_of_functions; ++i)
+        {
+            values[i + k] = local_values[i];
+            for (int d = 0; d < dimension; ++d)
+            {
+                gradient_values[d + dimension * (i + k)] = local_gradients[i][d];
+            }
+        }
+    }
+}
@@ -20,6 +20,16 @@ public:
                                      std::vector<std::vector<double> > const &grad_base_values,
                                      std::vector<double> &values,
                                      std::vector<std::vector<double> > &gradient_values) const = 0;
+
+    // Values and gradients at several positions with the same centers,
+    // stored as values[i + number_of_functions * q] and
+    // gradient_values[d + dimension * (i + number_of_functions * q)]
+    virtual void batch_gradient_values(std::vector<std::vector<double> > const &positions,
+                                       std::vector<std::vector<double> > const &center_positions,
+                                       std::vector<double> const &base_values,
+                                       std::vector<double> const &grad_base_values,
+                                       std::vector<double> &values,
+                                       std::vector<double> &gradient_values) const;
 };
 
 #endif
@@ -25,3 +25,29 @@ dd_value(double r) const
     return pow(1 + r * r, -1.5);
 }
 
+void Multiquadric_RBF::
+batch_values(int number_of_points,
+             double const *r,
+             double *values) const
+{
+    #pragma omp simd
+    for (int i = 0; i < number_of_points; ++i)
+    {
+        values[i] = sqrt(1 + r[i] * r[i]);
+    }
+}
+
+void Multiquadric_RBF::
+batch_gradient_values(int number_of_points,
+                      double const *r,
+                      double *values,
+                      double *d_values) const
+{
+    #pragma omp simd
+    for (int i = 0; i < number_of_points; ++i)
+    {
+        double const s = sqrt(1 + r[i] * r[i]);
+        values[i] = s;
+        d_values[i] = r[i] / s;
+    }
+}
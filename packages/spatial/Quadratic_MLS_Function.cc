@@ -11,6 +11,7 @@ namespace vf = Vector_Functions;
 
 using std::make_shared;
 using std::shared_ptr;
+using std::string;
 using std::vector;
 
 Quadratic_MLS_Function::
@@ -266,6 +267,12 @@ gradient_values(vector<double> const &position,
                                         grad_vals);
 }
 
+string Quadratic_MLS_Function::
+description() const
+{
+    return "quadratic_mls_" + function_->description();
+}
+
 void Quadratic_MLS_Function::
 output(XML_Node output_node) const
 {
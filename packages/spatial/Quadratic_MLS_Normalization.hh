@@ -3,10 +3,6 @@
 
 #include "Meshless_Normalization.hh"
 
-#include <memory>
-
-template<class T> class Dense_Solver;
-
 class Quadratic_MLS_Normalization : public Meshless_Normalization
 {
 public:
@@ -25,6 +21,12 @@ public:
                                      std::vector<std::vector<double> > const &grad_base_values,
                                      std::vector<double> &values,
                                      std::vector<std::vector<double> > &gradient_values) const override;
+    virtual void batch_gradient_values(std::vector<std::vector<double> > const &positions,
+                                       std::vector<std::vector<double> > const &center_positions,
+                                       std::vector<double> const &base_values,
+                                       std::vector<double> const &grad_base_values,
+                                       std::vector<double> &values,
+                                       std::vector<double> &gradient_values) const override;
     
     // Helper methods
     void get_polynomial(std::vector<double> const &position,
@@ -42,7 +44,6 @@ private:
     // Data
     int dimension_;
     int number_of_polynomials_;
-    std::shared_ptr<Dense_Solver<double> > solver_;
 };
 
 
@@ -21,3 +21,27 @@ dd_value(double s,
 {
     return dd_value(s) * ds2 + d_value(s) * dds;
 }
+
+void RBF::
+batch_values(int number_of_points,
+             double const *r,
+             double *values) const
+{
+    for (int i = 0; i < number_of_points; ++i)
+    {
+        values[i] = value(r[i]);
+    }
+}
+
+void RBF::
+batch_gradient_values(int number_of_points,
+                      double const *r,
+                      double *values,
+                      double *d_values) const
+{
+    for (int i = 0; i < number_of_points; ++i)
+    {
+        values[i] = value(r[i]);
+        d_values[i] = d_value(r[i]);
+    }
+}
@@ -42,6 +42,15 @@ public:
     virtual double dd_value(double s,
                             double ds,
                             double dds) const;
+
+    // Values and derivatives at several distances at once
+    virtual void batch_values(int number_of_points,
+                              double const *r,
+                              double *values) const;
+    virtual void batch_gradient_values(int number_of_points,
+                                       double const *r,
+                                       double *values,
+                                       double *d_values) const;
     
     virtual std::string description() const = 0;
 };
@@ -123,6 +123,106 @@ laplacian_value(vector<double> const &r) const
                           shape_ * lap);
 }
 
+namespace
+{
+    // Scratch space for the batch evaluations, which are called for every
+    // function in the integration loop and so should not allocate. Each
+    // thread keeps its own buffers, which only grow.
+    thread_local vector<double> batch_distances;
+    thread_local vector<double> batch_d_values;
+}
+
+void RBF_Function::
+batch_values(int number_of_points,
+             double const *r,
+             double *values) const
+{
+    if (number_of_points == 0)
+    {
+        return;
+    }
+    
+    // Get scaled distances
+    if (static_cast<int>(batch_distances.size()) < number_of_points)
+    {
+        batch_distances.resize(number_of_points);
+    }
+    double *dist = batch_distances.data();
+    distance_->batch_distance(number_of_points,
+                              r,
+                              position_,
+                              dist);
+    #pragma omp simd
+    for (int i = 0; i < number_of_points; ++i)
+    {
+        dist[i] *= shape_;
+    }
+
+    // Get values
+    rbf_->batch_values(number_of_points,
+                       dist,
+                       values);
+}
+
+void RBF_Function::
+batch_gradient_values(int number_of_points,
+                      double const *r,
+                      double *values,
+                      double *gradients) const
+{
+    if (number_of_points == 0)
+    {
+        return;
+    }
+    
+    int dimension = distance_->dimension();
+    if (static_cast<int>(batch_distances.size()) < number_of_points)
+    {
+        batch_distances.resize(number_of_points);
+    }
+    if (static_cast<int>(batch_d_values.size()) < number_of_points)
+    {
+        batch_d_values.resize(number_of_points);
+    }
+    double *dist = batch_distances.data();
+    double *d_values = batch_d_values.data();
+    
+    // Get scaled distances and distance gradients
+    distance_->batch_gradient_distance(number_of_points,
+                                       r,
+                                       position_,
+                                       dist,
+                                       gradients);
+    #pragma omp simd
+    for (int i = 0; i < number_of_points; ++i)
+    {
+        dist[i] *= shape_;
+    }
+
+    // Get values and derivatives with respect to scaled distance
+    rbf_->batch_gradient_values(number_of_points,
+                                dist,
+                                values,
+                                d_values);
+
+    // Apply chain rule to the distance gradients in place
+    for (int d = 0; d < dimension; ++d)
+    {
+        double *gradients_d = gradients + number_of_points * d;
+        #pragma omp simd
+        for (int i = 0; i < number_of_points; ++i)
+        {
+            gradients_d[i] *= shape_ * d_values[i];
+        }
+    }
+}
+
+string RBF_Function::
+description() const
+{
+    return "rbf_" + rbf_->description() + "_" + distance_->description();
+}
+
 void RBF_Function::
 output(XML_Node output_node) const
 {
@@ -45,7 +45,15 @@ public:
                             std::vector<double> const &r) const override;
     virtual std::vector<double> gradient_value(std::vector<double> const &r) const override;
     virtual double laplacian_value(std::vector<double> const &r) const override;
+    virtual void batch_values(int number_of_points,
+                              double const *r,
+                              double *values) const override;
+    virtual void batch_gradient_values(int number_of_points,
+                                       double const *r,
+                                       double *values,
+                                       double *gradients) const override;
     
+    virtual std::string description() const override;
     virtual void output(XML_Node output_node) const override;
     virtual void check_class_invariants() const override;
     
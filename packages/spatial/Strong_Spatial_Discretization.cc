@@ -2,6 +2,7 @@
 
 #include "Boundary_Source.hh"
 #include "Check.hh"
+#include "Integral_Arena.hh"
 #include "Material.hh"
 #include "Solid_Geometry.hh"
 #include "Weight_Function.hh"
@@ -42,25 +43,19 @@ perform_point_integration()
 {
     shared_ptr<Solid_Geometry> solid = options_->solid;
     Assert(solid);
-    
+
+    shared_ptr<Integral_Arena> arena = get_zero_integrals();
     for (int i = 0; i < number_of_points_; ++i)
     {
         // Get weight function information
         shared_ptr<Weight_Function> weight = weights_[i];
         vector<double> const position = weight->position();
         int const number_of_boundary_surfaces = weight->number_of_boundary_surfaces();
-        int const number_of_basis_functions = weight->number_of_basis_functions();
         
         // Set dummy values for integrals
         Weight_Function::Integrals integrals;
-        integrals.is_w.assign(number_of_boundary_surfaces, 0);
-        integrals.is_b_w.assign(number_of_boundary_surfaces * number_of_basis_functions, 0);
-        integrals.iv_w.assign(1, 0);
-        integrals.iv_dw.assign(dimension_, 0);
-        integrals.iv_b_w.assign(number_of_basis_functions, 0);
-        integrals.iv_b_dw.assign(number_of_basis_functions * dimension_, 0);
-        integrals.iv_db_w.assign(number_of_basis_functions * dimension_, 0);
-        integrals.iv_db_dw.assign(number_of_basis_functions * dimension_ * dimension_, 0);
+        arena->get_integrals(i,
+                             integrals);
         
         // Get material and boundary source at this point
         shared_ptr<Material> material = solid->material(position);
@@ -72,7 +67,7 @@ perform_point_integration()
         }
         
         // Put information into weight function
-        weight->set_integrals(integrals,
+        weight->set_integrals(std::move(integrals),
                               material,
                               boundary_sources);
     }
@@ -89,25 +84,19 @@ perform_basis_integration()
                                            bases_,
                                            weights_);
     integrator.perform_integration();
-    
+
+    shared_ptr<Integral_Arena> arena = get_zero_integrals();
     for (int i = 0; i < number_of_points_; ++i)
     {
         // Get weight function information
         shared_ptr<Weight_Function> weight = weights_[i];
         vector<double> const position = weight->position();
         int const number_of_boundary_surfaces = weight->number_of_boundary_surfaces();
-        int const number_of_basis_functions = weight->number_of_basis_functions();
         
         // Set dummy values for integrals
         Weight_Function::Integrals integrals;
-        integrals.is_w.assign(number_of_boundary_surfaces, 0);
-        integrals.is_b_w.assign(number_of_boundary_surfaces * number_of_basis_functions, 0);
-        integrals.iv_w.assign(1, 0);
-        integrals.iv_dw.assign(dimension_, 0);
-        integrals.iv_b_w.assign(number_of_basis_functions, 0);
-        integrals.iv_b_dw.assign(number_of_basis_functions * dimension_, 0);
-        integrals.iv_db_w.assign(number_of_basis_functions * dimension_, 0);
-        integrals.iv_db_dw.assign(number_of_basis_functions * dimension_ * dimension_, 0);
+        arena->get_integrals(i,
+                             integrals);
         
         // Get material and boundary source at this point
         shared_ptr<Material> material = solid->material(position);
@@ -134,8 +123,24 @@ perform_basis_integration()
         
         
         // Put information into weight function
-        weight->set_integrals(integrals,
+        weight->set_integrals(std::move(integrals),
                               new_material,
                               boundary_sources);
     }
 }
+
+shared_ptr<Integral_Arena> Strong_Spatial_Discretization::
+get_zero_integrals() const
+{
+    vector<int> number_of_basis_functions(number_of_points_);
+    vector<int> number_of_boundary_surfaces(number_of_points_);
+    for (int i = 0; i < number_of_points_; ++i)
+    {
+        shared_ptr<Weight_Function> weight = weights_[i];
+        number_of_basis_functions[i] = weight->number_of_basis_functions();
+        number_of_boundary_surfaces[i] = weight->number_of_boundary_surfaces();
+    }
+    return make_shared<Integral_Arena>(dimension_,
+                                       number_of_basis_functions,
+                                       number_of_boundary_surfaces);
+}
@@ -3,6 +3,8 @@
 
 #include "Weak_Spatial_Discretization.hh"
 
+class Integral_Arena;
+
 class Strong_Spatial_Discretization : public Weak_Spatial_Discretization
 {
 public:
@@ -16,6 +18,9 @@ public:
 private:
     void perform_basis_integration();
     void perform_point_integration();
+
+    // Get zeroed storage for the integrals of all weight functions
+    std::shared_ptr<Integral_Arena> get_zero_integrals() const;
 };
 
 #endif
@@ -102,15 +102,45 @@ Weak_Spatial_Discretization(vector<shared_ptr<Basis_Function> > &bases,
     if (options_->external_integral_calculation
         && options_->perform_integration)
     {
+        shared_ptr<Weight_Function_Integration> integrator
+            = make_shared<Weight_Function_Integration>(number_of_points_,
+                                                       options_,
+                                                       bases_,
+                                                       weights_);
+        integrator->perform_integration();
+        integration_numbers_ = integrator->get_total_max_points();
+
+        // Keep the integrator and its quadrature values for update_materials()
+        if (options_->store_quadrature_values)
+        {
+            integrator_ = integrator;
+        }
+    }
+    
+    check_class_invariants();
+}
+
+void Weak_Spatial_Discretization::
+update_materials(shared_ptr<Solid_Geometry> solid)
+{
+    AssertMsg(options_->external_integral_calculation, "update_materials requires external integration");
+    Assert(solid);
+    
+    options_->solid = solid;
+    if (integrator_)
+    {
+        integrator_->perform_material_integration(solid);
+    }
+    else
+    {
+        // Without stored values, the basis and weight functions are
+        // evaluated again, but the geometric integrals are not
         Weight_Function_Integration integrator(number_of_points_,
                                                options_,
                                                bases_,
                                                weights_);
-        integrator.perform_integration();
-        integration_numbers_ = integrator.get_total_max_points();
+        integrator.perform_material_integration(solid);
     }
-    
-    check_class_invariants();
 }
 
 int Weak_Spatial_Discretization::
@@ -151,10 +181,10 @@ weighted_collocation_value(int i,
                            vector<double> const &coefficients) const
 {
     shared_ptr<Weight_Function> weight = weights_[i];
-    Weight_Function::Integrals const integrals = weight->integrals();
+    Weight_Function::Integrals const &integrals = weight->integrals();
     int number_of_basis_functions = weight->number_of_basis_functions();
     vector<int> const basis_indices = weight->basis_function_indices();
-    vector<double> const &iv_b_w = integrals.iv_b_w;
+    Integral_Span const &iv_b_w = integrals.iv_b_w;
     double const iv_w = integrals.iv_w[0];
     
     // Sum over coefficients
@@ -386,11 +416,14 @@ output(XML_Node output_node) const
 {
     output_node.set_child_value(external_integral_calculation, "external_integral_calculation");
     output_node.set_child_value(integration_ordinates, "integration_ordinates");
+    output_node.set_child_value(integral_cache, "integral_cache");
+    output_node.set_child_value(store_quadrature_values, "store_quadrature_values");
     output_node.set_child_value(include_supg, "include_supg");
     output_node.set_child_value(identical_basis_functions_conversion()->convert(identical_basis_functions), "identical_basis_functions");
     output_node.set_child_value(weighting_conversion()->convert(weighting), "weighting");
     output_node.set_child_value(tau_scaling_conversion()->convert(tau_scaling), "tau_scaling");
     output_node.set_child_value(total_conversion()->convert(total), "total");
+    output_node.set_child_value(point_ordering_conversion()->convert(point_ordering), "point_ordering");
 }
 
 shared_ptr<Conversion<Weak_Spatial_Discretization_Options::Weighting, string> > Weak_Spatial_Discretization_Options::
@@ -436,6 +469,16 @@ identical_basis_functions_conversion() const
     return make_shared<Conversion<Identical_Basis_Functions, string> >(conversions);
 }
 
+shared_ptr<Conversion<Weak_Spatial_Discretization_Options::Point_Ordering, string> > Weak_Spatial_Discretization_Options::
+point_ordering_conversion() const
+{
+    vector<pair<Point_Ordering, string> > conversions
+        = {{Point_Ordering::NONE, "none"},
+           {Point_Ordering::MORTON, "morton"},
+           {Point_Ordering::RCM, "rcm"}};
+    return make_shared<Conversion<Point_Ordering, string> >(conversions);
+}
+
 void Weak_Spatial_Discretization_Options::
 finalize_input()
 {
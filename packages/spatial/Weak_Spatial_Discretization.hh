@@ -6,6 +6,7 @@
 
 class Basis_Function;
 class KD_Tree;
+class Weight_Function_Integration;
 
 struct Weak_Spatial_Discretization_Options
 {
@@ -49,6 +50,15 @@ struct Weak_Spatial_Discretization_Options
     };
     std::shared_ptr<Conversion<Identical_Basis_Functions, std::string> > identical_basis_functions_conversion() const;
 
+    // Order of points, applied before any indices are assigned
+    enum class Point_Ordering
+    {
+        NONE, // as given
+        MORTON, // along a Morton (Z-order) space-filling curve
+        RCM // reverse Cuthill-McKee of the nearest neighbor graph
+    };
+    std::shared_ptr<Conversion<Point_Ordering, std::string> > point_ordering_conversion() const;
+    
     // Type of sweep
     enum class Discretization
     {
@@ -63,11 +73,15 @@ struct Weak_Spatial_Discretization_Options
     int integration_ordinates = 8; // Dimensional integration quadrature
     int minimum_radius_ordinates = 12;
     int maximum_integration_ordinates = 128;
+    double quadrature_tolerance = 0; // if positive, adaptive quadrature is error-controlled
     double scalar_flux_fraction = 1e-8;
     std::vector<double> flux_coefficients;
     std::vector<std::vector<double> > limits;
     std::shared_ptr<Solid_Geometry> solid;
     std::vector<int> dimensional_cells;
+    std::string integral_cache; // binary integral cache file, with materials in integral_cache + ".materials"; empty to disable
+    bool store_quadrature_values = false; // keep values for update_materials()
+    bool lattice_templates = false; // copy integrals between translated weight functions
     
     // Parameters for the user to set
     bool include_supg = false;
@@ -75,6 +89,7 @@ struct Weak_Spatial_Discretization_Options
     Weighting weighting = Weighting::FULL; 
     Tau_Scaling tau_scaling = Tau_Scaling::NONE;
     Discretization discretization = Discretization::WEAK;
+    Point_Ordering point_ordering = Point_Ordering::NONE; // Not for full or legendre input
     
     // Automatically set parameters
     bool input_finalized = false;
@@ -131,6 +146,14 @@ public:
     virtual void output(XML_Node output_node) const override;
     virtual void check_class_invariants() const override;
 
+    // Recalculate the material integrals for a solid geometry with new
+    // cross sections without repeating the geometric integration. With
+    // options->store_quadrature_values, the basis and weight function values
+    // from the first integration are reused. Operators and sweeps copy the
+    // cross sections when constructed (Cross_Section_Table, affine
+    // components), so they must be created again afterward.
+    virtual void update_materials(std::shared_ptr<Solid_Geometry> solid);
+    
     // Weight_Function functions
     virtual std::shared_ptr<Weak_Spatial_Discretization_Options> options() const
     {
@@ -223,6 +246,7 @@ protected:
     std::shared_ptr<Dimensional_Moments> dimensional_moments_;
     std::shared_ptr<KD_Tree> kd_tree_;
     std::vector<int> integration_numbers_;
+    std::shared_ptr<Weight_Function_Integration> integrator_;
 };
 
 #endif
@@ -74,8 +74,11 @@ get_full_discretization(XML_Node input_node) const
     int number_of_points = input_node.get_child_value<int>("number_of_points");
 
     // Get discretization options
+    // The input gives the connectivity by index, so the points cannot be reordered
     shared_ptr<Weak_Spatial_Discretization_Options> weak_options
         = get_weak_options(input_node.get_child("options"));
+    AssertMsg(weak_options->point_ordering == Weak_Spatial_Discretization_Options::Point_Ordering::NONE,
+              "point_ordering not available for full input format");
     
     // Get dimensional moments
     shared_ptr<Dimensional_Moments> dimensional_moments
@@ -145,6 +148,14 @@ get_galerkin_points_discretization(XML_Node input_node) const
         }
     }
     
+    // Reorder points before any indices depend on them
+    XML_Node radius_node = weights_node.get_child("radius_calculation");
+    int number_of_neighbors = radius_node.get_child_value<int>("number_of_neighbors");
+    order_points(weak_options,
+                 dimension,
+                 number_of_neighbors,
+                 points);
+    
     // Make KD tree
     shared_ptr<KD_Tree> kd_tree
         = make_shared<KD_Tree>(dimension,
@@ -152,9 +163,7 @@ get_galerkin_points_discretization(XML_Node input_node) const
                                points);
     
     // Find radii
-    XML_Node radius_node = weights_node.get_child("radius_calculation");
     string radii_method = radius_node.get_attribute<string>("method");
-    int number_of_neighbors = radius_node.get_child_value<int>("number_of_neighbors");
     double radius_multiplier = radius_node.get_child_value<double>("radius_multiplier");
     vector<double> radii;
     if (radii_method == "nearest")
@@ -306,6 +315,14 @@ get_cartesian_discretization(XML_Node input_node) const
                                           number_of_points,
                                           points);
     
+    // Reorder points before any indices depend on them
+    XML_Node radius_node = weights_node.get_child("radius_calculation");
+    int number_of_neighbors = radius_node.get_child_value<int>("number_of_neighbors");
+    order_points(weak_options,
+                 dimension,
+                 number_of_neighbors,
+                 points);
+    
     // Make KD tree
     shared_ptr<KD_Tree> kd_tree
         = make_shared<KD_Tree>(dimension,
@@ -313,9 +330,7 @@ get_cartesian_discretization(XML_Node input_node) const
                                points);
     
     // Find radii
-    XML_Node radius_node = weights_node.get_child("radius_calculation");
     string radii_method = radius_node.get_attribute<string>("method");
-    int number_of_neighbors = radius_node.get_child_value<int>("number_of_neighbors");
     double radius_multiplier = radius_node.get_child_value<double>("radius_multiplier");
     vector<double> radii;
     if (radii_method == "nearest")
@@ -445,6 +460,10 @@ get_legendre_discretization(XML_Node input_node) const
     weak_options->identical_basis_functions
         = Weak_Spatial_Discretization_Options::Identical_Basis_Functions::TRUE;
     
+    // Every function neighbors every other, so ordering has no effect
+    AssertMsg(weak_options->point_ordering == Weak_Spatial_Discretization_Options::Point_Ordering::NONE,
+              "point_ordering not available for legendre input format");
+    
     // Initialize data
     int dimension = solid_geometry_->dimension();
     
@@ -754,9 +773,17 @@ options->perform_integration);
                                                                                  options->minimum_radius_ordinates);
             options->maximum_integration_ordinates = input_node.get_attribute<int>("maximum_integration_ordinates",
                                                                                  options->maximum_integration_ordinates);
+            options->quadrature_tolerance = input_node.get_attribute<double>("quadrature_tolerance",
+                                                                             options->quadrature_tolerance);
         }
         
         options->dimensional_cells = input_node.get_child_vector<int>("dimensional_cells", dimension);
+        options->integral_cache = input_node.get_attribute<string>("integral_cache",
+                                                                   options->integral_cache);
+        options->store_quadrature_values = input_node.get_attribute<bool>("store_quadrature_values",
+                                                                          options->store_quadrature_values);
+        options->lattice_templates = input_node.get_attribute<bool>("lattice_templates",
+                                                                    options->lattice_templates);
     }
     options->solid = solid_geometry_;
     meshless_factory.get_boundary_limits(dimension,
@@ -774,6 +801,11 @@ options->perform_integration);
     string tau_string = input_node.get_attribute<string>("tau_scaling");
     options->tau_scaling = options->tau_scaling_conversion()->convert(tau_string);
     
+    // Get point ordering
+    string ordering_string = input_node.get_attribute<string>("point_ordering",
+                                                              "none");
+    options->point_ordering = options->point_ordering_conversion()->convert(ordering_string);
+    
     return options;
 }
 
@@ -857,3 +889,47 @@ get_boundary_surfaces(shared_ptr<Meshless_Function> function) const
     return surfaces;
 }
 
+void Weak_Spatial_Discretization_Parser::
+order_points(shared_ptr<Weak_Spatial_Discretization_Options> options,
+             int dimension,
+             int number_of_neighbors,
+             vector<vector<double> > &points) const
+{
+    Meshless_Function_Factory meshless_factory;
+    int number_of_points = points.size();
+    vector<int> order;
+    switch (options->point_ordering)
+    {
+    case Weak_Spatial_Discretization_Options::Point_Ordering::NONE:
+        return;
+    case Weak_Spatial_Discretization_Options::Point_Ordering::MORTON:
+        meshless_factory.get_morton_ordering(dimension,
+                                             number_of_points,
+                                             points,
+                                             order);
+        break;
+    case Weak_Spatial_Discretization_Options::Point_Ordering::RCM:
+    {
+        shared_ptr<KD_Tree> kd_tree
+            = make_shared<KD_Tree>(dimension,
+                                   number_of_points,
+                                   points);
+        meshless_factory.get_rcm_ordering(kd_tree,
+                                          dimension,
+                                          number_of_points,
+                                          number_of_neighbors,
+                                          points,
+                                          order);
+        break;
+    }
+    }
+    meshless_factory.reorder_points(order,
+                                    points);
+    
+    // Keep the flux of each point with the point
+    if (options->weighting == Weak_Spatial_Discretization_Options::Weighting::FLUX)
+    {
+        meshless_factory.reorder_point_data(order,
+                                            options->flux_coefficients);
+    }
+}
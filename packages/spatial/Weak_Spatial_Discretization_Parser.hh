@@ -58,6 +58,10 @@ public:
                                                                         std::shared_ptr<Dimensional_Moments> dimensional_moments,
                                                                         std::vector<std::shared_ptr<Basis_Function> > const &basis_functions) const;
     std::vector<std::shared_ptr<Cartesian_Plane> > get_boundary_surfaces(std::shared_ptr<Meshless_Function> function) const;
+    void order_points(std::shared_ptr<Weak_Spatial_Discretization_Options> options,
+                      int dimension,
+                      int number_of_neighbors,
+                      std::vector<std::vector<double> > &points) const;
     
 private:
 
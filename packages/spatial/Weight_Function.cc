@@ -12,6 +12,7 @@
 #include "Cross_Section.hh"
 #include "Dimensional_Moments.hh"
 #include "Energy_Discretization.hh"
+#include "Integral_Arena.hh"
 #include "Material.hh"
 #include "Meshless_Function.hh"
 #include "Quadrature_Rule.hh"
@@ -69,7 +70,7 @@ Weight_Function(int index,
                 shared_ptr<Solid_Geometry> solid_geometry,
                 vector<shared_ptr<Cartesian_Plane> > boundary_surfaces,
                 shared_ptr<Material> material,
-                Integrals const &integrals):
+                Integrals &&integrals):
     index_(index),
     dimension_(dimension),
     position_(meshless_function->position()),
@@ -84,7 +85,7 @@ Weight_Function(int index,
     solid_geometry_(solid_geometry),
     dimensional_moments_(dimensional_moments),
     boundary_surfaces_(boundary_surfaces),
-    integrals_(integrals)
+    integrals_(std::move(integrals))
 {
     AssertMsg(false, "not tested");
     set_options_and_limits();
@@ -629,12 +630,15 @@ calculate_values()
 void Weight_Function::
 calculate_integrals()
 {
+    // Allocate zeroed integrals in a single block
+    shared_ptr<Integral_Arena> arena
+        = make_shared<Integral_Arena>(dimension_,
+                                      vector<int>(1, number_of_basis_functions_),
+                                      vector<int>(1, number_of_boundary_surfaces_));
+    arena->get_integrals(0,
+                         integrals_);
+    
     // Perform basis/weight integrals
-    integrals_.is_b_w.assign(number_of_boundary_surfaces_ * number_of_basis_functions_, 0.);
-    integrals_.iv_b_w.assign(number_of_basis_functions_, 0.);
-    integrals_.iv_b_dw.assign(number_of_basis_functions_ * dimension_, 0.);
-    integrals_.iv_db_w.assign(number_of_basis_functions_ * dimension_, 0.);
-    integrals_.iv_db_dw.assign(number_of_basis_functions_ * dimension_ * dimension_, 0.);
 
     shared_ptr<Meshless_Function> weight = meshless_function_;
 
@@ -699,10 +703,6 @@ calculate_integrals()
     }
 
     // Perform weight integrals
-    integrals_.is_w.assign(number_of_boundary_surfaces_, 0.);
-    integrals_.iv_w.assign(1, 0.);
-    integrals_.iv_dw.assign(dimension_, 0.);
-     
     // Surface integrals
     for (int s = 0; s < number_of_boundary_surfaces_; ++s)
     {
@@ -1377,24 +1377,24 @@ output(XML_Node output_node) const
 
     if (options_->output_integrals)
     {
-        output_node.set_child_vector(integrals_.is_w, "is_w", "surface");
-        output_node.set_child_vector(integrals_.is_b_w, "is_b_w", "surface-basis");
-        output_node.set_child_vector(integrals_.iv_w, "iv_w");
-        output_node.set_child_vector(integrals_.iv_dw, "iv_dw", "dimension");
-        output_node.set_child_vector(integrals_.iv_b_w, "iv_b_w", "basis");
-        output_node.set_child_vector(integrals_.iv_b_dw, "iv_b_dw", "dimension-basis");
-        output_node.set_child_vector(integrals_.iv_db_w, "iv_db_w", "dimension-basis");
-        output_node.set_child_vector(integrals_.iv_db_dw, "iv_db_dw", "dimension-dimension-basis");
+        output_node.set_child_vector(integrals_.is_w.to_vector(), "is_w", "surface");
+        output_node.set_child_vector(integrals_.is_b_w.to_vector(), "is_b_w", "surface-basis");
+        output_node.set_child_vector(integrals_.iv_w.to_vector(), "iv_w");
+        output_node.set_child_vector(integrals_.iv_dw.to_vector(), "iv_dw", "dimension");
+        output_node.set_child_vector(integrals_.iv_b_w.to_vector(), "iv_b_w", "basis");
+        output_node.set_child_vector(integrals_.iv_b_dw.to_vector(), "iv_b_dw", "dimension-basis");
+        output_node.set_child_vector(integrals_.iv_db_w.to_vector(), "iv_db_w", "dimension-basis");
+        output_node.set_child_vector(integrals_.iv_db_dw.to_vector(), "iv_db_dw", "dimension-dimension-basis");
     }
 }
 
 void Weight_Function::
-set_integrals(Weight_Function::Integrals const &integrals,
+set_integrals(Weight_Function::Integrals &&integrals,
               shared_ptr<Material> material,
               vector<shared_ptr<Boundary_Source> > boundary_sources)
 {
     // Set integral data
-    integrals_ = integrals;
+    integrals_ = std::move(integrals);
     material_ = material;
     boundary_sources_ = boundary_sources;
     
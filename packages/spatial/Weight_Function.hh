@@ -1,6 +1,7 @@
 #ifndef Weight_Function_hh
 #define Weight_Function_hh
 
+#include "Integral_Span.hh"
 #include "Point.hh"
 
 #include <functional>
@@ -11,6 +12,7 @@ class Boundary_Source;
 class Cartesian_Plane;
 template<class T1, class T2> class Conversion;
 class Dimensional_Moments;
+class Integral_Arena;
 class Meshless_Function;
 class Solid_Geometry;
 struct Weak_Spatial_Discretization_Options;
@@ -36,19 +38,30 @@ public:
         DOES_NOT_EXIST = -1
     };
     
+    // Spans into integrals owned by an Integral_Arena
+    // Not copyable, as a copy would alias the data of the original
     struct Integrals
     {
+        Integrals() = default;
+        Integrals(Integrals const &) = delete;
+        Integrals(Integrals &&) = default;
+        Integrals &operator=(Integrals const &) = delete;
+        Integrals &operator=(Integrals &&) = default;
+        
+        // Contiguous storage that the spans below point into
+        std::shared_ptr<Integral_Arena> arena;
+        
         // Surface integrals
-        std::vector<double> is_w; // weight function: s
-        std::vector<double> is_b_w; // weight/basis functions: s->i
+        Integral_Span is_w; // weight function: s
+        Integral_Span is_b_w; // weight/basis functions: s->i
         
         // Volume integrals
-        std::vector<double> iv_w; // weight function: none
-        std::vector<double> iv_dw; // derivative of weight function: d
-        std::vector<double> iv_b_w; // basis function and weight function: i
-        std::vector<double> iv_b_dw; // basis function and derivative of weight function: dw->i
-        std::vector<double> iv_db_w; // weight function and derivative of basis function: db->i
-        std::vector<double> iv_db_dw; // derivative of basis and weight functions: db->dw->i
+        Integral_Span iv_w; // weight function: none
+        Integral_Span iv_dw; // derivative of weight function: d
+        Integral_Span iv_b_w; // basis function and weight function: i
+        Integral_Span iv_b_dw; // basis function and derivative of weight function: dw->i
+        Integral_Span iv_db_w; // weight function and derivative of basis function: db->i
+        Integral_Span iv_db_dw; // derivative of basis and weight functions: db->dw->i
     };
 
     struct Values
@@ -80,7 +93,7 @@ public:
                     std::shared_ptr<Solid_Geometry> solid_geometry,
                     std::vector<std::shared_ptr<Cartesian_Plane> > boundary_surfaces,
                     std::shared_ptr<Material> material,
-                    Integrals const &integrals);
+                    Integrals &&integrals);
     
     // Point functions
     virtual int index() const override
@@ -185,7 +198,7 @@ public:
                                               std::vector<double> &weights) const;
 
     // Set data
-    virtual void set_integrals(Weight_Function::Integrals const &integrals,
+    virtual void set_integrals(Weight_Function::Integrals &&integrals,
                                std::shared_ptr<Material> material,
                                std::vector<std::shared_ptr<Boundary_Source>> boundary_sources);
     
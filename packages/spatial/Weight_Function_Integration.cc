@@ -2,12 +2,11 @@
 
 #include <algorithm>
 #include <cmath>
-#if defined(ENABLE_OPENMP)
-    #include <omp.h>
-#else
-    inline int omp_get_num_threads() {return 1;}
-    inline int omp_get_thread_num() {return 0;}
-#endif
+#include <iostream>
+#include <map>
+#include <numeric>
+#include <set>
+#include <string>
 
 #include "Angular_Discretization.hh"
 #include "Basis_Function.hh"
@@ -17,6 +16,7 @@
 #include "Cross_Section.hh"
 #include "Dimensional_Moments.hh"
 #include "Energy_Discretization.hh"
+#include "Integral_Arena.hh"
 #include "Material.hh"
 #include "Meshless_Function.hh"
 #include "Solid_Geometry.hh"
@@ -25,6 +25,73 @@
 
 using namespace std;
 
+namespace // anonymous
+{
+    // Incremental FNV-1a hash for the integral cache key
+    class Integral_Hash
+    {
+    public:
+        
+        void add(void const *data,
+                 size_t size)
+        {
+            unsigned char const *bytes = static_cast<unsigned char const*>(data);
+            for (size_t i = 0; i < size; ++i)
+            {
+                value_ ^= bytes[i];
+                value_ *= 1099511628211ull;
+            }
+        }
+        void add(bool value)
+        {
+            add(static_cast<int>(value));
+        }
+        void add(int value)
+        {
+            add(&value, sizeof(value));
+        }
+        void add(uint64_t value)
+        {
+            add(&value, sizeof(value));
+        }
+        void add(double value)
+        {
+            add(&value, sizeof(value));
+        }
+        void add(string const &value)
+        {
+            add(static_cast<int>(value.size()));
+            add(value.data(), value.size());
+        }
+        template<class T>
+        void add(vector<T> const &value)
+        {
+            add(static_cast<int>(value.size()));
+            for (T const &v : value)
+            {
+                add(v);
+            }
+        }
+        uint64_t value() const
+        {
+            return value_;
+        }
+        
+    private:
+        
+        uint64_t value_ = 14695981039346656037ull;
+    };
+
+    // Quantize a value relative to a length scale for the template keys, so
+    // that points that are offset by round-off share the same key
+    long long quantize(double value)
+    {
+        double const tolerance = 1e-8;
+        return llround(value / tolerance);
+    }
+} // namespace
+
+
 Weight_Function_Integration::
 Weight_Function_Integration(int number_of_points,
                             shared_ptr<Weak_Spatial_Discretization_Options> options,
@@ -32,6 +99,7 @@ Weight_Function_Integration(int number_of_points,
                             vector<shared_ptr<Weight_Function> > const &weights):
     options_(options),
     number_of_points_(number_of_points),
+    bases_(bases),
     weights_(weights),
     solid_(options->solid)
 {
@@ -40,12 +108,11 @@ Weight_Function_Integration(int number_of_points,
     Assert(solid_);
     
     // Create mesh
-    shared_ptr<Integration_Mesh_Options> integration_options
-        = make_shared<Integration_Mesh_Options>();
-    integration_options->initialize_from_weak_options(options);
+    integration_options_ = make_shared<Integration_Mesh_Options>();
+    integration_options_->initialize_from_weak_options(options);
     mesh_ = make_shared<Integration_Mesh>(solid_->dimension(),
                                           number_of_points,
-                                          integration_options,
+                                          integration_options_,
                                           bases,
                                           weights);
     // Get angular and energy discretizations
@@ -59,59 +126,161 @@ Weight_Function_Integration(int number_of_points,
                    * energy_->number_of_groups()
                    * angular_->number_of_moments()));
     }
+
+    // Find weight functions whose integrals are translations of others
+    initialize_templates();
+
+    // Color the integration entities for parallel integration
+    initialize_colors();
+}
+
+void Weight_Function_Integration::
+initialize_colors()
+{
+    // Color cells and surfaces so that no two entities of the same color
+    // write to the same point, which lets each color be integrated in
+    // parallel directly into the global integrals
+    int number_of_cells = mesh_->number_of_cells();
+    vector<vector<int> > cell_points(number_of_cells);
+    for (int i = 0; i < number_of_cells; ++i)
+    {
+        Integration_Cell const &cell = mesh_->cell(i);
+        cell_points[i].assign(cell.weight_indices.begin(),
+                              cell.weight_indices.end());
+        cell_points[i].insert(cell_points[i].end(),
+                              cell.basis_indices.begin(),
+                              cell.basis_indices.end());
+    }
+    get_colors(cell_points,
+               cell_colors_);
+    
+    int number_of_surfaces = mesh_->number_of_surfaces();
+    vector<vector<int> > surface_points(number_of_surfaces);
+    for (int i = 0; i < number_of_surfaces; ++i)
+    {
+        shared_ptr<Integration_Surface> const surface = mesh_->surface(i);
+        surface_points[i] = surface->weight_indices;
+        surface_points[i].insert(surface_points[i].end(),
+                                 surface->basis_indices.begin(),
+                                 surface->basis_indices.end());
+    }
+    get_colors(surface_points,
+               surface_colors_);
 }
 
 void Weight_Function_Integration::
 perform_integration()
 {
-    // Global materials and integrals
+    // Global materials and integrals, shared by all threads
     vector<Weight_Function::Integrals> integrals;
     vector<Material_Data> materials;
+    initialize_integrals(integrals);
+    initialize_materials(materials);
+    shared_ptr<Integral_Arena> arena = integrals[0].arena;
+
+    // Try to read the integrals from the cache, which holds the entire
+    // arena, and the normalized materials from a second file keyed by the
+    // cross sections and boundary sources at the quadrature points. If
+    // both are found, the basis and weight functions are never evaluated.
+    string const &cache = options_->integral_cache;
+    string const material_cache = cache + ".materials";
+    uint64_t key = 0;
+    uint64_t material_key = 0;
+    bool calculate_integrals = true;
+    bool calculate_materials = true;
+    if (!cache.empty())
+    {
+        key = get_integral_key();
+        material_key = get_material_key(key);
+        calculate_integrals = !arena->read(cache,
+                                           key);
+        calculate_materials = (calculate_integrals
+                               || !read_materials(material_cache,
+                                                  material_key,
+                                                  materials));
+    }
 
-    // Integrals and materials local to each processor
-    vector<vector<Weight_Function::Integrals> > extra_integrals;
-    vector<vector<Material_Data> > extra_materials;
-    
     #pragma omp parallel
     {
-        int number_of_threads = omp_get_num_threads();
-        int local_thread = omp_get_thread_num();
-
-        // Create extra integrals and materials for processors above the first
-        #pragma omp single
+        if (calculate_materials)
         {
-            extra_integrals.resize(number_of_threads - 1);
-            extra_materials.resize(number_of_threads - 1);
+            // Perform volume integration
+            perform_volume_integration(calculate_integrals,
+                                       integrals,
+                                       materials);
+            
+            // Perform surface integration
+            perform_surface_integration(calculate_integrals,
+                                        integrals,
+                                        materials);
+            
+            // Copy integrals to translated weight functions
+            if (calculate_integrals)
+            {
+                scatter_templates(integrals);
+            }
+            
+            // Normalize materials
+            normalize_materials(materials);
         }
-
-        // Get local integrals and materials
-        vector<Weight_Function::Integrals> &local_integrals
-            = local_thread == 0 ? integrals : extra_integrals[local_thread - 1];
-        vector<Material_Data> &local_materials
-            = local_thread == 0 ? materials : extra_materials[local_thread - 1];
-        
-        // Initialize integrals to zero
-        initialize_integrals(local_integrals);
         
-        // Initialize materials to zero
-        initialize_materials(local_materials);
-        
-        // Perform volume integration
-        perform_volume_integration(local_integrals,
-                                   local_materials);
+        // Put results into weight functions and materials
+        put_integrals_into_weight(integrals,
+                                  materials);
+    }
 
-        // Perform surface integration
-        perform_surface_integration(local_integrals,
-                                    local_materials);
-        
-        // Sum integrals 
-        for (int i = 1; i < number_of_threads; ++i)
+    if (mesh_->number_of_unconverged_cells() > 0)
+    {
+        cout << "Weight_Function_Integration: quadrature did not converge in " << mesh_->number_of_unconverged_cells() << " cells" << endl;
+    }
+
+    // Save the integrals for the next run; failing to do so only costs time
+    if (!cache.empty())
+    {
+        if (calculate_integrals && !arena->write(cache,
+                                                 key))
         {
-            add_integral_sets(extra_integrals[i - 1],
-                              integrals);
-            add_material_sets(extra_materials[i - 1],
-                              materials);
+            cout << "Weight_Function_Integration: could not write integral cache \"" << cache << "\"" << endl;
         }
+        if (calculate_materials && !write_materials(material_cache,
+                                                    material_key,
+                                                    materials))
+        {
+            cout << "Weight_Function_Integration: could not write integral cache \"" << material_cache << "\"" << endl;
+        }
+    }
+
+    // Later material integrations can use the stored values
+    values_stored_ = calculate_materials && options_->store_quadrature_values;
+}
+
+void Weight_Function_Integration::
+perform_material_integration(shared_ptr<Solid_Geometry> solid)
+{
+    Assert(solid);
+    solid_ = solid;
+    
+    // The geometric integrals are already in the arena shared by the weight functions
+    shared_ptr<Integral_Arena> arena = weights_[0]->integrals().arena;
+    vector<Weight_Function::Integrals> integrals(number_of_points_);
+    for (int i = 0; i < number_of_points_; ++i)
+    {
+        arena->get_integrals(i,
+                             integrals[i]);
+    }
+    vector<Material_Data> materials;
+    initialize_materials(materials);
+    
+    #pragma omp parallel
+    {
+        // Perform volume and surface integration, using the stored values
+        // if perform_integration() kept them
+        perform_volume_integration(false, // calculate_integrals
+                                   integrals,
+                                   materials);
+        perform_surface_integration(false, // calculate_integrals
+                                    integrals,
+                                    materials);
         
         // Normalize materials
         normalize_materials(materials);
@@ -122,150 +291,654 @@ perform_integration()
     }
 }
 
-void Weight_Function_Integration::
-add_vector_to_total(vector<double> const &local_data,
-                    vector<double> &data)
+uint64_t Weight_Function_Integration::
+get_integral_key() const
+{
+    Integral_Hash hash;
+    
+    // Integration parameters
+    hash.add(solid_->dimension());
+    hash.add(number_of_points_);
+    hash.add(integration_options_->identical_basis_functions);
+    hash.add(integration_options_->adaptive_quadrature);
+    hash.add(integration_options_->minimum_radius_ordinates);
+    hash.add(integration_options_->integration_ordinates);
+    hash.add(integration_options_->maximum_integration_ordinates);
+    hash.add(integration_options_->quadrature_tolerance);
+    hash.add(integration_options_->boundary_tolerance);
+    hash.add(integration_options_->limits);
+    hash.add(integration_options_->dimensional_cells);
+    hash.add(options_->lattice_templates);
+
+    // Weight functions
+    for (shared_ptr<Weight_Function> const &weight : weights_)
+    {
+        hash.add(weight->position());
+        hash.add(weight->radius());
+        hash.add(weight->function()->shape());
+        hash.add(weight->function()->description());
+        hash.add(weight->basis_function_indices());
+        int number_of_boundary_surfaces = weight->number_of_boundary_surfaces();
+        hash.add(number_of_boundary_surfaces);
+        for (int s = 0; s < number_of_boundary_surfaces; ++s)
+        {
+            shared_ptr<Cartesian_Plane> const surface = weight->boundary_surface(s);
+            hash.add(surface->surface_dimension());
+            hash.add(surface->position());
+            hash.add(surface->normal());
+        }
+    }
+
+    // Basis functions
+    for (shared_ptr<Basis_Function> const &basis : bases_)
+    {
+        hash.add(basis->position());
+        hash.add(basis->radius());
+        hash.add(basis->function()->shape());
+        hash.add(basis->function()->description());
+    }
+    
+    return hash.value();
+}
+
+uint64_t Weight_Function_Integration::
+get_material_key(uint64_t integral_key) const
+{
+    Integral_Hash hash;
+
+    // Geometric integrals and the options used to weight and normalize the
+    // cross sections
+    hash.add(integral_key);
+    hash.add(static_cast<int>(options_->weighting));
+    hash.add(options_->flux_coefficients);
+    hash.add(options_->scalar_flux_fraction);
+    hash.add(options_->normalized);
+    hash.add(options_->include_supg);
+    
+    // Material at each volume quadrature point, with the cross sections
+    // added the first time each material is found
+    set<int> material_indices;
+    int number_of_cells = mesh_->number_of_cells();
+    for (int i = 0; i < number_of_cells; ++i)
+    {
+        int number_of_ordinates;
+        vector<vector<double> > ordinates;
+        vector<double> weights;
+        mesh_->get_volume_quadrature(i,
+                                     number_of_ordinates,
+                                     ordinates,
+                                     weights);
+        for (vector<double> const &position : ordinates)
+        {
+            shared_ptr<Material> const material = solid_->material(position);
+            hash.add(material->index());
+            if (material_indices.insert(material->index()).second)
+            {
+                hash.add(material->sigma_t()->data());
+                hash.add(material->sigma_s()->data());
+                hash.add(material->nu()->data());
+                hash.add(material->sigma_f()->data());
+                hash.add(material->chi()->data());
+                hash.add(material->internal_source()->data());
+            }
+        }
+    }
+    
+    // Boundary source at each surface quadrature point
+    set<int> source_indices;
+    int number_of_surfaces = mesh_->number_of_surfaces();
+    for (int i = 0; i < number_of_surfaces; ++i)
+    {
+        int number_of_ordinates;
+        vector<vector<double> > ordinates;
+        vector<double> weights;
+        mesh_->get_surface_quadrature(i,
+                                      number_of_ordinates,
+                                      ordinates,
+                                      weights);
+        for (vector<double> const &position : ordinates)
+        {
+            shared_ptr<Boundary_Source> const source = solid_->boundary_source(position);
+            hash.add(source->index());
+            if (source_indices.insert(source->index()).second)
+            {
+                hash.add(source->data());
+                hash.add(source->alpha());
+            }
+        }
+    }
+    
+    return hash.value();
+}
+
+bool Weight_Function_Integration::
+read_materials(string const &filename,
+               uint64_t key,
+               vector<Material_Data> &materials) const
 {
-    int local_size = local_data.size();
-    int size = data.size();
-    Assert(local_size == size);
+    // The sizes of the material data are set by initialize_materials()
+    vector<double> data;
+    pack_materials(materials,
+                   data);
+    if (!Integral_Arena::read_cache(filename,
+                                    key,
+                                    data))
+    {
+        return false;
+    }
 
-    for (int i = 0; i < size; ++i)
+    // Unpack data in the order given by pack_materials()
+    vector<double>::const_iterator it = data.begin();
+    for (Material_Data &material : materials)
     {
-        data[i] += local_data[i];
+        for (vector<double> *values : {&material.sigma_t,
+                                       &material.sigma_s,
+                                       &material.nu,
+                                       &material.sigma_f,
+                                       &material.chi,
+                                       &material.internal_source,
+                                       &material.norm,
+                                       &material.boundary_sources})
+        {
+            copy(it, it + values->size(), values->begin());
+            it += values->size();
+        }
     }
+    Check(it == data.end());
+    return true;
+}
+
+bool Weight_Function_Integration::
+write_materials(string const &filename,
+                uint64_t key,
+                vector<Material_Data> const &materials) const
+{
+    vector<double> data;
+    pack_materials(materials,
+                   data);
+    return Integral_Arena::write_cache(filename,
+                                       key,
+                                       data);
 }
 
 void Weight_Function_Integration::
-add_integral_sets(vector<Weight_Function::Integrals> const &local_integrals,
-                  vector<Weight_Function::Integrals> &integrals)
+pack_materials(vector<Material_Data> const &materials,
+               vector<double> &data) const
 {
-    #pragma omp for schedule(dynamic, 10)
+    data.clear();
+    for (Material_Data const &material : materials)
+    {
+        for (vector<double> const *values : {&material.sigma_t,
+                                             &material.sigma_s,
+                                             &material.nu,
+                                             &material.sigma_f,
+                                             &material.chi,
+                                             &material.internal_source,
+                                             &material.norm,
+                                             &material.boundary_sources})
+        {
+            data.insert(data.end(), values->begin(), values->end());
+        }
+    }
+}
+
+void Weight_Function_Integration::
+initialize_templates()
+{
+    // By default, each weight function is integrated directly
+    template_sources_.resize(number_of_points_);
+    iota(template_sources_.begin(), template_sources_.end(), 0);
+    template_basis_orders_.assign(number_of_points_, vector<int>());
+    cell_template_indices_.assign(mesh_->number_of_cells(), -1);
+    template_cells_.clear();
+    if (!options_->lattice_templates)
+    {
+        return;
+    }
+    
+    // Translation invariance requires that the function values depend only
+    // on the offset from the center, not on the neighboring functions, so
+    // templates are not used otherwise
+    shared_ptr<Meshless_Function> const weight_function = weights_[0]->function();
+    shared_ptr<Meshless_Function> const basis_function = bases_[0]->function();
+    if (weight_function->depends_on_neighbors()
+        || basis_function->depends_on_neighbors())
+    {
+        return;
+    }
+    string const weight_description = weight_function->description();
+    string const basis_description = basis_function->description();
+    
+    // Keys are relative to a length scale
+    int const dimension = mesh_->dimension();
+    double const length = weights_[0]->radius();
+    
+    // Interior weight functions with the same radius and the same basis
+    // offsets share the first such weight function's integrals
+    map<vector<long long>, int> sources;
     for (int i = 0; i < number_of_points_; ++i)
     {
-        Weight_Function::Integrals const &local_integral = local_integrals[i];
-        Weight_Function::Integrals &integral = integrals[i];
+        shared_ptr<Weight_Function> const weight = weights_[i];
+        if (weight->number_of_boundary_surfaces() > 0
+            || weight->function()->description() != weight_description)
+        {
+            continue;
+        }
         
-        add_vector_to_total(local_integral.is_w,
-                            integral.is_w);
-        add_vector_to_total(local_integral.is_b_w,
-                            integral.is_b_w);
-        add_vector_to_total(local_integral.iv_w,
-                            integral.iv_w);
-        add_vector_to_total(local_integral.iv_dw,
-                            integral.iv_dw);
-        add_vector_to_total(local_integral.iv_b_w,
-                            integral.iv_b_w);
-        add_vector_to_total(local_integral.iv_b_dw,
-                            integral.iv_b_dw);
-        add_vector_to_total(local_integral.iv_db_w,
-                            integral.iv_db_w);
-        add_vector_to_total(local_integral.iv_db_dw,
-                            integral.iv_db_dw);
+        // Describe each basis function relative to the weight function
+        vector<double> const &position = weight->position();
+        int const number_of_basis_functions = weight->number_of_basis_functions();
+        vector<int> const &basis_indices = weight->basis_function_indices();
+        vector<pair<vector<long long>, int> > local_keys(number_of_basis_functions);
+        bool matches = true;
+        for (int j = 0; j < number_of_basis_functions; ++j)
+        {
+            shared_ptr<Basis_Function> const basis = bases_[basis_indices[j]];
+            if (basis->function()->description() != basis_description)
+            {
+                matches = false;
+                break;
+            }
+            vector<double> const &basis_position = basis->position();
+            vector<long long> &local_key = local_keys[j].first;
+            local_key.resize(dimension + 2);
+            for (int d = 0; d < dimension; ++d)
+            {
+                local_key[d] = quantize((basis_position[d] - position[d]) / length);
+            }
+            local_key[dimension] = quantize(basis->radius() / length);
+            local_key[dimension + 1] = quantize(basis->function()->shape() * length);
+            local_keys[j].second = j;
+        }
+        if (!matches)
+        {
+            continue;
+        }
+        
+        // Sort the basis functions by offset so the key does not depend
+        // on the local basis function ordering
+        sort(local_keys.begin(), local_keys.end());
+        vector<long long> key = {quantize(weight->radius() / length),
+                                 quantize(weight->function()->shape() * length),
+                                 number_of_basis_functions};
+        vector<int> &order = template_basis_orders_[i];
+        order.resize(number_of_basis_functions);
+        for (int k = 0; k < number_of_basis_functions; ++k)
+        {
+            key.insert(key.end(),
+                       local_keys[k].first.begin(),
+                       local_keys[k].first.end());
+            order[k] = local_keys[k].second;
+        }
+        
+        template_sources_[i] = sources.emplace(key, i).first->second;
     }
+
+    initialize_cell_templates(length,
+                              weight_description,
+                              basis_description);
 }
 
 void Weight_Function_Integration::
-add_material_sets(vector<Material_Data> const &local_materials,
-                  vector<Material_Data> &materials)
+initialize_cell_templates(double length,
+                          string const &weight_description,
+                          string const &basis_description)
 {
+    int const dimension = mesh_->dimension();
+    int const number_of_cells = mesh_->number_of_cells();
+    
+    // Describe a function relative to the lower corner of the cell
+    auto add_function = [&](vector<long long> &key,
+                            vector<double> const &corner,
+                            vector<double> const &position,
+                            double radius,
+                            double shape)
+        {
+            for (int d = 0; d < dimension; ++d)
+            {
+                key.push_back(quantize((position[d] - corner[d]) / length));
+            }
+            key.push_back(quantize(radius / length));
+            key.push_back(quantize(shape * length));
+        };
+    
+    // Interior cells with the same size, number of ordinates and function
+    // offsets, in the same order, have the same values at the quadrature points
+    map<vector<long long>, vector<int> > classes;
+    for (int i = 0; i < number_of_cells; ++i)
+    {
+        Integration_Cell const &cell = mesh_->cell(i);
+        vector<double> corner(dimension);
+        vector<long long> key = {cell.number_of_integration_ordinates,
+                                 cell.number_of_weight_functions,
+                                 cell.number_of_basis_functions};
+        for (int d = 0; d < dimension; ++d)
+        {
+            corner[d] = cell.limits[d][0];
+            key.push_back(quantize((cell.limits[d][1] - cell.limits[d][0]) / length));
+        }
+        
+        bool interior = true;
+        for (int w : cell.weight_indices)
+        {
+            shared_ptr<Weight_Function> const weight = weights_[w];
+            if (weight->number_of_boundary_surfaces() > 0
+                || weight->function()->description() != weight_description)
+            {
+                interior = false;
+                break;
+            }
+            add_function(key,
+                         corner,
+                         weight->position(),
+                         weight->radius(),
+                         weight->function()->shape());
+        }
+        for (int b = 0; interior && b < cell.number_of_basis_functions; ++b)
+        {
+            shared_ptr<Basis_Function> const basis = bases_[cell.basis_indices[b]];
+            if (basis->number_of_boundary_surfaces() > 0
+                || basis->function()->description() != basis_description)
+            {
+                interior = false;
+                break;
+            }
+            add_function(key,
+                         corner,
+                         basis->position(),
+                         basis->radius(),
+                         basis->function()->shape());
+        }
+        if (interior)
+        {
+            classes[key].push_back(i);
+        }
+    }
+    
+    // Only classes with more than one cell benefit from a template
+    for (auto const &cell_class : classes)
+    {
+        vector<int> const &cells = cell_class.second;
+        if (cells.size() < 2)
+        {
+            continue;
+        }
+        int const k = template_cells_.size();
+        template_cells_.push_back(cells[0]);
+        for (int i : cells)
+        {
+            cell_template_indices_[i] = k;
+        }
+    }
+}
+
+void Weight_Function_Integration::
+scatter_templates(vector<Weight_Function::Integrals> &integrals) const
+{
+    int const dimension = mesh_->dimension();
+    
     #pragma omp for schedule(dynamic, 10)
     for (int i = 0; i < number_of_points_; ++i)
     {
-        Material_Data const &local_material = local_materials[i];
-        Material_Data &material = materials[i];
+        int const s = template_sources_[i];
+        if (s == i)
+        {
+            continue;
+        }
+        Weight_Function::Integrals const &source = integrals[s];
+        Weight_Function::Integrals &target = integrals[i];
+        vector<int> const &source_order = template_basis_orders_[s];
+        vector<int> const &target_order = template_basis_orders_[i];
+        
+        // Weight integrals
+        target.iv_w[0] = source.iv_w[0];
+        for (int d = 0; d < dimension; ++d)
+        {
+            target.iv_dw[d] = source.iv_dw[d];
+        }
 
-        add_vector_to_total(local_material.sigma_t,
-                            material.sigma_t);
-        add_vector_to_total(local_material.sigma_s,
-                            material.sigma_s);
-        add_vector_to_total(local_material.sigma_f,
-                            material.sigma_f);
-        add_vector_to_total(local_material.internal_source,
-                            material.internal_source);
-        add_vector_to_total(local_material.norm,
-                            material.norm);
-        add_vector_to_total(local_material.boundary_sources,
-                            material.boundary_sources);
+        // Basis/weight integrals, matching basis functions by offset
+        int const number_of_basis_functions = target_order.size();
+        for (int k = 0; k < number_of_basis_functions; ++k)
+        {
+            int const js = source_order[k];
+            int const jt = target_order[k];
+            target.iv_b_w[jt] = source.iv_b_w[js];
+            for (int d1 = 0; d1 < dimension; ++d1)
+            {
+                target.iv_b_dw[d1 + dimension * jt] = source.iv_b_dw[d1 + dimension * js];
+                target.iv_db_w[d1 + dimension * jt] = source.iv_db_w[d1 + dimension * js];
+                for (int d2 = 0; d2 < dimension; ++d2)
+                {
+                    target.iv_db_dw[d1 + dimension * (d2 + dimension * jt)]
+                        = source.iv_db_dw[d1 + dimension * (d2 + dimension * js)];
+                }
+            }
+        }
     }
 }
 
 void Weight_Function_Integration::
-perform_volume_integration(vector<Weight_Function::Integrals> &integrals,
-                           vector<Material_Data> &materials) const
+get_colors(vector<vector<int> > const &entity_points,
+           vector<vector<int> > &colors) const
 {
-    // Integral values should be initialized to zero in perform_integration()
-    #pragma omp for schedule(dynamic, 1)
-    for (int i = 0; i < mesh_->number_of_cells(); ++i)
+    int number_of_entities = entity_points.size();
+    
+    // Colors already assigned to entities that touch each point
+    vector<vector<int> > point_colors(number_of_points_);
+
+    // Last entity for which each color was found to be unavailable
+    vector<int> unavailable;
+    
+    colors.clear();
+    for (int e = 0; e < number_of_entities; ++e)
     {
-        // Get cell data
-        shared_ptr<Integration_Cell> const cell = mesh_->cell(i);
+        vector<int> const &points = entity_points[e];
         
-        // Get quadrature
-        int number_of_ordinates;
-        vector<vector<double> > ordinates;
-        vector<double> weights;
-        mesh_->get_volume_quadrature(i,
-                                     number_of_ordinates,
-                                     ordinates,
-                                     weights);
-        
-        // Get connectivity information
-        vector<vector<int> > weight_basis_indices;
+        // Mark colors of neighboring entities as unavailable
+        for (int p : points)
+        {
+            for (int c : point_colors[p])
+            {
+                unavailable[c] = e;
+            }
+        }
+
+        // Find the first available color, adding a new one if needed
+        int number_of_colors = colors.size();
+        int color = 0;
+        while (color < number_of_colors && unavailable[color] == e)
+        {
+            ++color;
+        }
+        if (color == number_of_colors)
+        {
+            colors.emplace_back();
+            unavailable.push_back(-1);
+        }
+        colors[color].push_back(e);
+
+        // Record color for each point this entity touches
+        for (int p : points)
+        {
+            vector<int> &local_colors = point_colors[p];
+            if (local_colors.empty() || local_colors.back() != color)
+            {
+                local_colors.push_back(color);
+            }
+        }
+    }
+}
+
+void Weight_Function_Integration::
+get_volume_values(int i,
+                  Volume_Values &values) const
+{
+    // Copy the values of the template cell, translating the ordinates
+    int const k = cell_template_indices_[i];
+    if (k >= 0 && k < template_values_.size())
+    {
+        Integration_Cell const &cell = mesh_->cell(i);
+        Integration_Cell const &template_cell = mesh_->cell(template_cells_[k]);
+        int const dimension = mesh_->dimension();
+        values = template_values_[k];
+        for (vector<double> &ordinate : values.ordinates)
+        {
+            for (int d = 0; d < dimension; ++d)
+            {
+                ordinate[d] += cell.limits[d][0] - template_cell.limits[d][0];
+            }
+        }
         mesh_->get_cell_basis_indices(cell,
-                                      weight_basis_indices);
-        
-        // Get center positions
-        vector<vector<double> > weight_centers;
-        vector<vector<double> > basis_centers;
-        mesh_->get_basis_weight_centers(cell,
-                                        basis_centers,
-                                        weight_centers);
+                                      values.weight_basis_indices);
+        mesh_->copy_volume_quadrature(i,
+                                      template_cells_[k]);
+        return;
+    }
+
+    evaluate_volume_values(i,
+                           values);
+}
+
+void Weight_Function_Integration::
+evaluate_volume_values(int i,
+                       Volume_Values &values) const
+{
+    Integration_Cell const &cell = mesh_->cell(i);
+    
+    // Get connectivity information
+    mesh_->get_cell_basis_indices(cell,
+                                  values.weight_basis_indices);
+    
+    // Get center positions
+    vector<vector<double> > weight_centers;
+    vector<vector<double> > basis_centers;
+    mesh_->get_basis_weight_centers(cell,
+                                    basis_centers,
+                                    weight_centers);
         
-        for (int q = 0; q < number_of_ordinates; ++q)
+    // Get quadrature and basis/weight values at all quadrature points,
+    // refining the quadrature of the cell if it is error-controlled
+    Integration_Cell_Values cell_values;
+    mesh_->get_volume_values(i,
+                             basis_centers,
+                             weight_centers,
+                             values.weight_basis_indices,
+                             cell_values);
+    values.ordinates = std::move(cell_values.ordinates);
+    values.weights = std::move(cell_values.weights);
+    values.b_vals = std::move(cell_values.b_val);
+    values.b_grads = std::move(cell_values.b_grad);
+    values.w_vals = std::move(cell_values.w_val);
+    values.w_grads = std::move(cell_values.w_grad);
+}
+
+void Weight_Function_Integration::
+perform_volume_integration(bool calculate_integrals,
+                           vector<Weight_Function::Integrals> &integrals,
+                           vector<Material_Data> &materials)
+{
+    // Values are either stored from a previous call or calculated here
+    bool const use_stored_values = values_stored_;
+    bool const store_values = !values_stored_ && options_->store_quadrature_values;
+    #pragma omp single
+    if (store_values)
+    {
+        volume_values_.resize(mesh_->number_of_cells());
+    }
+
+    // Evaluate the values for each template cell once
+    int const number_of_templates = use_stored_values ? 0 : template_cells_.size();
+    #pragma omp single
+    template_values_.resize(number_of_templates);
+    #pragma omp for schedule(dynamic, 1)
+    for (int k = 0; k < number_of_templates; ++k)
+    {
+        evaluate_volume_values(template_cells_[k],
+                               template_values_[k]);
+    }
+    
+    // Integral values should be initialized to zero in perform_integration()
+    for (vector<int> const &color : cell_colors_)
+    {
+        int number_in_color = color.size();
+
+        // Entities of one color share no points, so no synchronization is needed
+        #pragma omp for schedule(dynamic, 1)
+        for (int j = 0; j < number_in_color; ++j)
         {
-            // Get position
-            vector<double> const &position = ordinates[q];
-
-            // Get material and basis/weight values at quadrature point
-            vector<double> b_val;
-            vector<vector<double> > b_grad;
-            vector<double> w_val;
-            vector<vector<double> > w_grad;
-            mesh_->get_volume_values(cell,
-                                     position,
-                                     basis_centers,
-                                     weight_centers,
-                                     b_val,
-                                     b_grad,
-                                     w_val,
-                                     w_grad);
-            shared_ptr<Material> point_material = solid_->material(position);
+            int i = color[j];
+
+            // Get cell data
+            Integration_Cell const &cell = mesh_->cell(i);
+
+            // Get quadrature and basis/weight values
+            Volume_Values local_values;
+            if (!use_stored_values)
+            {
+                get_volume_values(i,
+                                  local_values);
+            }
+            Volume_Values const &values = use_stored_values ? volume_values_[i] : local_values;
+            int number_of_ordinates = values.weights.size();
+            int const dimension = mesh_->dimension();
+            int const number_of_weights = cell.number_of_weight_functions;
+            int const number_of_bases = cell.number_of_basis_functions;
+            
+            for (int q = 0; q < number_of_ordinates; ++q)
+            {
+                // Get position
+                vector<double> const &position = values.ordinates[q];
+                double const weight = values.weights[q];
+
+                // Get material and basis/weight values at quadrature point
+                double const *b_val = &values.b_vals[number_of_bases * q];
+                double const *w_val = &values.w_vals[number_of_weights * q];
+                double const *w_grad = &values.w_grads[dimension * number_of_weights * q];
+                shared_ptr<Material> point_material = solid_->material(position);
             
-            // Add these values to the overall integrals
-            add_volume_weight(cell,
-                              weights[q],
-                              w_val,
-                              w_grad,
-                              integrals);
-            add_volume_basis_weight(cell,
-                                    weights[q],
+                // Add geometric integrals, which do not depend on the materials
+                if (calculate_integrals)
+                {
+                    double const *b_grad = &values.b_grads[dimension * number_of_bases * q];
+                    add_volume_weight(cell,
+                                      weight,
+                                      w_val,
+                                      w_grad,
+                                      integrals);
+                    add_volume_basis_weight(cell,
+                                            weight,
+                                            b_val,
+                                            b_grad,
+                                            w_val,
+                                            w_grad,
+                                            values.weight_basis_indices,
+                                            integrals);
+                }
+
+                // Add material integrals
+                add_volume_material(cell,
+                                    weight,
                                     b_val,
-                                    b_grad,
                                     w_val,
                                     w_grad,
-                                    weight_basis_indices,
-                                    integrals);
-            add_volume_material(cell,
-                                weights[q],
-                                b_val,
-                                w_val,
-                                w_grad,
-                                weight_basis_indices,
-                                point_material,
-                                materials);
+                                    values.weight_basis_indices,
+                                    point_material,
+                                    materials);
+            }
+
+            // Keep the values needed for the material integrals
+            if (store_values)
+            {
+                local_values.b_grads.clear();
+                volume_values_[i] = std::move(local_values);
+            }
         }
     }
+
+    // The omp for above ends with a barrier, so no thread still reads the templates
+    #pragma omp single
+    template_values_.clear();
 }
 
 void Weight_Function_Integration::
@@ -375,45 +1048,54 @@ normalize_materials(vector<Material_Data> &materials) const
 }
 
 void Weight_Function_Integration::
-add_volume_weight(shared_ptr<Integration_Cell> const cell,
+add_volume_weight(Integration_Cell const &cell,
                   double quad_weight,
-                  vector<double> const &w_val,
-                  vector<vector<double> > const &w_grad,
+                  double const *w_val,
+                  double const *w_grad,
                   vector<Weight_Function::Integrals> &integrals) const
 {
-    for (int i = 0; i < cell->number_of_weight_functions; ++i)
+    int dimension = mesh_->dimension();
+    for (int i = 0; i < cell.number_of_weight_functions; ++i)
     {
-        // Add weight integral
-        int w_ind = cell->weight_indices[i];
+        // Add weight integral, unless it is copied from a template
+        int w_ind = cell.weight_indices[i];
+        if (template_sources_[w_ind] != w_ind)
+        {
+            continue;
+        }
         integrals[w_ind].iv_w[0] += quad_weight * w_val[i];
 
         // Add derivative of weight integral
-        for (int d = 0; d < mesh_->dimension(); ++d)
+        for (int d = 0; d < dimension; ++d)
         {
-            integrals[w_ind].iv_dw[d] += quad_weight * w_grad[i][d];
+            integrals[w_ind].iv_dw[d] += quad_weight * w_grad[d + dimension * i];
         }
     }
 }
 
 void Weight_Function_Integration::
-add_volume_basis_weight(shared_ptr<Integration_Cell> const cell,
+add_volume_basis_weight(Integration_Cell const &cell,
                         double quad_weight,
-                        vector<double> const &b_val,
-                        vector<vector<double> > const &b_grad,
-                        vector<double> const &w_val,
-                        vector<vector<double> > const &w_grad,
+                        double const *b_val,
+                        double const *b_grad,
+                        double const *w_val,
+                        double const *w_grad,
                         vector<vector<int> > const &weight_basis_indices,
                         vector<Weight_Function::Integrals> &integrals) const
 {
     int dimension = mesh_->dimension();
-    for (int i = 0; i < cell->number_of_weight_functions; ++i)
+    for (int i = 0; i < cell.number_of_weight_functions; ++i)
     {
-        // Add weight integral
-        int w_ind = cell->weight_indices[i];
+        // Add weight integral, unless it is copied from a template
+        int w_ind = cell.weight_indices[i];
+        if (template_sources_[w_ind] != w_ind)
+        {
+            continue;
+        }
         
-        for (int j = 0; j < cell->number_of_basis_functions; ++j)
+        for (int j = 0; j < cell.number_of_basis_functions; ++j)
         {
-            int b_ind = cell->basis_indices[j];
+            int b_ind = cell.basis_indices[j];
             int w_b_ind = weight_basis_indices[i][j];
             
             if (w_b_ind != Weight_Function::Errors::DOES_NOT_EXIST)
@@ -427,15 +1109,15 @@ add_volume_basis_weight(shared_ptr<Integration_Cell> const cell,
                 {
                     int k1 = d1 + dimension * w_b_ind;
                     integrals[w_ind].iv_b_dw[k1]
-                        += quad_weight * w_grad[i][d1] * b_val[j];
+                        += quad_weight * w_grad[d1 + dimension * i] * b_val[j];
                     integrals[w_ind].iv_db_w[k1]
-                        += quad_weight * w_val[i] * b_grad[j][d1];
+                        += quad_weight * w_val[i] * b_grad[d1 + dimension * j];
 
                     for (int d2 = 0; d2 < dimension; ++d2)
                     {
                         int k2 = d1 + dimension * (d2 + dimension * w_b_ind);
                         integrals[w_ind].iv_db_dw[k2]
-                            += quad_weight * w_grad[i][d2] * b_grad[j][d1];
+                            += quad_weight * w_grad[d2 + dimension * i] * b_grad[d1 + dimension * j];
                     }
                 }
             }
@@ -481,11 +1163,11 @@ get_cross_sections(shared_ptr<Material> material,
 }
 
 void Weight_Function_Integration::
-add_volume_material(shared_ptr<Integration_Cell> const cell,
+add_volume_material(Integration_Cell const &cell,
                     double quad_weight,
-                    vector<double> const &b_val,
-                    vector<double> const &w_val,
-                    vector<vector<double> > const &w_grad,
+                    double const *b_val,
+                    double const *w_val,
+                    double const *w_grad,
                     vector<vector<int> > const &weight_basis_indices,
                     shared_ptr<Material> point_material,
                     vector<Material_Data> &materials) const
@@ -521,6 +1203,7 @@ add_volume_material(shared_ptr<Integration_Cell> const cell,
     }
 
     // Get data
+    int dimension = mesh_->dimension();
     int number_of_dimensional_moments = weights_[0]->dimensional_moments()->number_of_dimensional_moments();
     
     // Add value to each of the weight functions
@@ -530,15 +1213,15 @@ add_volume_material(shared_ptr<Integration_Cell> const cell,
         AssertMsg(false, "point weighting not compatible with external integration");
         break;
     case Weak_Spatial_Discretization_Options::Weighting::FLAT:
-        for (int i = 0; i < cell->number_of_weight_functions; ++i)
+        for (int i = 0; i < cell.number_of_weight_functions; ++i)
         {
             // Get weight function data
-            int w_ind = cell->weight_indices[i];
+            int w_ind = cell.weight_indices[i];
             Material_Data &material = materials[w_ind];
         
             for (int d = 0; d < number_of_dimensional_moments; ++d)
             {
-                double wid = d == 0 ? w_val[i] : w_grad[i][d - 1];
+                double wid = d == 0 ? w_val[i] : w_grad[d - 1 + dimension * i];
 
                 // Norm 
                 material.norm[d] += wid * quad_weight;
@@ -575,15 +1258,15 @@ add_volume_material(shared_ptr<Integration_Cell> const cell,
         }
         break;
     case Weak_Spatial_Discretization_Options::Weighting::FLUX:
-        for (int i = 0; i < cell->number_of_weight_functions; ++i)
+        for (int i = 0; i < cell.number_of_weight_functions; ++i)
         {
             // Get weight function data
-            int w_ind = cell->weight_indices[i];
+            int w_ind = cell.weight_indices[i];
             Material_Data &material = materials[w_ind];
         
             for (int d = 0; d < number_of_dimensional_moments; ++d)
             {
-                double wid = d == 0 ? w_val[i] : w_grad[i][d - 1];
+                double wid = d == 0 ? w_val[i] : w_grad[d - 1 + dimension * i];
 
                 // Internal source
                 for (int s = 0; s < internal_size; ++s)
@@ -631,15 +1314,15 @@ add_volume_material(shared_ptr<Integration_Cell> const cell,
         }
         break;
     case Weak_Spatial_Discretization_Options::Weighting::FULL:
-        for (int i = 0; i < cell->number_of_weight_functions; ++i)
+        for (int i = 0; i < cell.number_of_weight_functions; ++i)
         {
             // Get weight function data
-            int w_ind = cell->weight_indices[i];
+            int w_ind = cell.weight_indices[i];
             Material_Data &material = materials[w_ind];
         
             for (int d = 0; d < number_of_dimensional_moments; ++d)
             {
-                double wid = d == 0 ? w_val[i] : w_grad[i][d - 1];
+                double wid = d == 0 ? w_val[i] : w_grad[d - 1 + dimension * i];
 
                 // Internal source (does not depend on basis functions)
                 for (int s = 0; s < internal_size; ++s)
@@ -650,9 +1333,9 @@ add_volume_material(shared_ptr<Integration_Cell> const cell,
                 }
                 
                 // Material integrals that depend on basis function
-                for (int j = 0; j < cell->number_of_basis_functions; ++j)
+                for (int j = 0; j < cell.number_of_basis_functions; ++j)
                 {
-                    int b_ind = cell->basis_indices[j];
+                    int b_ind = cell.basis_indices[j];
                     int w_b_ind = weight_basis_indices[i][j];
                     
                     if (w_b_ind != Weight_Function::Errors::DOES_NOT_EXIST)
@@ -684,15 +1367,15 @@ add_volume_material(shared_ptr<Integration_Cell> const cell,
         break;
     case Weak_Spatial_Discretization_Options::Weighting::BASIS:
         // Perform internal source integration
-        for (int i = 0; i < cell->number_of_weight_functions; ++i)
+        for (int i = 0; i < cell.number_of_weight_functions; ++i)
         {
             // Get weight function data
-            int w_ind = cell->weight_indices[i];
+            int w_ind = cell.weight_indices[i];
             Material_Data &material = materials[w_ind];
             
             for (int d = 0; d < number_of_dimensional_moments; ++d)
             {
-                double wid = d == 0 ? w_val[i] : w_grad[i][d - 1];
+                double wid = d == 0 ? w_val[i] : w_grad[d - 1 + dimension * i];
 
                 // Internal source
                 for (int s = 0; s < internal_size; ++s)
@@ -705,10 +1388,10 @@ add_volume_material(shared_ptr<Integration_Cell> const cell,
         }
 
         // Perform cross section integration
-        for (int i = 0; i < cell->number_of_basis_functions; ++i)
+        for (int i = 0; i < cell.number_of_basis_functions; ++i)
         {
             // Get basis function data
-            int b_ind = cell->basis_indices[i];
+            int b_ind = cell.basis_indices[i];
             Material_Data &material = materials[b_ind];
             double bas = b_val[i];
 
@@ -748,78 +1431,128 @@ add_volume_material(shared_ptr<Integration_Cell> const cell,
 }
 
 void Weight_Function_Integration::
-perform_surface_integration(vector<Weight_Function::Integrals> &integrals,
-                            std::vector<Material_Data> &materials) const
+get_surface_values(int i,
+                   Surface_Values &values) const
 {
+    shared_ptr<Integration_Surface> const surface = mesh_->surface(i);
+
+    // Get local weight function indices for this surface
+    mesh_->get_weight_surface_indices(surface,
+                                      values.weight_surface_indices);
+
+    // Get local basis function indices for all weights
+    mesh_->get_surface_basis_indices(surface,
+                                     values.weight_basis_indices);
+        
+    // Get quadrature
+    int number_of_ordinates;
+    mesh_->get_surface_quadrature(i,
+                                  number_of_ordinates,
+                                  values.ordinates,
+                                  values.weights);
+
+    // Get centers
+    vector<vector<double> > weight_centers;
+    vector<vector<double> > basis_centers;
+    mesh_->get_basis_weight_centers(surface,
+                                    basis_centers,
+                                    weight_centers);
+
+    // Get basis/weight values at quadrature points
+    values.b_vals.resize(number_of_ordinates);
+    values.w_vals.resize(number_of_ordinates);
+    for (int q = 0; q < number_of_ordinates; ++q)
+    {
+        mesh_->get_surface_values(surface,
+                                  values.ordinates[q],
+                                  basis_centers,
+                                  weight_centers,
+                                  values.b_vals[q],
+                                  values.w_vals[q]);
+    }
+}
+
+void Weight_Function_Integration::
+perform_surface_integration(bool calculate_integrals,
+                            vector<Weight_Function::Integrals> &integrals,
+                            vector<Material_Data> &materials)
+{
+    // Values are either stored from a previous call or calculated here
+    bool const use_stored_values = values_stored_;
+    bool const store_values = !values_stored_ && options_->store_quadrature_values;
+    #pragma omp single
+    if (store_values)
+    {
+        surface_values_.resize(mesh_->number_of_surfaces());
+    }
+    
     // Integral values should be initialized to zero in perform_integration()
-    #pragma omp for schedule(dynamic, 1)
-    for (int i = 0; i < mesh_->number_of_surfaces(); ++i)
+    for (vector<int> const &color : surface_colors_)
     {
-        // Get surface data
-        shared_ptr<Integration_Surface> const surface = mesh_->surface(i);
+        int number_in_color = color.size();
 
-        // Get local weight function indices for this surface
-        vector<int> weight_surface_indices;
-        mesh_->get_weight_surface_indices(surface,
-                                          weight_surface_indices);
+        // Entities of one color share no points, so no synchronization is needed
+        #pragma omp for schedule(dynamic, 1)
+        for (int j = 0; j < number_in_color; ++j)
+        {
+            int i = color[j];
 
-        // Get local basis function indices for all weights
-        vector<vector<int> > weight_basis_indices;
-        mesh_->get_surface_basis_indices(surface,
-                                         weight_basis_indices);
-        
-        // Get quadrature
-        int number_of_ordinates;
-        vector<vector<double> > ordinates;
-        vector<double> weights;
-        mesh_->get_surface_quadrature(i,
-                                      number_of_ordinates,
-                                      ordinates,
-                                      weights);
+            // Get surface data
+            shared_ptr<Integration_Surface> const surface = mesh_->surface(i);
 
-        // Get centers
-        vector<vector<double> > weight_centers;
-        vector<vector<double> > basis_centers;
-        mesh_->get_basis_weight_centers(surface,
-                                        basis_centers,
-                                        weight_centers);
+            // Get quadrature and basis/weight values
+            Surface_Values local_values;
+            if (!use_stored_values)
+            {
+                get_surface_values(i,
+                                   local_values);
+            }
+            Surface_Values const &values = use_stored_values ? surface_values_[i] : local_values;
+            int number_of_ordinates = values.weights.size();
         
-        for (int q = 0; q < number_of_ordinates; ++q)
-        {
-            // Get position
-            vector<double> const &position = ordinates[q];
+            for (int q = 0; q < number_of_ordinates; ++q)
+            {
+                // Get position
+                vector<double> const &position = values.ordinates[q];
+                double const weight = values.weights[q];
             
-            // Get basis/weight values at quadrature point
-            vector<double> b_val;
-            vector<double> w_val;
-            mesh_->get_surface_values(surface,
-                                      position,
-                                      basis_centers,
-                                      weight_centers,
-                                      b_val,
-                                      w_val);
-            shared_ptr<Boundary_Source> boundary_source
-                = solid_->boundary_source(position);
-
-            // Perform integration
-            add_surface_weight(surface,
-                               weights[q],
-                               w_val,
-                               weight_surface_indices,
-                               integrals);
-            add_surface_basis_weight(surface,
-                                     weights[q],
-                                     b_val,
-                                     w_val,
-                                     weight_surface_indices,
-                                     weight_basis_indices,
-                                     integrals);
-            add_surface_source(surface,
-                               weights[q],
-                               w_val,
-                               weight_surface_indices,
-                               boundary_source,
-                               materials);
+                // Get weight values at quadrature point
+                vector<double> const &w_val = values.w_vals[q];
+                shared_ptr<Boundary_Source> boundary_source
+                    = solid_->boundary_source(position);
+
+                // Perform integration
+                if (calculate_integrals)
+                {
+                    vector<double> const &b_val = values.b_vals[q];
+                    add_surface_weight(surface,
+                                       weight,
+                                       w_val,
+                                       values.weight_surface_indices,
+                                       integrals);
+                    add_surface_basis_weight(surface,
+                                             weight,
+                                             b_val,
+                                             w_val,
+                                             values.weight_surface_indices,
+                                             values.weight_basis_indices,
+                                             integrals);
+                }
+                add_surface_source(surface,
+                                   weight,
+                                   w_val,
+                                   values.weight_surface_indices,
+                                   boundary_source,
+                                   materials);
+            }
+
+            // Keep the values needed for the material integrals
+            if (store_values)
+            {
+                local_values.b_vals.clear();
+                local_values.weight_basis_indices.clear();
+                surface_values_[i] = std::move(local_values);
+            }
         }
     }
 }
@@ -917,7 +1650,7 @@ add_surface_source(shared_ptr<Integration_Surface> const surface,
 }
 
 void Weight_Function_Integration::
-put_integrals_into_weight(vector<Weight_Function::Integrals> const &integrals,
+put_integrals_into_weight(vector<Weight_Function::Integrals> &integrals,
                           vector<Material_Data> const &material_data)
 {
     #pragma omp for schedule(dynamic, 10)
@@ -936,7 +1669,7 @@ put_integrals_into_weight(vector<Weight_Function::Integrals> const &integrals,
                              boundary_sources);
         
         // Set the integrals to the weight functions
-        weights_[i]->set_integrals(integrals[i],
+        weights_[i]->set_integrals(std::move(integrals[i]),
                                    material,
                                    boundary_sources);
     }
@@ -1099,21 +1832,26 @@ get_material(int index,
 void Weight_Function_Integration::
 initialize_integrals(vector<Weight_Function::Integrals> &integrals) const
 {
-    integrals.resize(number_of_points_);
+    // Allocate all integrals in a single zeroed block
+    vector<int> number_of_basis_functions(number_of_points_);
+    vector<int> number_of_boundary_surfaces(number_of_points_);
     for (int i = 0; i < number_of_points_; ++i)
     {
         shared_ptr<Weight_Function> weight = weights_[i];
-        int number_of_boundary_surfaces = weight->number_of_boundary_surfaces();
-        int number_of_basis_functions = weight->number_of_basis_functions();
-        Weight_Function::Integrals &local_integrals = integrals[i];
-        local_integrals.is_w.assign(number_of_boundary_surfaces, 0.);
-        local_integrals.is_b_w.assign(number_of_boundary_surfaces * number_of_basis_functions, 0);
-        local_integrals.iv_w.assign(1, 0.);
-        local_integrals.iv_dw.assign(mesh_->dimension(), 0);
-        local_integrals.iv_b_w.assign(number_of_basis_functions, 0);
-        local_integrals.iv_b_dw.assign(number_of_basis_functions * mesh_->dimension(), 0);
-        local_integrals.iv_db_w.assign(number_of_basis_functions * mesh_->dimension(), 0);
-        local_integrals.iv_db_dw.assign(number_of_basis_functions * mesh_->dimension() * mesh_->dimension(), 0);
+        number_of_basis_functions[i] = weight->number_of_basis_functions();
+        number_of_boundary_surfaces[i] = weight->number_of_boundary_surfaces();
+    }
+    shared_ptr<Integral_Arena> arena
+        = make_shared<Integral_Arena>(mesh_->dimension(),
+                                      number_of_basis_functions,
+                                      number_of_boundary_surfaces);
+
+    // Get views into the block for each weight function
+    integrals.resize(number_of_points_);
+    for (int i = 0; i < number_of_points_; ++i)
+    {
+        arena->get_integrals(i,
+                             integrals[i]);
     }
 }
 
@@ -1208,8 +1946,8 @@ initialize_materials(vector<Material_Data> &materials) const
 }
 
 void Weight_Function_Integration::
-get_flux(shared_ptr<Integration_Cell> const cell,
-         vector<double> const &b_val,
+get_flux(Integration_Cell const &cell,
+         double const *b_val,
          vector<double> &flux) const
 {
     // Get size information
@@ -1223,9 +1961,9 @@ get_flux(shared_ptr<Integration_Cell> const cell,
     // Calculate flux
     flux.assign(number_of_groups * number_of_moments, 0.);
     int const m0 = 0;
-    for (int i = 0; i < cell->number_of_basis_functions; ++i)
+    for (int i = 0; i < cell.number_of_basis_functions; ++i)
     {
-        int const j = cell->basis_indices[i];
+        int const j = cell.basis_indices[i];
         for (int g = 0; g < number_of_groups; ++g)
         {
             int const k_sf = g + number_of_groups * (m0 + number_of_moments * j); // global scalar flux coefficient index
@@ -1251,3 +1989,32 @@ get_total_max_points() const
 {
     return mesh_->get_total_max_points();
 }
+
+int Weight_Function_Integration::
+number_of_weight_template_copies() const
+{
+    int number_of_copies = 0;
+    for (int i = 0; i < number_of_points_; ++i)
+    {
+        if (template_sources_[i] != i)
+        {
+            number_of_copies += 1;
+        }
+    }
+    return number_of_copies;
+}
+
+int Weight_Function_Integration::
+number_of_cell_template_copies() const
+{
+    int number_of_copies = 0;
+    for (int i = 0; i < static_cast<int>(cell_template_indices_.size()); ++i)
+    {
+        int const k = cell_template_indices_[i];
+        if (k >= 0 && template_cells_[k] != i)
+        {
+            number_of_copies += 1;
+        }
+    }
+    return number_of_copies;
+}
@@ -1,7 +1,9 @@
 #ifndef Weight_Function_Integration_hh
 #define Weight_Function_Integration_hh
 
+#include <cstdint>
 #include <memory>
+#include <string>
 #include <vector>
 
 #include "Integration_Mesh.hh"
@@ -11,6 +13,7 @@ class Angular_Discretization;
 class Basis_Function;
 class Energy_Discretization;
 class Material;
+class Solid_Geometry;
 class Weak_Spatial_Discretization_Options;
 class Weight_Function;
 
@@ -37,65 +40,143 @@ public:
     
     // Perform integration and put result into weight functions
     void perform_integration();
+
+    // Integrate only the materials for a new solid geometry, using the
+    // quadrature values stored by perform_integration() if available
+    void perform_material_integration(std::shared_ptr<Solid_Geometry> solid);
     
     // Get data from integration mesh
     std::vector<int> get_total_max_points() const;
+
+    // Number of weight functions and cells whose values are copied from a
+    // lattice template rather than calculated
+    int number_of_weight_template_copies() const;
+    int number_of_cell_template_copies() const;
     
 private:
 
+    // Quadrature and basis/weight values for a cell, stored as
+    // vals[i + number_of_functions * q] and
+    // grads[d + dimension * (i + number_of_functions * q)]
+    struct Volume_Values
+    {
+        std::vector<std::vector<double> > ordinates;
+        std::vector<double> weights;
+        std::vector<std::vector<int> > weight_basis_indices;
+        std::vector<double> b_vals;
+        std::vector<double> b_grads;
+        std::vector<double> w_vals;
+        std::vector<double> w_grads;
+    };
+
+    // Quadrature and basis/weight values for a surface
+    struct Surface_Values
+    {
+        std::vector<std::vector<double> > ordinates;
+        std::vector<double> weights;
+        std::vector<int> weight_surface_indices;
+        std::vector<std::vector<int> > weight_basis_indices;
+        std::vector<std::vector<double> > b_vals;
+        std::vector<std::vector<double> > w_vals;
+    };
+    
+    // Hash of everything the integrals depend on, used as the cache key
+    std::uint64_t get_integral_key() const;
+
+    // Hash of the integral key and the materials and boundary sources at
+    // the quadrature points, used as the key for the material cache
+    std::uint64_t get_material_key(std::uint64_t integral_key) const;
+
+    // Read or write the normalized material integrals
+    bool read_materials(std::string const &filename,
+                        std::uint64_t key,
+                        std::vector<Material_Data> &materials) const;
+    bool write_materials(std::string const &filename,
+                         std::uint64_t key,
+                         std::vector<Material_Data> const &materials) const;
+    void pack_materials(std::vector<Material_Data> const &materials,
+                        std::vector<double> &data) const;
+    
+    // Find interior weight functions whose geometric integrals are a
+    // translation of an earlier weight function's integrals
+    void initialize_templates();
+
+    // Find interior cells whose functions are a translation of those of
+    // another cell, so the values at the quadrature points are evaluated
+    // once for each such class
+    void initialize_cell_templates(double length,
+                                   std::string const &weight_description,
+                                   std::string const &basis_description);
+
+    // Copy the template integrals to the translated weight functions
+    void scatter_templates(std::vector<Weight_Function::Integrals> &integrals) const;
+    
+    // Color cells and surfaces for parallel integration
+    void initialize_colors();
+    
+    // Greedily color entities so no two entities of a color share a point
+    void get_colors(std::vector<std::vector<int> > const &entity_points,
+                    std::vector<std::vector<int> > &colors) const;
+    
     // Put volume, surface and material integrals into weight functions
-    void put_integrals_into_weight(std::vector<Weight_Function::Integrals> const &integrals,
+    void put_integrals_into_weight(std::vector<Weight_Function::Integrals> &integrals,
                                    std::vector<Material_Data> const &materials);
     
-    // Perform all volume integrals
-    void perform_volume_integration(std::vector<Weight_Function::Integrals> &integrals,
-                                    std::vector<Material_Data> &materials) const;
+    // Get quadrature and basis/weight values for a cell, copying them from
+    // the template cell if available
+    void get_volume_values(int i,
+                           Volume_Values &values) const;
+
+    // Get quadrature and basis/weight values for a cell without templates
+    void evaluate_volume_values(int i,
+                                Volume_Values &values) const;
+    
+    // Perform all volume integrals, skipping the geometric integrals if
+    // calculate_integrals is false
+    void perform_volume_integration(bool calculate_integrals,
+                                    std::vector<Weight_Function::Integrals> &integrals,
+                                    std::vector<Material_Data> &materials);
 
     // Normalize the material integrals, if applicable
     void normalize_materials(std::vector<Material_Data> &materials) const;
     
-    // Add weight function cell values to global integrals
-    void add_volume_weight(std::shared_ptr<Integration_Cell> const cell,
+    // Add weight function cell values at one quadrature point to global
+    // integrals, with values and gradients stored as in Volume_Values
+    void add_volume_weight(Integration_Cell const &cell,
                            double quad_weight,
-                           std::vector<double> const &w_val,
-                           std::vector<std::vector<double> > const &w_grad,
+                           double const *w_val,
+                           double const *w_grad,
                            std::vector<Weight_Function::Integrals> &integrals) const;
 
     // Add basis/weight function cell values to global integrals
-    void add_volume_basis_weight(std::shared_ptr<Integration_Cell> const cell,
+    void add_volume_basis_weight(Integration_Cell const &cell,
                                  double quad_weight,
-                                 std::vector<double> const &b_val,
-                                 std::vector<std::vector<double> > const &b_grad,
-                                 std::vector<double> const &w_val,
-                                 std::vector<std::vector<double> > const &w_grad,
+                                 double const *b_val,
+                                 double const *b_grad,
+                                 double const *w_val,
+                                 double const *w_grad,
                                  std::vector<std::vector<int> > const &weight_basis_indices,
                                  std::vector<Weight_Function::Integrals> &integrals) const;
 
     // Add material cell values to global integrals
-    void add_volume_material(std::shared_ptr<Integration_Cell> const cell,
+    void add_volume_material(Integration_Cell const &cell,
                              double quad_weight,
-                             std::vector<double> const &b_val,
-                             std::vector<double> const &w_val,
-                             std::vector<std::vector<double> > const &w_grad,
+                             double const *b_val,
+                             double const *w_val,
+                             double const *w_grad,
                              std::vector<std::vector<int> > const &weight_basis_indices,
                              std::shared_ptr<Material> point_material,
                              std::vector<Material_Data> &materials) const;
 
-    // Add local vector to total vector
-    void add_vector_to_total(std::vector<double> const &local_data,
-                             std::vector<double> &data);
-    
-    // Add local integrals to global integrals (for parallel)
-    void add_integral_sets(std::vector<Weight_Function::Integrals> const &local_integrals,
-                           std::vector<Weight_Function::Integrals> &integrals);
-
-    // Add local materials to global materials (for parallel)
-    void add_material_sets(std::vector<Material_Data> const &local_materials,
-                           std::vector<Material_Data> &materials);
+    // Get quadrature and basis/weight values for a surface
+    void get_surface_values(int i,
+                            Surface_Values &values) const;
     
-    // Perform all surface integrals
-    void perform_surface_integration(std::vector<Weight_Function::Integrals> &integrals,
-                                     std::vector<Material_Data> &materials) const;
+    // Perform all surface integrals, skipping the geometric integrals if
+    // calculate_integrals is false
+    void perform_surface_integration(bool calculate_integrals,
+                                     std::vector<Weight_Function::Integrals> &integrals,
+                                     std::vector<Material_Data> &materials);
 
     // Add boundary source integral to global integrals
     void add_surface_source(std::shared_ptr<Integration_Surface> const surface,
@@ -139,8 +220,8 @@ private:
                               std::vector<std::shared_ptr<Boundary_Source> > &boundary_sources) const;
     
     // Get the flux for a specific point, given basis coefficients
-    void get_flux(std::shared_ptr<Integration_Cell> const cell,
-                  std::vector<double> const &b_val,
+    void get_flux(Integration_Cell const &cell,
+                  double const *b_val,
                   std::vector<double> &flux) const;
     
     // Initialize material data to zero
@@ -158,7 +239,18 @@ private:
     std::shared_ptr<Solid_Geometry> solid_;
     std::shared_ptr<Angular_Discretization> angular_;
     std::shared_ptr<Energy_Discretization> energy_;
+    std::shared_ptr<Integration_Mesh_Options> integration_options_;
     std::shared_ptr<Integration_Mesh> mesh_;
+    std::vector<int> template_sources_; // weight function integrated for each weight function
+    std::vector<std::vector<int> > template_basis_orders_; // local basis indices sorted by offset
+    std::vector<int> cell_template_indices_; // template for each cell, or -1
+    std::vector<int> template_cells_; // cell evaluated for each template
+    std::vector<Volume_Values> template_values_; // values of each template during integration
+    std::vector<std::vector<int> > cell_colors_;
+    std::vector<std::vector<int> > surface_colors_;
+    bool values_stored_ = false;
+    std::vector<Volume_Values> volume_values_;
+    std::vector<Surface_Values> surface_values_;
 };
     
 #endif
@@ -87,3 +87,105 @@ dd_value(double r) const
     
     return 0;
 }
+
+void Wendland1_RBF::
+batch_values(int number_of_points,
+             double const *r,
+             double *values) const
+{
+    // t is zero outside the support, which zeroes each polynomial
+    switch (order_)
+    {
+    case 0:
+        #pragma omp simd
+        for (int i = 0; i < number_of_points; ++i)
+        {
+            double const s = std::abs(r[i]);
+            double const t = s <= 1 ? 1 - s : 0.;
+            values[i] = t;
+        }
+        break;
+    case 1:
+        #pragma omp simd
+        for (int i = 0; i < number_of_points; ++i)
+        {
+            double const s = std::abs(r[i]);
+            double const t = s <= 1 ? 1 - s : 0.;
+            values[i] = t * t * t * (1 + 3 * s);
+        }
+        break;
+    case 2:
+        #pragma omp simd
+        for (int i = 0; i < number_of_points; ++i)
+        {
+            double const s = std::abs(r[i]);
+            double const t = s <= 1 ? 1 - s : 0.;
+            values[i] = t * t * t * t * t * (1 + 5 * s + 8 * s * s);
+        }
+        break;
+    case 3:
+        #pragma omp simd
+        for (int i = 0; i < number_of_points; ++i)
+        {
+            double const s = std::abs(r[i]);
+            double const t = s <= 1 ? 1 - s : 0.;
+            values[i] = t * t * t * t * t * t * t * (1 + 7 * s + 19 * s * s + 21 * s * s * s);
+        }
+        break;
+    default:
+        AssertMsg(false, "order \"" + to_string(order_) + "\" not implemented");
+    }
+}
+
+void Wendland1_RBF::
+batch_gradient_values(int number_of_points,
+                      double const *r,
+                      double *values,
+                      double *d_values) const
+{
+    switch (order_)
+    {
+    case 0:
+        #pragma omp simd
+        for (int i = 0; i < number_of_points; ++i)
+        {
+            double const s = std::abs(r[i]);
+            double const t = s <= 1 ? 1 - s : 0.;
+            values[i] = t;
+            d_values[i] = s <= 1 ? -1. : 0.;
+        }
+        break;
+    case 1:
+        #pragma omp simd
+        for (int i = 0; i < number_of_points; ++i)
+        {
+            double const s = std::abs(r[i]);
+            double const t = s <= 1 ? 1 - s : 0.;
+            values[i] = t * t * t * (1 + 3 * s);
+            d_values[i] = -12 * t * t * s;
+        }
+        break;
+    case 2:
+        #pragma omp simd
+        for (int i = 0; i < number_of_points; ++i)
+        {
+            double const s = std::abs(r[i]);
+            double const t = s <= 1 ? 1 - s : 0.;
+            values[i] = t * t * t * t * t * (1 + 5 * s + 8 * s * s);
+            d_values[i] = -14 * t * t * t * t * s * (1 + 4 * s);
+        }
+        break;
+    case 3:
+        #pragma omp simd
+        for (int i = 0; i < number_of_points; ++i)
+        {
+            double const s = std::abs(r[i]);
+            double const t = s <= 1 ? 1 - s : 0.;
+            values[i] = t * t * t * t * t * t * t * (1 + 7 * s + 19 * s * s + 21 * s * s * s);
+            d_values[i] = -6 * t * t * t * t * t * t * s * (3 + 18 * s + 35 * s * s);
+        }
+        break;
+    default:
+        AssertMsg(false, "order \"" + to_string(order_) + "\" not implemented");
+    }
+}
@@ -87,3 +87,105 @@ dd_value(double r) const
     
     return 0;
 }
+
+void Wendland3_RBF::
+batch_values(int number_of_points,
+             double const *r,
+             double *values) const
+{
+    // t is zero outside the support, which zeroes each polynomial
+    switch (order_)
+    {
+    case 0:
+        #pragma omp simd
+        for (int i = 0; i < number_of_points; ++i)
+        {
+            double const s = std::abs(r[i]);
+            double const t = s <= 1 ? 1 - s : 0.;
+            values[i] = t * t;
+        }
+        break;
+    case 1:
+        #pragma omp simd
+        for (int i = 0; i < number_of_points; ++i)
+        {
+            double const s = std::abs(r[i]);
+            double const t = s <= 1 ? 1 - s : 0.;
+            values[i] = t * t * t * t * (1 + 4 * s);
+        }
+        break;
+    case 2:
+        #pragma omp simd
+        for (int i = 0; i < number_of_points; ++i)
+        {
+            double const s = std::abs(r[i]);
+            double const t = s <= 1 ? 1 - s : 0.;
+            values[i] = t * t * t * t * t * t * (3 + 18 * s + 35 * s * s);
+        }
+        break;
+    case 3:
+        #pragma omp simd
+        for (int i = 0; i < number_of_points; ++i)
+        {
+            double const s = std::abs(r[i]);
+            double const t = s <= 1 ? 1 - s : 0.;
+            values[i] = t * t * t * t * t * t * t * t * (1 + 8 * s + 25 * s * s + 32 * s * s * s);
+        }
+        break;
+    default:
+        AssertMsg(false, "order \"" + to_string(order_) + "\" not implemented");
+    }
+}
+
+void Wendland3_RBF::
+batch_gradient_values(int number_of_points,
+                      double const *r,
+                      double *values,
+                      double *d_values) const
+{
+    switch (order_)
+    {
+    case 0:
+        #pragma omp simd
+        for (int i = 0; i < number_of_points; ++i)
+        {
+            double const s = std::abs(r[i]);
+            double const t = s <= 1 ? 1 - s : 0.;
+            values[i] = t * t;
+            d_values[i] = -2 * t;
+        }
+        break;
+    case 1:
+        #pragma omp simd
+        for (int i = 0; i < number_of_points; ++i)
+        {
+            double const s = std::abs(r[i]);
+            double const t = s <= 1 ? 1 - s : 0.;
+            values[i] = t * t * t * t * (1 + 4 * s);
+            d_values[i] = -20 * t * t * t * s;
+        }
+        break;
+    case 2:
+        #pragma omp simd
+        for (int i = 0; i < number_of_points; ++i)
+        {
+            double const s = std::abs(r[i]);
+            double const t = s <= 1 ? 1 - s : 0.;
+            values[i] = t * t * t * t * t * t * (3 + 18 * s + 35 * s * s);
+            d_values[i] = -56 * t * t * t * t * t * s * (1 + 5 * s);
+        }
+        break;
+    case 3:
+        #pragma omp simd
+        for (int i = 0; i < number_of_points; ++i)
+        {
+            double const s = std::abs(r[i]);
+            double const t = s <= 1 ? 1 - s : 0.;
+            values[i] = t * t * t * t * t * t * t * t * (1 + 8 * s + 25 * s * s + 32 * s * s * s);
+            d_values[i] = -22 * t * t * t * t * t * t * t * s * (1 + 7 * s + 16 * s * s);
+        }
+        break;
+    default:
+        AssertMsg(false, "order \"" + to_string(order_) + "\" not implemented");
+    }
+}
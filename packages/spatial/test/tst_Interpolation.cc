@@ -1,7 +1,9 @@
+#include <algorithm>
 #include <cmath>
 #include <functional>
 #include <iomanip>
 #include <iostream>
+#include <numeric>
 
 #include <mpi.h>
 
@@ -21,8 +23,10 @@
 #include "Energy_Discretization.hh"
 #include "Energy_Discretization_Parser.hh"
 #include "Analytic_Solid_Geometry.hh"
+#include "KD_Tree.hh"
 #include "Material.hh"
 #include "Material_Parser.hh"
+#include "Meshless_Function_Factory.hh"
 #include "Random_Number_Generator.hh"
 #include "Solid_Geometry.hh"
 #include "Weak_Spatial_Discretization.hh"
@@ -133,7 +137,7 @@ shared_ptr<Epetra_CrsMatrix> get_matrix(shared_ptr<Weak_Spatial_Discretization>
     for (int i = 0; i < number_of_points; ++i)
     {
         shared_ptr<Weight_Function> weight = spatial->weight(i);
-        Weight_Function::Integrals const integrals = weight->integrals();
+        Weight_Function::Integrals const &integrals = weight->integrals();
         Weight_Function::Values const values = weight->values();
         vector<int> const basis_function_indices = weight->basis_function_indices();
         vector<double> vals(number_of_basis_functions[i]);
@@ -146,8 +150,9 @@ shared_ptr<Epetra_CrsMatrix> get_matrix(shared_ptr<Weak_Spatial_Discretization>
             break;
         }
         case Weak_Spatial_Discretization_Options::Weighting::FLAT:
+        case Weak_Spatial_Discretization_Options::Weighting::FLUX:
         {
-            vector<double> const &iv_b_w = integrals.iv_b_w;
+            Integral_Span const &iv_b_w = integrals.iv_b_w;
             mat->InsertGlobalValues(i, number_of_basis_functions[i], &iv_b_w[0], &basis_function_indices[0]);
             break;
         }
@@ -185,6 +190,7 @@ shared_ptr<Epetra_Vector> get_rhs(shared_ptr<Weak_Spatial_Discretization> spatia
             break;
         }
         case Weak_Spatial_Discretization_Options::Weighting::FLAT:
+        case Weak_Spatial_Discretization_Options::Weighting::FLUX:
         {
             (*vec)[i] = data[0];
             break;
@@ -237,20 +243,9 @@ double get_value(shared_ptr<Weak_Spatial_Discretization> spatial,
                                     coefficients);
 }
 
-// Test interpolation over internal source
-int test_interpolation(int dimension,
-                       function<double(vector<double>)> const &source,
-                       function<double(int, vector<double>)> const &d_source,
-                       XML_Node input_node,
-                       string description,
-                       double tolerance)
+// Solve for the interpolation coefficients
+vector<double> get_coefficients(shared_ptr<Weak_Spatial_Discretization> spatial)
 {
-    int checksum = 0;
-    
-    shared_ptr<Weak_Spatial_Discretization> spatial
-        = get_spatial(dimension,
-                      source,
-                      input_node);
     shared_ptr<Epetra_Comm> comm = get_comm();
     shared_ptr<Epetra_Map> map = get_map(spatial,
                                          comm);
@@ -268,8 +263,25 @@ int test_interpolation(int dimension,
     solver->NumericFactorization();
     solver->Solve();
 
+    return convert_to_vector(lhs);
+}
+
+// Test interpolation over internal source
+int test_interpolation(int dimension,
+                       function<double(vector<double>)> const &source,
+                       function<double(int, vector<double>)> const &d_source,
+                       XML_Node input_node,
+                       string description,
+                       double tolerance)
+{
+    int checksum = 0;
+    
+    shared_ptr<Weak_Spatial_Discretization> spatial
+        = get_spatial(dimension,
+                      source,
+                      input_node);
     int number_of_points = spatial->number_of_points();
-    vector<double> coefficients = convert_to_vector(lhs);
+    vector<double> coefficients = get_coefficients(spatial);
     
     // Check that collocation value is equal to the original result
     {
@@ -436,9 +448,9 @@ int check_basis(string input_folder)
     for (int i = 0; i < number_of_points; ++i)
     {
         shared_ptr<Weight_Function> weight = spatial->weight(i);
-        Weight_Function::Integrals const integrals = weight->integrals();
+        Weight_Function::Integrals const &integrals = weight->integrals();
         double const iv_w = integrals.iv_w[0];
-        vector<double> const &iv_b_w = integrals.iv_b_w;
+        Integral_Span const &iv_b_w = integrals.iv_b_w;
         
         double sum = 0.;
         for (double val : iv_b_w)
@@ -462,6 +474,171 @@ int check_basis(string input_folder)
     return checksum;
 }
 
+// Check that an ordering is a permutation of the points
+int check_permutation(string description,
+                      int number_of_points,
+                      vector<int> order)
+{
+    sort(order.begin(), order.end());
+    vector<int> expected(number_of_points);
+    iota(expected.begin(), expected.end(), 0);
+    if (order != expected)
+    {
+        cout << description << " ordering is not a permutation" << endl;
+        return 1;
+    }
+    return 0;
+}
+
+// Check that the point orderings are permutations and that reordering the
+// points, and with them the flux used for weighting, only relabels the
+// integrals and the interpolation coefficients
+int check_point_ordering(string input_folder)
+{
+    int checksum = 0;
+
+    cout << "checking point ordering" << endl;
+    
+    // Check the orderings of random points
+    {
+        Meshless_Function_Factory meshless_factory;
+        int dimension = 2;
+        int number_of_points = 50;
+        int number_of_neighbors = 8;
+        vector<vector<double> > points(number_of_points);
+        for (vector<double> &point : points)
+        {
+            point = rng.vector(dimension);
+        }
+        vector<int> order;
+        meshless_factory.get_morton_ordering(dimension,
+                                             number_of_points,
+                                             points,
+                                             order);
+        checksum += check_permutation("morton",
+                                      number_of_points,
+                                      order);
+        shared_ptr<KD_Tree> kd_tree
+            = make_shared<KD_Tree>(dimension,
+                                   number_of_points,
+                                   points);
+        meshless_factory.get_rcm_ordering(kd_tree,
+                                          dimension,
+                                          number_of_points,
+                                          number_of_neighbors,
+                                          points,
+                                          order);
+        checksum += check_permutation("rcm",
+                                      number_of_points,
+                                      order);
+    }
+    
+    // Write a flux that varies with position, in the original order of the
+    // Cartesian points
+    string input_filename = input_folder + "cartesian_ordering.xml";
+    {
+        XML_Document input_file(input_filename);
+        XML_Node spatial_node = input_file.get_child("input").get_child("spatial_discretization");
+        int dimension = 2;
+        vector<int> dimensional_points = spatial_node.get_child_vector<int>("dimensional_points",
+                                                                            dimension);
+        int number_of_points;
+        vector<vector<double> > points;
+        Meshless_Function_Factory meshless_factory;
+        meshless_factory.get_cartesian_points(dimension,
+                                              dimensional_points,
+                                              {{-1, 1}, {-1, 1}},
+                                              number_of_points,
+                                              points);
+        vector<double> flux(number_of_points);
+        for (int i = 0; i < number_of_points; ++i)
+        {
+            flux[i] = 2. + points[i][0] + 0.5 * points[i][1];
+        }
+        XML_Document flux_file;
+        flux_file.append_child("flux").set_vector(flux);
+        flux_file.save(spatial_node.get_child("options").get_attribute<string>("flux_file"));
+    }
+    
+    // Get the discretization and interpolation for each ordering
+    function<double(vector<double>)> source
+        = [](vector<double> const &position)
+        {
+            return 1. + 2. * position[0] - position[1] * position[1];
+        };
+    vector<string> orderings = {"none", "morton", "rcm"};
+    vector<shared_ptr<Weak_Spatial_Discretization> > spatials(orderings.size());
+    vector<vector<double> > coefficients(orderings.size());
+    double tolerance = 0;
+    for (int i = 0; i < orderings.size(); ++i)
+    {
+        XML_Document input_file(input_filename);
+        XML_Node input_node = input_file.get_child("input");
+        tolerance = input_node.get_child_value<double>("tolerance");
+        input_node.get_child("spatial_discretization").get_child("options").set_attribute(orderings[i],
+                                                                                           "point_ordering");
+        spatials[i] = get_spatial(2, // dimension
+                                  source,
+                                  input_node);
+        coefficients[i] = get_coefficients(spatials[i]);
+    }
+    
+    // Compare each point to the point at the same position without ordering
+    int number_of_points = spatials[0]->number_of_points();
+    for (int o = 1; o < orderings.size(); ++o)
+    {
+        bool failed = spatials[o]->number_of_points() != number_of_points;
+        for (int i = 0; !failed && i < number_of_points; ++i)
+        {
+            shared_ptr<Weight_Function> weight = spatials[o]->weight(i);
+            int j = 0;
+            while (j < number_of_points
+                   && !ce::approx(spatials[0]->weight(j)->position(), weight->position(), tolerance))
+            {
+                ++j;
+            }
+            if (j == number_of_points)
+            {
+                failed = true;
+                break;
+            }
+            shared_ptr<Weight_Function> expected_weight = spatials[0]->weight(j);
+            if (!ce::approx(expected_weight->integrals().iv_w[0], weight->integrals().iv_w[0], tolerance)
+                || !ce::approx(expected_weight->material()->internal_source()->data(),
+                               weight->material()->internal_source()->data(),
+                               tolerance)
+                || !ce::approx(coefficients[0][j], coefficients[o][i], tolerance))
+            {
+                failed = true;
+            }
+        }
+        for (int i = 0; !failed && i < 100; ++i)
+        {
+            vector<double> position = rng.vector(2);
+            if (!ce::approx(spatials[0]->expansion_value(position,
+                                                         coefficients[0]),
+                            spatials[o]->expansion_value(position,
+                                                         coefficients[o]),
+                            tolerance))
+            {
+                failed = true;
+            }
+        }
+        
+        if (failed)
+        {
+            checksum += 1;
+            cout << "point ordering failed for (" + orderings[o] + ")" << endl;
+        }
+        else
+        {
+            cout << "point ordering passed for (" + orderings[o] + ")" << endl;
+        }
+    }
+    
+    return checksum;
+}
+
 int main(int argc, char **argv)
 {
     int checksum = 0;
@@ -479,6 +656,7 @@ int main(int argc, char **argv)
 
     checksum += check_basis(input_folder);
     checksum += run_interpolation(input_folder);
+    checksum += check_point_ordering(input_folder);
     
     MPI_Finalize();
     
@@ -1,4 +1,6 @@
 #include <cmath>
+#include <cstdio>
+#include <fstream>
 #include <iomanip>
 #include <iostream>
 #include <mpi.h>
@@ -25,29 +27,23 @@
 #include "Weak_Spatial_Discretization.hh"
 #include "Weak_Spatial_Discretization_Factory.hh"
 #include "Weak_Spatial_Discretization_Parser.hh"
+#include "Weight_Function_Integration.hh"
 
 namespace ce = Check_Equality;
 using namespace std;
 
-void get_pincell(bool basis_mls,
-                 bool weight_mls,
-                 string basis_type,
-                 string weight_type,
-                 shared_ptr<Weight_Function_Options> weight_options,
-                 shared_ptr<Weak_Spatial_Discretization_Options> weak_options,
-                 int dimension,
-                 int angular_rule,
-                 int num_dimensional_points,
-                 double radius_num_intervals,
-                 shared_ptr<Weak_Spatial_Discretization> &spatial,
-                 shared_ptr<Angular_Discretization> &angular,
-                 shared_ptr<Energy_Discretization> &energy)
+// Get a pincell geometry with the cross sections multiplied by sigma_scale
+shared_ptr<Constructive_Solid_Geometry> get_pincell_solid(int dimension,
+                                                          int angular_rule,
+                                                          double sigma_scale,
+                                                          shared_ptr<Angular_Discretization> &angular,
+                                                          shared_ptr<Energy_Discretization> &energy,
+                                                          int number_of_moments = 1)
 {
     // Set constants
     double length = 4.0;
     
     // Get angular discretization
-    int number_of_moments = 1;
     Angular_Discretization_Factory angular_factory;
     angular = angular_factory.get_angular_discretization(dimension,
                                                          number_of_moments,
@@ -57,22 +53,26 @@ void get_pincell(bool basis_mls,
     int number_of_groups = 1;
     energy = make_shared<Energy_Discretization>(number_of_groups);
     
-    // Get material
+    // Get material, with isotropic scattering for any number of moments
+    vector<double> sigma_s0(number_of_moments, 0.);
+    vector<double> sigma_s1(number_of_moments, 0.);
+    sigma_s0[0] = 0.84 * sigma_scale;
+    sigma_s1[0] = 1.9 * sigma_scale;
     vector<shared_ptr<Material> > materials(2);
     Material_Factory material_factory(angular,
                                       energy);
     materials[0]
         = material_factory.get_standard_material(0, // index
-                                                 {1.0}, // sigma_t
-                                                 {0.84}, // sigma_s
+                                                 {1.0 * sigma_scale}, // sigma_t
+                                                 sigma_s0, // sigma_s
                                                  {2.4}, // nu
-                                                 {0.1}, // sigma_f
+                                                 {0.1 * sigma_scale}, // sigma_f
                                                  {1}, // chi
                                                  {0.0}); // internal source
     materials[1]
         = material_factory.get_standard_material(1, // index
-                                                 {2.0}, // sigma_t
-                                                 {1.9}, // sigma_s
+                                                 {2.0 * sigma_scale}, // sigma_t
+                                                 sigma_s1, // sigma_s
                                                  {0.0}, // nu
                                                  {0.0}, // sigma_f
                                                  {0.0}, // chi
@@ -232,12 +232,37 @@ void get_pincell(bool basis_mls,
     }
     
     // Create solid geometry
+    return make_shared<Constructive_Solid_Geometry>(dimension,
+                                                    surfaces,
+                                                    regions,
+                                                    materials,
+                                                    boundary_sources);
+}
+
+void get_pincell(bool basis_mls,
+                 bool weight_mls,
+                 string basis_type,
+                 string weight_type,
+                 shared_ptr<Weight_Function_Options> weight_options,
+                 shared_ptr<Weak_Spatial_Discretization_Options> weak_options,
+                 int dimension,
+                 int angular_rule,
+                 int num_dimensional_points,
+                 double radius_num_intervals,
+                 shared_ptr<Weak_Spatial_Discretization> &spatial,
+                 shared_ptr<Angular_Discretization> &angular,
+                 shared_ptr<Energy_Discretization> &energy,
+                 double sigma_scale = 1.,
+                 int number_of_moments = 1)
+{
+    // Get solid geometry
     shared_ptr<Constructive_Solid_Geometry> solid
-        = make_shared<Constructive_Solid_Geometry>(dimension,
-                                                   surfaces,
-                                                   regions,
-                                                   materials,
-                                                   boundary_sources);
+        = get_pincell_solid(dimension,
+                            angular_rule,
+                            sigma_scale,
+                            angular,
+                            energy,
+                            number_of_moments);
     
     // Get spatial discretization
     Weak_Spatial_Discretization_Factory spatial_factory(solid,
@@ -320,9 +345,9 @@ int test_integration(bool basis_mls,
     shared_ptr<Weight_Function> weight_internal
         = spatial_internal->weight(0);
 
-    Weight_Function::Integrals const integrals_external
+    Weight_Function::Integrals const &integrals_external
         = weight_external->integrals();
-    Weight_Function::Integrals const integrals_internal
+    Weight_Function::Integrals const &integrals_internal
         = weight_internal->integrals();
 
     shared_ptr<Material> material_external
@@ -347,6 +372,412 @@ int test_integration(bool basis_mls,
     return checksum;
 }
 
+// Compare the integrals and materials of two discretizations
+int compare_weights(string description,
+                    shared_ptr<Weak_Spatial_Discretization> spatial1,
+                    shared_ptr<Weak_Spatial_Discretization> spatial2,
+                    double tolerance)
+{
+    int checksum = 0;
+    
+    int number_of_points = spatial1->number_of_points();
+    if (spatial2->number_of_points() != number_of_points)
+    {
+        cout << description << ": number of points differs" << endl;
+        return 1;
+    }
+    for (int i = 0; i < number_of_points; ++i)
+    {
+        shared_ptr<Weight_Function> weight1 = spatial1->weight(i);
+        shared_ptr<Weight_Function> weight2 = spatial2->weight(i);
+        Weight_Function::Integrals const &integrals1 = weight1->integrals();
+        Weight_Function::Integrals const &integrals2 = weight2->integrals();
+        if (!ce::approx(integrals1.iv_w.to_vector(), integrals2.iv_w.to_vector(), tolerance)
+            || !ce::approx(integrals1.iv_b_w.to_vector(), integrals2.iv_b_w.to_vector(), tolerance)
+            || !ce::approx(integrals1.iv_db_dw.to_vector(), integrals2.iv_db_dw.to_vector(), tolerance)
+            || !ce::approx(integrals1.is_b_w.to_vector(), integrals2.is_b_w.to_vector(), tolerance))
+        {
+            cout << description << ": integrals differ for point " << i << endl;
+            checksum += 1;
+        }
+        shared_ptr<Material> material1 = weight1->material();
+        shared_ptr<Material> material2 = weight2->material();
+        if (!ce::approx(material1->sigma_t()->data(), material2->sigma_t()->data(), tolerance)
+            || !ce::approx(material1->sigma_s()->data(), material2->sigma_s()->data(), tolerance)
+            || !ce::approx(material1->sigma_f()->data(), material2->sigma_f()->data(), tolerance))
+        {
+            cout << description << ": materials differ for point " << i << endl;
+            checksum += 1;
+        }
+    }
+    
+    return checksum;
+}
+
+// Check that integrals read from the cache match those calculated directly
+int test_integral_cache(int dimension,
+                        int num_dimensional_points)
+{
+    int checksum = 0;
+    
+    shared_ptr<Weight_Function_Options> weight_options
+        = make_shared<Weight_Function_Options>();
+    shared_ptr<Weak_Spatial_Discretization_Options> weak_options
+        = make_shared<Weak_Spatial_Discretization_Options>();
+    weak_options->weighting = Weak_Spatial_Discretization_Options::Weighting::FLAT;
+    weak_options->external_integral_calculation = true;
+    weak_options->integration_ordinates = 8;
+    string const cache = "tst_weight_integration_cache_" + to_string(dimension) + ".bin";
+    string const material_cache = cache + ".materials";
+    remove(cache.c_str());
+    remove(material_cache.c_str());
+    
+    // Calculate the integrals without the cache, then with the cache missing,
+    // with only the geometric integrals cached, and with everything cached
+    vector<string> const descriptions
+        = {"no cache",
+           "cache miss",
+           "material cache miss",
+           "cache hit"};
+    vector<shared_ptr<Weak_Spatial_Discretization> > spatials(descriptions.size());
+    for (int i = 0; i < descriptions.size(); ++i)
+    {
+        weak_options->integral_cache = i == 0 ? "" : cache;
+        if (i == 2)
+        {
+            remove(material_cache.c_str());
+        }
+        shared_ptr<Angular_Discretization> angular;
+        shared_ptr<Energy_Discretization> energy;
+        get_pincell(true, // basis_mls
+                    true, // weight_mls
+                    "wendland11",
+                    "wendland11",
+                    weight_options,
+                    weak_options,
+                    dimension,
+                    1, // angular_rule
+                    num_dimensional_points,
+                    4., // radius_num_intervals
+                    spatials[i],
+                    angular,
+                    energy);
+        
+        if (i > 0 && !(ifstream(cache) && ifstream(material_cache)))
+        {
+            cout << descriptions[i] << ": cache not written" << endl;
+            checksum += 1;
+        }
+        checksum += compare_weights(descriptions[i],
+                                    spatials[0],
+                                    spatials[i],
+                                    0.); // tolerance
+    }
+    
+    // With flux weighting, the materials depend on the scalar flux fraction
+    // when there is more than one moment, so changing the fraction should
+    // miss the material cache
+    int const number_of_moments = 2;
+    shared_ptr<Angular_Discretization> flux_angular;
+    shared_ptr<Energy_Discretization> flux_energy;
+    get_pincell_solid(dimension,
+                      1, // angular_rule
+                      1., // sigma_scale
+                      flux_angular,
+                      flux_energy,
+                      number_of_moments);
+    int const number_of_points = pow(num_dimensional_points, dimension);
+    weak_options->weighting = Weak_Spatial_Discretization_Options::Weighting::FLUX;
+    weak_options->flux_coefficients.resize(number_of_points
+                                           * flux_energy->number_of_groups()
+                                           * flux_angular->number_of_moments());
+    for (int i = 0; i < weak_options->flux_coefficients.size(); ++i)
+    {
+        weak_options->flux_coefficients[i] = 1. + 0.5 * sin(static_cast<double>(i));
+    }
+    vector<double> const fractions = {1e-8, 0.5, 0.5};
+    vector<shared_ptr<Weak_Spatial_Discretization> > flux_spatials(fractions.size());
+    for (int i = 0; i < fractions.size(); ++i)
+    {
+        weak_options->integral_cache = i == 2 ? "" : cache;
+        weak_options->scalar_flux_fraction = fractions[i];
+        shared_ptr<Angular_Discretization> angular;
+        shared_ptr<Energy_Discretization> energy;
+        get_pincell(true, // basis_mls
+                    true, // weight_mls
+                    "wendland11",
+                    "wendland11",
+                    weight_options,
+                    make_shared<Weak_Spatial_Discretization_Options>(*weak_options),
+                    dimension,
+                    1, // angular_rule
+                    num_dimensional_points,
+                    4., // radius_num_intervals
+                    flux_spatials[i],
+                    angular,
+                    energy,
+                    1., // sigma_scale
+                    number_of_moments);
+    }
+    bool fraction_used = false;
+    for (int i = 0; i < number_of_points; ++i)
+    {
+        if (!ce::approx(flux_spatials[0]->weight(i)->material()->sigma_t()->data(),
+                        flux_spatials[2]->weight(i)->material()->sigma_t()->data(),
+                        0.)) // tolerance
+        {
+            fraction_used = true;
+        }
+    }
+    if (!fraction_used)
+    {
+        cout << "flux: scalar flux fraction does not change the materials" << endl;
+        checksum += 1;
+    }
+    checksum += compare_weights("flux, fraction changed",
+                                flux_spatials[2],
+                                flux_spatials[1],
+                                0.); // tolerance
+    
+    remove(cache.c_str());
+    remove(material_cache.c_str());
+    
+    return checksum;
+}
+
+// Check that updating the materials of a discretization gives the same
+// result as integrating the new materials directly
+int test_update_materials(int dimension,
+                          int num_dimensional_points,
+                          bool store_quadrature_values)
+{
+    int checksum = 0;
+    string description = (string("update_materials, ")
+                          + (store_quadrature_values ? "stored" : "unstored"));
+    
+    shared_ptr<Weight_Function_Options> weight_options
+        = make_shared<Weight_Function_Options>();
+    shared_ptr<Weak_Spatial_Discretization_Options> weak_options
+        = make_shared<Weak_Spatial_Discretization_Options>();
+    weak_options->weighting = Weak_Spatial_Discretization_Options::Weighting::FLAT;
+    weak_options->external_integral_calculation = true;
+    weak_options->integration_ordinates = 8;
+    weak_options->store_quadrature_values = store_quadrature_values;
+    
+    // Get discretization for the original and scaled cross sections
+    double const sigma_scale = 0.5;
+    vector<double> const scales = {1., sigma_scale};
+    vector<shared_ptr<Weak_Spatial_Discretization> > spatials(scales.size());
+    for (int i = 0; i < scales.size(); ++i)
+    {
+        shared_ptr<Angular_Discretization> angular;
+        shared_ptr<Energy_Discretization> energy;
+        get_pincell(true, // basis_mls
+                    true, // weight_mls
+                    "wendland11",
+                    "wendland11",
+                    weight_options,
+                    make_shared<Weak_Spatial_Discretization_Options>(*weak_options),
+                    dimension,
+                    1, // angular_rule
+                    num_dimensional_points,
+                    4., // radius_num_intervals
+                    spatials[i],
+                    angular,
+                    energy,
+                    scales[i]);
+    }
+    
+    // Update the original discretization to the scaled cross sections
+    shared_ptr<Angular_Discretization> angular;
+    shared_ptr<Energy_Discretization> energy;
+    spatials[0]->update_materials(get_pincell_solid(dimension,
+                                                    1, // angular_rule
+                                                    sigma_scale,
+                                                    angular,
+                                                    energy));
+    checksum += compare_weights(description,
+                                spatials[1],
+                                spatials[0],
+                                0.); // tolerance
+    
+    return checksum;
+}
+
+// Check that integrals copied from translated weight functions and cells
+// match those calculated directly
+int test_lattice_templates(int dimension,
+                           int num_dimensional_points,
+                           double radius_num_intervals)
+{
+    int checksum = 0;
+    
+    shared_ptr<Weight_Function_Options> weight_options
+        = make_shared<Weight_Function_Options>();
+    shared_ptr<Weak_Spatial_Discretization_Options> weak_options
+        = make_shared<Weak_Spatial_Discretization_Options>();
+    weak_options->weighting = Weak_Spatial_Discretization_Options::Weighting::FLAT;
+    weak_options->external_integral_calculation = true;
+    weak_options->integration_ordinates = 8;
+    
+    vector<shared_ptr<Weak_Spatial_Discretization> > spatials(2);
+    for (int i = 0; i < 2; ++i)
+    {
+        weak_options->lattice_templates = i == 1;
+        shared_ptr<Angular_Discretization> angular;
+        shared_ptr<Energy_Discretization> energy;
+        get_pincell(false, // basis_mls
+                    false, // weight_mls
+                    "wendland11",
+                    "wendland11",
+                    weight_options,
+                    make_shared<Weak_Spatial_Discretization_Options>(*weak_options),
+                    dimension,
+                    1, // angular_rule
+                    num_dimensional_points,
+                    radius_num_intervals,
+                    spatials[i],
+                    angular,
+                    energy);
+    }
+    
+    // Make sure the comparison is not trivial
+    Weight_Function_Integration integrator(spatials[1]->number_of_points(),
+                                           spatials[1]->options(),
+                                           spatials[1]->bases(),
+                                           spatials[1]->weights());
+    if (integrator.number_of_weight_template_copies() == 0)
+    {
+        cout << "lattice templates: no weight templates reused" << endl;
+        checksum += 1;
+    }
+    if (integrator.number_of_cell_template_copies() == 0)
+    {
+        cout << "lattice templates: no cell templates reused" << endl;
+        checksum += 1;
+    }
+    
+    checksum += compare_weights("lattice templates",
+                                spatials[0],
+                                spatials[1],
+                                1e-10); // tolerance
+    
+    return checksum;
+}
+
+// Check that the error-controlled adaptive quadrature matches a fixed
+// high-order quadrature and reports the cells that did not converge
+int test_error_quadrature(int dimension,
+                          int num_dimensional_points)
+{
+    int checksum = 0;
+    int const maximum_ordinates = 32;
+    double const quadrature_tolerance = 1e-6;
+    
+    shared_ptr<Weight_Function_Options> weight_options
+        = make_shared<Weight_Function_Options>();
+    shared_ptr<Weak_Spatial_Discretization_Options> weak_options
+        = make_shared<Weak_Spatial_Discretization_Options>();
+    weak_options->weighting = Weak_Spatial_Discretization_Options::Weighting::FLAT;
+    weak_options->external_integral_calculation = true;
+    weak_options->maximum_integration_ordinates = maximum_ordinates;
+    
+    // Get discretizations with fixed high-order quadrature, adaptive
+    // quadrature and adaptive quadrature that cannot converge
+    vector<int> const integration_ordinates = {maximum_ordinates, 4, 2};
+    vector<int> const maximum_integration_ordinates = {maximum_ordinates, maximum_ordinates, 4};
+    vector<double> const tolerances = {0., quadrature_tolerance, 1e-14};
+    vector<shared_ptr<Weak_Spatial_Discretization> > spatials(3);
+    vector<vector<int> > integration_numbers(3);
+    for (int i = 0; i < 3; ++i)
+    {
+        weak_options->adaptive_quadrature = i > 0;
+        weak_options->integration_ordinates = integration_ordinates[i];
+        weak_options->maximum_integration_ordinates = maximum_integration_ordinates[i];
+        weak_options->quadrature_tolerance = tolerances[i];
+        shared_ptr<Angular_Discretization> angular;
+        shared_ptr<Energy_Discretization> energy;
+        get_pincell(true, // basis_mls
+                    true, // weight_mls
+                    "wendland11",
+                    "wendland11",
+                    weight_options,
+                    make_shared<Weak_Spatial_Discretization_Options>(*weak_options),
+                    dimension,
+                    1, // angular_rule
+                    num_dimensional_points,
+                    4., // radius_num_intervals
+                    spatials[i],
+                    angular,
+                    energy);
+
+        // Integrate again to get the number of points and unconverged cells
+        Weight_Function_Integration integrator(spatials[i]->number_of_points(),
+                                               spatials[i]->options(),
+                                               spatials[i]->bases(),
+                                               spatials[i]->weights());
+        integrator.perform_integration();
+        integration_numbers[i] = integrator.get_total_max_points();
+    }
+    
+    // The adaptive quadrature should use fewer points than the fixed
+    // quadrature for the comparison to be meaningful
+    if (integration_numbers[1][0] >= integration_numbers[0][0])
+    {
+        cout << "error quadrature: no cells converged below the maximum order" << endl;
+        checksum += 1;
+    }
+    
+    // The number of unconverged cells should be reported
+    if (integration_numbers[0][9] != 0)
+    {
+        cout << "error quadrature: unconverged cells reported for fixed quadrature" << endl;
+        checksum += 1;
+    }
+    if (integration_numbers[2][9] == 0)
+    {
+        cout << "error quadrature: unconverged cells not reported" << endl;
+        checksum += 1;
+    }
+    
+    // The integrals should agree to within the tolerance relative to the
+    // largest integral of each weight function, allowing for the error of
+    // each cell in the support
+    for (int i = 0; i < spatials[0]->number_of_points(); ++i)
+    {
+        Weight_Function::Integrals const &integrals1 = spatials[0]->weight(i)->integrals();
+        Weight_Function::Integrals const &integrals2 = spatials[1]->weight(i)->integrals();
+        vector<vector<double> > values1
+            = {integrals1.iv_w.to_vector(),
+               integrals1.iv_b_w.to_vector(),
+               integrals1.iv_db_dw.to_vector()};
+        vector<vector<double> > values2
+            = {integrals2.iv_w.to_vector(),
+               integrals2.iv_b_w.to_vector(),
+               integrals2.iv_db_dw.to_vector()};
+        double scale = 0;
+        for (vector<double> const &values : values1)
+        {
+            for (double value : values)
+            {
+                scale = max(scale, abs(value));
+            }
+        }
+        double const tolerance = 100 * quadrature_tolerance * scale;
+        for (int j = 0; j < values1.size(); ++j)
+        {
+            if (!ce::approx(values1[j], values2[j], tolerance))
+            {
+                cout << "error quadrature: integrals differ for point " << i << endl;
+                checksum += 1;
+                break;
+            }
+        }
+    }
+    
+    return checksum;
+}
+
 int run_tests()
 {
     int checksum = 0;
@@ -405,6 +836,33 @@ int run_tests()
                                  5, // number_of_points
                                  4., // number_of_intervals
                                  tolerance); // tolerance
+
+    checksum += test_integral_cache(1, // dimension
+                                    25); // number_of_points
+    checksum += test_integral_cache(2, // dimension
+                                    5); // number_of_points
+
+    checksum += test_lattice_templates(1, // dimension
+                                       25, // number_of_points
+                                       4.); // radius_num_intervals
+    checksum += test_lattice_templates(2, // dimension
+                                       9, // number_of_points
+                                       1.5); // radius_num_intervals
+
+    checksum += test_error_quadrature(1, // dimension
+                                      25); // number_of_points
+    checksum += test_error_quadrature(2, // dimension
+                                      5); // number_of_points
+
+    for (bool store_quadrature_values : {true, false})
+    {
+        checksum += test_update_materials(1, // dimension
+                                          25, // number_of_points
+                                          store_quadrature_values);
+        checksum += test_update_materials(2, // dimension
+                                          5, // number_of_points
+                                          store_quadrature_values);
+    }
      
     return checksum;
 }
@@ -0,0 +1,60 @@
+#include "Matrix_Free_Sweep_Operator.hh"
+
+#include <vector>
+
+#include "Epetra_Map.h"
+#include "Epetra_MultiVector.h"
+
+#include "Check.hh"
+#include "Meshless_Sweep.hh"
+
+using std::shared_ptr;
+using std::vector;
+
+Matrix_Free_Sweep_Operator::
+Matrix_Free_Sweep_Operator(Meshless_Sweep const &sweep,
+                           int o,
+                           int g,
+                           shared_ptr<Epetra_Map> map):
+    sweep_(sweep),
+    o_(o),
+    g_(g),
+    map_(map)
+{
+}
+
+int Matrix_Free_Sweep_Operator::
+Apply(Epetra_MultiVector const &X,
+      Epetra_MultiVector &Y) const
+{
+    Assert(X.NumVectors() == Y.NumVectors());
+
+    int number_of_vectors = X.NumVectors();
+    for (int v = 0; v < number_of_vectors; ++v)
+    {
+        if (&X == &Y)
+        {
+            // Input and output cannot be the same for apply_matrix
+            vector<double> x(X[v], X[v] + X.MyLength());
+            sweep_.apply_matrix(o_,
+                                g_,
+                                &x[0],
+                                Y[v]);
+        }
+        else
+        {
+            sweep_.apply_matrix(o_,
+                                g_,
+                                X[v],
+                                Y[v]);
+        }
+    }
+    
+    return 0;
+}
+
+const Epetra_Comm &Matrix_Free_Sweep_Operator::
+Comm() const
+{
+    return map_->Comm();
+}
@@ -0,0 +1,93 @@
+#ifndef Matrix_Free_Sweep_Operator_hh
+#define Matrix_Free_Sweep_Operator_hh
+
+#include <memory>
+
+#include <Epetra_Operator.h>
+
+class Epetra_Comm;
+class Epetra_Map;
+class Epetra_MultiVector;
+class Meshless_Sweep;
+
+/*
+  Transport matrix for a single ordinate and group as an Epetra_Operator
+  
+  Applies the matrix through Meshless_Sweep::apply_matrix, so the matrix
+  is never stored
+*/
+class Matrix_Free_Sweep_Operator: public Epetra_Operator
+{
+public:
+
+    // Constructor
+    Matrix_Free_Sweep_Operator(Meshless_Sweep const &sweep,
+                               int o,
+                               int g,
+                               std::shared_ptr<Epetra_Map> map);
+
+    // Cannot use transpose
+    virtual int SetUseTranspose(bool UseTranspose) override
+    {
+        return -1;
+    }
+
+    // Apply the matrix
+    virtual int Apply(Epetra_MultiVector const &X,
+                      Epetra_MultiVector &Y) const override;
+    
+    // Do nothing, as explicit inverse is not available
+    virtual int ApplyInverse(Epetra_MultiVector const &X,
+                             Epetra_MultiVector &Y) const override
+    {
+        return 1;
+    }
+    
+    // Cannot provide inf norm
+    virtual double NormInf() const override
+    {
+        return 0.;
+    }
+    
+    // Label for object
+    virtual const char *Label() const override
+    {
+        return "Matrix_Free_Sweep_Operator";
+    }
+
+    // Cannot use transpose
+    virtual bool UseTranspose() const override
+    {
+        return false;
+    }
+
+    // Cannot provide inf norm
+    virtual bool HasNormInf() const override
+    {
+        return false;
+    }
+
+    // Return associated Epetra_Comm
+    virtual const Epetra_Comm &Comm() const override;
+    
+    // Return associated Epetra_Map
+    virtual const Epetra_Map &OperatorDomainMap() const override
+    {
+        return *map_;
+    }
+
+    // Return associated Epetra_Map
+    virtual const Epetra_Map &OperatorRangeMap() const override
+    {
+        return *map_;
+    }
+    
+private:
+
+    Meshless_Sweep const &sweep_;
+    int o_;
+    int g_;
+    std::shared_ptr<Epetra_Map> map_;
+};
+
+#endif
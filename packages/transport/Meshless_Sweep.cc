@@ -1,6 +1,8 @@
 #include "Meshless_Sweep.hh"
 
+#include <algorithm>
 #include <iostream>
+#include <map>
 #if defined(ENABLE_OPENMP)
     #include <omp.h>
 #else
@@ -8,12 +10,17 @@
     inline int omp_get_thread_num() {return 0;}
 #endif
 
+#include <Eigen/Sparse>
+#include <Eigen/SparseLU>
+
 #include "Amesos.h"
 #include "AztecOO.h"
 #include "AztecOO_ConditionNumber.h"
 #include "BelosSolverFactory.hpp"
+#include "BelosBlockGmresSolMgr.hpp"
 #include "BelosEpetraAdapter.hpp"
 #include "BelosPseudoBlockGmresSolMgr.hpp"
+#include "Epetra_CrsGraph.h"
 #include "Epetra_CrsMatrix.h"
 #include "Epetra_LinearProblem.h"
 #include "Epetra_Map.h"
@@ -36,7 +43,9 @@
 #include "Dimensional_Moments.hh"
 #include "Energy_Discretization.hh"
 #include "Material.hh"
+#include "Matrix_Free_Sweep_Operator.hh"
 #include "Transport_Discretization.hh"
+#include "Upwind_Gauss_Seidel.hh"
 #include "XML_Node.hh"
 
 using std::make_shared;
@@ -51,18 +60,58 @@ Meshless_Sweep(Options options,
                shared_ptr<Angular_Discretization> angular_discretization,
                shared_ptr<Energy_Discretization> energy_discretization,
                shared_ptr<Transport_Discretization> transport_discretization):
-    Sweep_Operator(Sweep_Type::ORDINATE,
+    Sweep_Operator((options.moment_sweep
+                    ? Sweep_Type::MOMENT
+                    : Sweep_Type::ORDINATE),
                    transport_discretization),
     options_(options),
     spatial_discretization_(spatial_discretization),
     angular_discretization_(angular_discretization),
     energy_discretization_(energy_discretization)
 {
+    AssertMsg(!(options_.warm_start && options_.moment_sweep),
+              "warm_start keeps the angular flux, so it cannot be used with moment_sweep");
+    
+    // Get sparsity pattern, which is the same for all ordinates and groups
+    int number_of_points = spatial_discretization_->number_of_points();
+    row_offsets_.resize(number_of_points + 1);
+    row_offsets_[0] = 0;
+    for (int i = 0; i < number_of_points; ++i)
+    {
+        shared_ptr<Weight_Function> weight = spatial_discretization_->weight(i);
+        vector<int> const &basis_indices = weight->basis_function_indices();
+        row_offsets_[i + 1] = row_offsets_[i] + basis_indices.size();
+        column_indices_.insert(column_indices_.end(),
+                               basis_indices.begin(),
+                               basis_indices.end());
+    }
 }
 
 void Meshless_Sweep::
 initialize_solver()
 {
+    // Initialize sparsity graph shared by all ordinates and groups
+    int number_of_points = spatial_discretization_->number_of_points();
+    vector<int> const number_of_basis_functions = spatial_discretization_->number_of_basis_functions();
+    comm_ = make_shared<Epetra_SerialComm>();
+    map_ = make_shared<Epetra_Map>(number_of_points, 0, *comm_);
+    graph_ = make_shared<Epetra_CrsGraph>(Copy, // Data access
+                                          *map_,
+                                          &number_of_basis_functions[0], // Num entries per row
+                                          true); // Static profile
+    for (int i = 0; i < number_of_points; ++i)
+    {
+        graph_->InsertGlobalIndices(i, // Row
+                                    number_of_basis_functions[i], // Num entries
+                                    &column_indices_[row_offsets_[i]]);
+    }
+    graph_->FillComplete();
+    graph_->OptimizeStorage();
+
+    // Find ordinates and groups that share a matrix
+    initialize_matrix_indices();
+    
+    // Initialize solver
     switch (options_.solver)
     {
     case Options::Solver::AMESOS:
@@ -71,6 +120,9 @@ initialize_solver()
     case Options::Solver::AMESOS_PARALLEL:
         solver_ = make_shared<Amesos_Parallel_Solver>(*this);
         break;
+    case Options::Solver::AMESOS_REUSE:
+        solver_ = make_shared<Amesos_Reuse_Solver>(*this);
+        break;
     case Options::Solver::AZTEC:
         solver_ = make_shared<Aztec_Solver>(*this);
         break;
@@ -89,14 +141,244 @@ initialize_solver()
     case Options::Solver::BELOS_IFPACK_RIGHT2:
         solver_ = make_shared<Belos_Ifpack_Right2_Solver>(*this);
         break;
+    case Options::Solver::BELOS_SWEEP:
+        solver_ = make_shared<Belos_Sweep_Solver>(*this);
+        break;
+    case Options::Solver::BELOS_MATRIX_FREE:
+        solver_ = make_shared<Belos_Matrix_Free_Solver>(*this);
+        break;
+    case Options::Solver::MIXED_PRECISION:
+        solver_ = make_shared<Mixed_Precision_Solver>(*this);
+        break;
+    }
+}
+
+void Meshless_Sweep::
+initialize_matrix_indices()
+{
+    int number_of_groups = energy_discretization_->number_of_groups();
+    int number_of_ordinates = angular_discretization_->number_of_ordinates();
+    int dimension = spatial_discretization_->dimension();
+    
+    matrix_indices_.resize(number_of_groups * number_of_ordinates);
+    matrix_slots_.clear();
+
+    // Each ordinate and group has its own matrix
+    if (!options_.deduplicate_matrices)
+    {
+        matrix_slots_.resize(number_of_groups * number_of_ordinates);
+        for (int k = 0; k < number_of_groups * number_of_ordinates; ++k)
+        {
+            matrix_indices_[k] = k;
+            matrix_slots_[k].assign(1, k);
+        }
+        return;
+    }
+    
+    // Find groups with identical cross sections
+    vector<int> group_indices(number_of_groups);
+    vector<int> unique_groups;
+    for (int g = 0; g < number_of_groups; ++g)
+    {
+        group_indices[g] = unique_groups.size();
+        for (int u = 0; u < unique_groups.size(); ++u)
+        {
+            if (identical_groups(unique_groups[u], g))
+            {
+                group_indices[g] = u;
+                break;
+            }
+        }
+        if (group_indices[g] == unique_groups.size())
+        {
+            unique_groups.push_back(g);
+        }
+    }
+
+    // Find ordinates with identical projected directions
+    vector<int> ordinate_indices(number_of_ordinates);
+    std::map<vector<double>, int> unique_directions;
+    for (int o = 0; o < number_of_ordinates; ++o)
+    {
+        vector<double> const &direction = angular_discretization_->direction(o);
+        vector<double> const projection(direction.begin(), direction.begin() + dimension);
+        int const index = unique_directions.size();
+        ordinate_indices[o] = unique_directions.insert({projection, index}).first->second;
+    }
+
+    // Assign a unique matrix to each pair of unique direction and group
+    std::map<pair<int, int>, int> unique_matrices;
+    for (int o = 0; o < number_of_ordinates; ++o)
+    {
+        for (int g = 0; g < number_of_groups; ++g)
+        {
+            int k = g + number_of_groups * o;
+            int const index = unique_matrices.size();
+            int u = unique_matrices.insert({{ordinate_indices[o], group_indices[g]}, index}).first->second;
+            if (u == matrix_slots_.size())
+            {
+                matrix_slots_.emplace_back();
+            }
+            matrix_indices_[k] = u;
+            matrix_slots_[u].push_back(k);
+        }
+    }
+}
+
+bool Meshless_Sweep::
+identical_groups(int g1,
+                 int g2) const
+{
+    int number_of_points = spatial_discretization_->number_of_points();
+    int number_of_groups = energy_discretization_->number_of_groups();
+    
+    // Compare the cross sections that appear in the matrix
+    for (int i = 0; i < number_of_points; ++i)
+    {
+        shared_ptr<Material> const material = spatial_discretization_->weight(i)->material();
+        vector<shared_ptr<Cross_Section> > const cross_sections = {material->sigma_t(), material->norm()};
+        for (shared_ptr<Cross_Section> const &cross_section : cross_sections)
+        {
+            if (!cross_section)
+            {
+                continue;
+            }
+            
+            switch (cross_section->dependencies().energy)
+            {
+            case Cross_Section::Dependencies::Energy::NONE:
+                break;
+            case Cross_Section::Dependencies::Energy::GROUP:
+            {
+                // Data is ordered as d + inner_size * (g + number_of_groups * (a + angular_size * s)),
+                // so the angular and spatial indices together form the outer index
+                vector<double> const &data = cross_section->data();
+                int const inner_size = cross_section->dimensional_size();
+                int const outer_size = cross_section->angular_size() * cross_section->spatial_size();
+                for (int k = 0; k < outer_size; ++k)
+                {
+                    for (int d = 0; d < inner_size; ++d)
+                    {
+                        if (data[d + inner_size * (g1 + number_of_groups * k)]
+                            != data[d + inner_size * (g2 + number_of_groups * k)])
+                        {
+                            return false;
+                        }
+                    }
+                }
+                break;
+            }
+            default:
+                return false;
+            }
+        }
     }
+    
+    return true;
 }
 
 void Meshless_Sweep::
 apply(vector<double> &x) const
 {
-    solver_->solve(x);
-    update_augments(x);
+    switch (sweep_type_)
+    {
+    case Sweep_Type::ORDINATE:
+        solver_->solve(x);
+        solver_->finish_sweep();
+        update_augments(x);
+        break;
+    case Sweep_Type::MOMENT:
+        // The solution is added into separate moments, as x holds the source
+        moment_result_.assign(x.size(), 0);
+        solver_->solve(x);
+        solver_->finish_sweep();
+        x.swap(moment_result_);
+        break;
+    }
+}
+
+void Meshless_Sweep::
+get_source(int i,
+           int o,
+           int g,
+           vector<double> const &x,
+           double &value) const
+{
+    int number_of_groups = energy_discretization_->number_of_groups();
+    
+    switch (sweep_type_)
+    {
+    case Sweep_Type::ORDINATE:
+    {
+        int number_of_ordinates = angular_discretization_->number_of_ordinates();
+        value = x[g + number_of_groups * (o + number_of_ordinates * i)];
+        break;
+    }
+    case Sweep_Type::MOMENT:
+    {
+        // Convert moments to the discrete source for this ordinate
+        int number_of_moments = angular_discretization_->number_of_moments();
+        int number_of_ordinates = angular_discretization_->number_of_ordinates();
+        vector<double> const &moment_to_discrete = angular_discretization_->moment_to_discrete_matrix();
+        value = 0;
+        for (int m = 0; m < number_of_moments; ++m)
+        {
+            int k = g + number_of_groups * (m + number_of_moments * i);
+            value += moment_to_discrete[o + number_of_ordinates * m] * x[k];
+        }
+        break;
+    }
+    }
+}
+
+void Meshless_Sweep::
+set_solution(int i,
+             int o,
+             int g,
+             double value,
+             vector<double> &x) const
+{
+    int number_of_groups = energy_discretization_->number_of_groups();
+    int number_of_ordinates = angular_discretization_->number_of_ordinates();
+    
+    switch (sweep_type_)
+    {
+    case Sweep_Type::ORDINATE:
+        x[g + number_of_groups * (o + number_of_ordinates * i)] = value;
+        break;
+    case Sweep_Type::MOMENT:
+    {
+        // Add contribution of this ordinate to the moments
+        int number_of_moments = angular_discretization_->number_of_moments();
+        vector<double> const &discrete_to_moment = angular_discretization_->discrete_to_moment_matrix();
+        for (int m = 0; m < number_of_moments; ++m)
+        {
+            int k = g + number_of_groups * (m + number_of_moments * i);
+            double contribution = discrete_to_moment[m + number_of_moments * o] * value;
+            #pragma omp atomic
+            moment_result_[k] += contribution;
+        }
+        
+        // Set boundary augment to the angular flux
+        if (transport_discretization_->has_reflection())
+        {
+            shared_ptr<Basis_Function> basis = spatial_discretization_->basis(i);
+            if (basis->point_type() == Basis_Function::Point_Type::BOUNDARY)
+            {
+                int b = basis->boundary_index();
+                int k_b = augment_offset() + g + number_of_groups * (o + number_of_ordinates * b);
+                moment_result_[k_b] = value;
+            }
+        }
+        break;
+    }
+    }
+}
+
+int Meshless_Sweep::
+augment_offset() const
+{
+    return size() - transport_discretization_->number_of_augments();
 }
 
 void Meshless_Sweep::
@@ -133,11 +415,62 @@ update_augments(vector<double> &x) const
     }
 }
 
+void Meshless_Sweep::
+get_matrix_values(int o,
+                  int g,
+                  vector<double> &values) const
+{
+    int number_of_points = spatial_discretization_->number_of_points();
+    
+    values.resize(column_indices_.size());
+    for (int i = 0; i < number_of_points; ++i)
+    {
+        vector<int> indices;
+        vector<double> row_values;
+        get_matrix_row(i,
+                       o,
+                       g,
+                       indices,
+                       row_values);
+        std::copy(row_values.begin(), row_values.end(), values.begin() + row_offsets_[i]);
+    }
+}
+
+void Meshless_Sweep::
+apply_matrix(int o,
+             int g,
+             double const *x,
+             double *y) const
+{
+    int number_of_points = spatial_discretization_->number_of_points();
+    vector<double> values;
+    get_matrix_values(o,
+                      g,
+                      values);
+    
+    for (int i = 0; i < number_of_points; ++i)
+    {
+        double sum = 0;
+        for (int k = row_offsets_[i]; k < row_offsets_[i + 1]; ++k)
+        {
+            sum += values[k] * x[column_indices_[k]];
+        }
+        y[i] = sum;
+    }
+}
+
 void Meshless_Sweep::
 output(XML_Node output_node) const
 {
     output_node.set_attribute(options_.solver_conversion()->convert(options_.solver),
                               "solver");
+    output_node.set_attribute(matrix_slots_.size(),
+                              "number_of_unique_matrices");
+    output_node.set_attribute(options_.warm_start,
+                              "warm_start");
+    output_node.set_attribute(options_.moment_sweep,
+                              "moment_sweep");
+    solver_->output(output_node);
 }
 
 void Meshless_Sweep::
@@ -176,10 +509,169 @@ save_matrix_as_xml(int o,
 
 Meshless_Sweep::Sweep_Solver::
 Sweep_Solver(Meshless_Sweep const &wrs):
-    wrs_(wrs)
+    wrs_(wrs),
+    number_of_sweeps_(0),
+    number_of_iterations_(0),
+    first_sweep_iterations_(0)
 {
 }
 
+void Meshless_Sweep::Sweep_Solver::
+add_iterations(int number_of_iterations) const
+{
+    #pragma omp atomic
+    number_of_iterations_ += number_of_iterations;
+}
+
+void Meshless_Sweep::Sweep_Solver::
+finish_sweep() const
+{
+    number_of_sweeps_ += 1;
+    if (number_of_sweeps_ == 1)
+    {
+        first_sweep_iterations_ = number_of_iterations_;
+    }
+}
+
+void Meshless_Sweep::Sweep_Solver::
+output(XML_Node output_node) const
+{
+    // Savings are estimated from the first sweep, which is never warm started
+    XML_Node iterations_node = output_node.append_child("inner_iterations");
+    iterations_node.set_attribute(number_of_sweeps_, "number_of_sweeps");
+    iterations_node.set_attribute(number_of_iterations_, "total");
+    iterations_node.set_attribute(first_sweep_iterations_, "first_sweep");
+    iterations_node.set_attribute(first_sweep_iterations_ * number_of_sweeps_ - number_of_iterations_,
+                                  "estimated_savings");
+}
+
+struct Meshless_Sweep::Float_Factorization
+{
+    Eigen::SparseMatrix<double, Eigen::RowMajor> matrix;
+    Eigen::SparseLU<Eigen::SparseMatrix<float>, Eigen::COLAMDOrdering<int> > lu;
+};
+
+Meshless_Sweep::Mixed_Precision_Solver::
+Mixed_Precision_Solver(Meshless_Sweep const &wrs):
+    Sweep_Solver(wrs)
+{
+    int number_of_points = wrs_.spatial_discretization_->number_of_points();
+    int number_of_groups = wrs_.energy_discretization_->number_of_groups();
+    int number_of_matrices = wrs_.matrix_slots_.size();
+    
+    // Factor each unique matrix in single precision
+    lu_.resize(number_of_matrices);
+    #pragma omp parallel for schedule(dynamic, 1)
+    for (int u = 0; u < number_of_matrices; ++u)
+    {
+        // Get matrix from first ordinate and group that share it
+        int k = wrs_.matrix_slots_[u][0];
+        int o = k / number_of_groups;
+        int g = k % number_of_groups;
+        string description = std::to_string(o) + "_" + std::to_string(g);
+        vector<double> values;
+        wrs_.get_matrix_values(o,
+                               g,
+                               values);
+        
+        // Keep double precision matrix for the residual
+        vector<Eigen::Triplet<double> > triplets;
+        triplets.reserve(values.size());
+        for (int i = 0; i < number_of_points; ++i)
+        {
+            for (int l = wrs_.row_offsets_[i]; l < wrs_.row_offsets_[i + 1]; ++l)
+            {
+                triplets.emplace_back(i,
+                                      wrs_.column_indices_[l],
+                                      values[l]);
+            }
+        }
+        lu_[u] = make_shared<Float_Factorization>();
+        lu_[u]->matrix.resize(number_of_points, number_of_points);
+        lu_[u]->matrix.setFromTriplets(triplets.begin(), triplets.end());
+        lu_[u]->matrix.makeCompressed();
+        
+        // Convert to single precision
+        Eigen::SparseMatrix<float> mat = lu_[u]->matrix.cast<float>();
+        mat.makeCompressed();
+
+        // Factor matrix
+        lu_[u]->lu.analyzePattern(mat);
+        lu_[u]->lu.factorize(mat);
+        AssertMsg(lu_[u]->lu.info() == Eigen::Success, "single precision factorization failed, " + description);
+    }
+}
+
+void Meshless_Sweep::Mixed_Precision_Solver::
+solve(vector<double> &x) const
+{
+    int number_of_points = wrs_.spatial_discretization_->number_of_points();
+    int number_of_groups = wrs_.energy_discretization_->number_of_groups();
+    int number_of_matrices = wrs_.matrix_slots_.size();
+    int max_iterations = wrs_.options_.max_refinement_iterations;
+    double tolerance = wrs_.options_.tolerance;
+
+    // Solve for all ordinates and groups that share a matrix
+    #pragma omp parallel for schedule(dynamic, 1)
+    for (int u = 0; u < number_of_matrices; ++u)
+    {
+        Eigen::SparseMatrix<double, Eigen::RowMajor> const &matrix = lu_[u]->matrix;
+        Eigen::SparseLU<Eigen::SparseMatrix<float>, Eigen::COLAMDOrdering<int> > const &lu = lu_[u]->lu;
+        Eigen::VectorXd rhs(number_of_points);
+        Eigen::VectorXd lhs(number_of_points);
+        Eigen::VectorXd res(number_of_points);
+        for (int k : wrs_.matrix_slots_[u])
+        {
+            int o = k / number_of_groups;
+            int g = k % number_of_groups;
+            string description = std::to_string(o) + "_" + std::to_string(g);
+            
+            // Set current RHS values
+            for (int i = 0; i < number_of_points; ++i)
+            {
+                wrs_.get_rhs(i,
+                             o,
+                             g,
+                             x,
+                             rhs(i));
+            }
+            double rhs_norm = rhs.norm();
+            
+            // Get initial solution in single precision
+            lhs = lu.solve(rhs.cast<float>()).cast<double>();
+            
+            // Refine solution using double precision residual
+            bool converged = false;
+            int iteration;
+            for (iteration = 0; iteration < max_iterations; ++iteration)
+            {
+                res = rhs - matrix * lhs;
+                if (res.norm() <= tolerance * rhs_norm)
+                {
+                    converged = true;
+                    break;
+                }
+                lhs += lu.solve(res.cast<float>()).cast<double>();
+            }
+            add_iterations(iteration + 1);
+            if (wrs_.options_.quit_if_diverged)
+            {
+                AssertMsg(converged, "iterative refinement did not converge, " + description);
+            }
+            
+            // Update solution values for this o and g
+            for (int i = 0; i < number_of_points; ++i)
+            {
+                wrs_.set_solution(i,
+                                  o,
+                                  g,
+                                  lhs(i),
+                                  x);
+            }
+        }
+    }
+}
+
 Meshless_Sweep::Trilinos_Solver::
 Trilinos_Solver(Meshless_Sweep const &wrs):
     Sweep_Solver(wrs)
@@ -193,25 +685,37 @@ get_matrix(int o,
 {
     int number_of_points = wrs_.spatial_discretization_->number_of_points();
     vector<int> const number_of_basis_functions = wrs_.spatial_discretization_->number_of_basis_functions();
+
+    // Share the graph, which only has to be filled with values
+    if (map == wrs_.map_)
+    {
+        shared_ptr<Epetra_CrsMatrix> mat
+            = make_shared<Epetra_CrsMatrix>(Copy, // Data access
+                                            *wrs_.graph_);
+        fill_matrix(o,
+                    g,
+                    mat);
+        mat->FillComplete();
+
+        return mat;
+    }
     
     shared_ptr<Epetra_CrsMatrix> mat
         = make_shared<Epetra_CrsMatrix>(Copy, // Data access
                                         *map,
                                         &number_of_basis_functions[0], // Num entries per row
                                         true); // Static profile
+    vector<double> values;
+    wrs_.get_matrix_values(o,
+                           g,
+                           values);
     for (int i = 0; i < number_of_points; ++i)
     {
-        vector<int> indices;
-        vector<double> values;
-        wrs_.get_matrix_row(i,
-                            o,
-                            g,
-                            indices,
-                            values);
+        int k = wrs_.row_offsets_[i];
         mat->InsertGlobalValues(i, // Row
                                 number_of_basis_functions[i], // Num entries
-                                &values[0],
-                                &indices[0]);
+                                &values[k],
+                                &wrs_.column_indices_[k]);
     }
     mat->FillComplete();
     mat->OptimizeStorage();
@@ -219,6 +723,28 @@ get_matrix(int o,
     return mat;
 }
 
+void Meshless_Sweep::Trilinos_Solver::
+fill_matrix(int o,
+            int g,
+            shared_ptr<Epetra_CrsMatrix> mat) const
+{
+    int number_of_points = wrs_.spatial_discretization_->number_of_points();
+    vector<int> const number_of_basis_functions = wrs_.spatial_discretization_->number_of_basis_functions();
+    
+    vector<double> values;
+    wrs_.get_matrix_values(o,
+                           g,
+                           values);
+    for (int i = 0; i < number_of_points; ++i)
+    {
+        int k = wrs_.row_offsets_[i];
+        mat->ReplaceGlobalValues(i, // Row
+                                 number_of_basis_functions[i], // Num entries
+                                 &values[k],
+                                 &wrs_.column_indices_[k]);
+    }
+}
+
 shared_ptr<Epetra_CrsMatrix> Meshless_Sweep::Trilinos_Solver::
 get_prec_matrix(shared_ptr<Epetra_Map> map) const
 {
@@ -270,6 +796,98 @@ set_rhs(int o,
     }
 }
 
+void Meshless_Sweep::Trilinos_Solver::
+set_rhs(int o,
+        int g,
+        int column,
+        std::shared_ptr<Epetra_MultiVector> &rhs,
+        vector<double> const &x) const
+{
+    int number_of_points = wrs_.spatial_discretization_->number_of_points();
+    double *rhs_column = (*rhs)[column];
+    for (int i = 0; i < number_of_points; ++i)
+    {
+        wrs_.get_rhs(i,
+                     o,
+                     g,
+                     x,
+                     rhs_column[i]);
+    }
+}
+
+void Meshless_Sweep::Trilinos_Solver::
+get_lhs(int o,
+        int g,
+        int column,
+        std::shared_ptr<Epetra_MultiVector> const &lhs,
+        vector<double> &x) const
+{
+    int number_of_points = wrs_.spatial_discretization_->number_of_points();
+    int number_of_groups = wrs_.energy_discretization_->number_of_groups();
+    double const *lhs_column = (*lhs)[column];
+    for (int i = 0; i < number_of_points; ++i)
+    {
+        wrs_.set_solution(i,
+                          o,
+                          g,
+                          lhs_column[i],
+                          x);
+    }
+    
+    // Keep solution for the next initial guess
+    if (!previous_psi_.empty())
+    {
+        int k = g + number_of_groups * o;
+        for (int i = 0; i < number_of_points; ++i)
+        {
+            previous_psi_[i + number_of_points * k] = lhs_column[i];
+        }
+        has_previous_psi_[k] = true;
+    }
+}
+
+void Meshless_Sweep::Trilinos_Solver::
+set_lhs(int o,
+        int g,
+        int column,
+        std::shared_ptr<Epetra_MultiVector> const &lhs) const
+{
+    int number_of_points = wrs_.spatial_discretization_->number_of_points();
+    int number_of_groups = wrs_.energy_discretization_->number_of_groups();
+    int k = g + number_of_groups * o;
+    double *lhs_column = (*lhs)[column];
+    
+    if (!previous_psi_.empty() && has_previous_psi_[k])
+    {
+        for (int i = 0; i < number_of_points; ++i)
+        {
+            lhs_column[i] = previous_psi_[i + number_of_points * k];
+        }
+    }
+    else
+    {
+        // Initialize LHS to 1.0 to avoid implicit residual problems
+        for (int i = 0; i < number_of_points; ++i)
+        {
+            lhs_column[i] = 1.0;
+        }
+    }
+}
+
+void Meshless_Sweep::Trilinos_Solver::
+initialize_warm_start()
+{
+    int number_of_points = wrs_.spatial_discretization_->number_of_points();
+    int number_of_groups = wrs_.energy_discretization_->number_of_groups();
+    int number_of_ordinates = wrs_.angular_discretization_->number_of_ordinates();
+    
+    if (wrs_.options_.warm_start)
+    {
+        previous_psi_.assign(number_of_points * number_of_groups * number_of_ordinates, 0);
+        has_previous_psi_.assign(number_of_groups * number_of_ordinates, false);
+    }
+}
+
 void Meshless_Sweep::Trilinos_Solver::
 check_aztec_convergence(shared_ptr<AztecOO> const solver) const
 {
@@ -315,80 +933,155 @@ check_aztec_convergence(shared_ptr<AztecOO> const solver) const
     }
 }
 
+shared_ptr<Teuchos::ParameterList> Meshless_Sweep::Trilinos_Solver::
+get_belos_parameters() const
+{
+    shared_ptr<Teuchos::ParameterList> belos_list
+        = make_shared<Teuchos::ParameterList>();
+    belos_list->set("Num Blocks", wrs_.options_.kspace);
+    belos_list->set("Maximum Iterations", wrs_.options_.max_iterations);
+    belos_list->set("Maximum Restarts", wrs_.options_.max_restarts);
+    belos_list->set("Convergence Tolerance", wrs_.options_.tolerance);
+    if (wrs_.options_.print)
+    {
+        belos_list->set("Verbosity", Belos::IterationDetails + Belos::TimingDetails + Belos::FinalSummary);
+    }
+    else
+    {
+        belos_list->set("Verbosity", Belos::Errors + Belos::Warnings);
+    }
+    if (wrs_.options_.warm_start)
+    {
+        // The initial residual of a warm start is already small, so scaling
+        // by it would tighten the tolerance as the outer iteration converges
+        belos_list->set("Implicit Residual Scaling", "Norm of RHS");
+        belos_list->set("Explicit Residual Scaling", "Norm of RHS");
+    }
+
+    return belos_list;
+}
+
+shared_ptr<BelosSolverManager> Meshless_Sweep::Trilinos_Solver::
+get_belos_solver(shared_ptr<BelosLinearProblem> problem,
+                 int number_of_vectors) const
+{
+    shared_ptr<Teuchos::ParameterList> belos_list
+        = get_belos_parameters();
+    if (wrs_.options_.block_solve)
+    {
+        // Solve all right hand sides in a single block Krylov space
+        belos_list->set("Block Size", number_of_vectors);
+        return make_shared<BelosBlockSolver>(Teuchos::rcp(problem),
+                                             Teuchos::rcp(belos_list));
+    }
+    else
+    {
+        return make_shared<BelosSolver>(Teuchos::rcp(problem),
+                                        Teuchos::rcp(belos_list));
+    }
+}
+
+void Meshless_Sweep::Trilinos_Solver::
+solve_belos(shared_ptr<BelosSolverManager> solver,
+            string const &description) const
+{
+    try
+    {
+        Belos::ReturnType belos_result
+            = solver->solve();
+        
+        if (wrs_.options_.quit_if_diverged)
+        {
+            AssertMsg(belos_result == Belos::Converged, description);
+        }
+    }
+    catch (Belos::StatusTestError const &error)
+    {
+        AssertMsg(false, "Belos status test failed, " + description);
+    }
+    add_iterations(solver->getNumIters());
+}
+
 Meshless_Sweep::Amesos_Solver::
 Amesos_Solver(Meshless_Sweep const &wrs):
     Trilinos_Solver(wrs)
 {
-    int number_of_points = wrs_.spatial_discretization_->number_of_points();
     int number_of_groups = wrs_.energy_discretization_->number_of_groups();
-    int number_of_ordinates = wrs_.angular_discretization_->number_of_ordinates();
+    int number_of_matrices = wrs_.matrix_slots_.size();
     
-    // Initialize communication
-    comm_ = make_shared<Epetra_SerialComm>();
-    map_ = make_shared<Epetra_Map>(number_of_points, 0, *comm_);
+    // Initialize communication: matrices share the sparsity graph
+    comm_ = wrs_.comm_;
+    map_ = wrs_.map_;
     
     // Initialize matrices and vectors
-    lhs_ = make_shared<Epetra_Vector>(*map_);
-    rhs_ = make_shared<Epetra_Vector>(*map_);
-    lhs_->PutScalar(1.0);
-    rhs_->PutScalar(1.0);
-    mat_.resize(number_of_groups * number_of_ordinates);
-    problem_.resize(number_of_groups * number_of_ordinates);
-    solver_.resize(number_of_groups * number_of_ordinates);
+    mat_.resize(number_of_matrices);
+    lhs_.resize(number_of_matrices);
+    rhs_.resize(number_of_matrices);
+    problem_.resize(number_of_matrices);
+    solver_.resize(number_of_matrices);
     Amesos factory;
-    for (int o = 0; o < number_of_ordinates; ++o)
+    for (int u = 0; u < number_of_matrices; ++u)
     {
-        for (int g = 0; g < number_of_groups; ++g)
-        {
-            int k = g + number_of_groups * o;
-
-            mat_[k] = get_matrix(o,
-                                 g,
-                                 map_);
-            problem_[k]
-                = make_shared<Epetra_LinearProblem>(mat_[k].get(),
-                                                    lhs_.get(),
-                                                    rhs_.get());
-            
-            solver_[k]
-                = shared_ptr<Amesos_BaseSolver>(factory.Create("Klu",
-                                                               *problem_[k]));
-                 
-            AssertMsg(solver_[k]->SymbolicFactorization() == 0, "Amesos solver symbolic factorization failed");
-            AssertMsg(solver_[k]->NumericFactorization() == 0, "Amesos solver numeric factorization failed");
-        }
+        // Get matrix from first ordinate and group that share it
+        int k = wrs_.matrix_slots_[u][0];
+        int o = k / number_of_groups;
+        int g = k % number_of_groups;
+        int number_of_vectors = wrs_.matrix_slots_[u].size();
+        
+        lhs_[u] = make_shared<Epetra_MultiVector>(*map_, number_of_vectors);
+        rhs_[u] = make_shared<Epetra_MultiVector>(*map_, number_of_vectors);
+        lhs_[u]->PutScalar(1.0);
+        rhs_[u]->PutScalar(1.0);
+        mat_[u] = get_matrix(o,
+                             g,
+                             map_);
+        problem_[u]
+            = make_shared<Epetra_LinearProblem>(mat_[u].get(),
+                                                lhs_[u].get(),
+                                                rhs_[u].get());
+        
+        solver_[u]
+            = shared_ptr<Amesos_BaseSolver>(factory.Create("Klu",
+                                                           *problem_[u]));
+        
+        AssertMsg(solver_[u]->SymbolicFactorization() == 0, "Amesos solver symbolic factorization failed");
+        AssertMsg(solver_[u]->NumericFactorization() == 0, "Amesos solver numeric factorization failed");
     }
 }
 
 void Meshless_Sweep::Amesos_Solver::
 solve(vector<double> &x) const
 {
-    int number_of_points = wrs_.spatial_discretization_->number_of_points();
     int number_of_groups = wrs_.energy_discretization_->number_of_groups();
-    int number_of_ordinates = wrs_.angular_discretization_->number_of_ordinates();
+    int number_of_matrices = wrs_.matrix_slots_.size();
 
-    // Solve independently for each ordinate and group
-    for (int o = 0; o < number_of_ordinates; ++o)
+    // Solve together for all ordinates and groups that share a matrix
+    for (int u = 0; u < number_of_matrices; ++u)
     {
-        for (int g = 0; g < number_of_groups; ++g)
+        vector<int> const &slots = wrs_.matrix_slots_[u];
+        int number_of_vectors = slots.size();
+        
+        // Set current RHS values
+        for (int v = 0; v < number_of_vectors; ++v)
         {
-            int k = g + number_of_groups * o;
-                
-            // Set current RHS value
-            set_rhs(o,
-                    g,
-                    rhs_,
+            set_rhs(slots[v] / number_of_groups, // ordinate
+                    slots[v] % number_of_groups, // group
+                    v,
+                    rhs_[u],
+                    x);
+        }
+        
+        // Solve, putting result into LHS
+        AssertMsg(solver_[u]->Solve() == 0, "Amesos solver failed to solve");
+        
+        // Update solution values for these o and g
+        for (int v = 0; v < number_of_vectors; ++v)
+        {
+            get_lhs(slots[v] / number_of_groups, // ordinate
+                    slots[v] % number_of_groups, // group
+                    v,
+                    lhs_[u],
                     x);
-                
-            // Solve, putting result into LHS
-            AssertMsg(solver_[k]->Solve() == 0, "Amesos solver failed to solve");
-            
-            // Update solution value (overwrite x for this o and g)
-            for (int i = 0; i < number_of_points; ++i)
-            {
-                int k_x = g + number_of_groups * (o + number_of_ordinates * i);
-                x[k_x] = (*lhs_)[i];
-            }
         }
     }
 }
@@ -465,16 +1158,110 @@ solve(vector<double> &x) const
             // Solve, putting result into LHS
             AssertMsg(solver_[k]->Solve() == 0, "Amesos solver failed to solve");
             
-            // Update solution value (overwrite x for this o and g)
+            // Update solution value for this o and g
             for (int i = 0; i < number_of_points; ++i)
             {
-                int k_x = g + number_of_groups * (o + number_of_ordinates * i);
-                x[k_x] = (*lhs_[k])[i];
+                wrs_.set_solution(i,
+                                  o,
+                                  g,
+                                  (*lhs_[k])[i],
+                                  x);
             }
         }
     }
 }
 
+Meshless_Sweep::Amesos_Reuse_Solver::
+Amesos_Reuse_Solver(Meshless_Sweep const &wrs):
+    Trilinos_Solver(wrs),
+    factored_matrix_(-1)
+{
+    int number_of_groups = wrs_.energy_discretization_->number_of_groups();
+    int number_of_matrices = wrs_.matrix_slots_.size();
+    
+    // Initialize vectors for the ordinates and groups that share each matrix
+    lhs_.resize(number_of_matrices);
+    rhs_.resize(number_of_matrices);
+    for (int u = 0; u < number_of_matrices; ++u)
+    {
+        int number_of_vectors = wrs_.matrix_slots_[u].size();
+        lhs_[u] = make_shared<Epetra_MultiVector>(*wrs_.map_, number_of_vectors);
+        rhs_[u] = make_shared<Epetra_MultiVector>(*wrs_.map_, number_of_vectors);
+        lhs_[u]->PutScalar(1.0);
+        rhs_[u]->PutScalar(1.0);
+    }
+    
+    // Initialize matrix on the shared sparsity graph
+    int k = wrs_.matrix_slots_[0][0];
+    mat_ = get_matrix(k / number_of_groups, // ordinate
+                      k % number_of_groups, // group
+                      wrs_.map_);
+    problem_
+        = make_shared<Epetra_LinearProblem>(mat_.get(),
+                                            lhs_[0].get(),
+                                            rhs_[0].get());
+
+    // Perform symbolic factorization, which is the same for all ordinates and groups
+    Amesos factory;
+    solver_
+        = shared_ptr<Amesos_BaseSolver>(factory.Create("Klu",
+                                                       *problem_));
+    AssertMsg(solver_->SymbolicFactorization() == 0, "Amesos solver symbolic factorization failed");
+}
+
+void Meshless_Sweep::Amesos_Reuse_Solver::
+solve(vector<double> &x) const
+{
+    int number_of_groups = wrs_.energy_discretization_->number_of_groups();
+    int number_of_matrices = wrs_.matrix_slots_.size();
+
+    // Start from the matrix that is already factored, so it is factored
+    // again only if it is not the only unique matrix
+    int first_matrix = std::max(factored_matrix_, 0);
+    for (int n = 0; n < number_of_matrices; ++n)
+    {
+        int u = (first_matrix + n) % number_of_matrices;
+        vector<int> const &slots = wrs_.matrix_slots_[u];
+        int number_of_vectors = slots.size();
+        
+        // Update matrix values and refactor, which the cross sections
+        // cannot change during the life of the sweep
+        if (u != factored_matrix_)
+        {
+            fill_matrix(slots[0] / number_of_groups, // ordinate
+                        slots[0] % number_of_groups, // group
+                        mat_);
+            AssertMsg(solver_->NumericFactorization() == 0, "Amesos solver numeric factorization failed");
+            factored_matrix_ = u;
+        }
+        
+        // Set current RHS values
+        for (int v = 0; v < number_of_vectors; ++v)
+        {
+            set_rhs(slots[v] / number_of_groups, // ordinate
+                    slots[v] % number_of_groups, // group
+                    v,
+                    rhs_[u],
+                    x);
+        }
+        
+        // Solve, putting result into LHS
+        problem_->SetLHS(lhs_[u].get());
+        problem_->SetRHS(rhs_[u].get());
+        AssertMsg(solver_->Solve() == 0, "Amesos solver failed to solve");
+        
+        // Update solution values for these o and g
+        for (int v = 0; v < number_of_vectors; ++v)
+        {
+            get_lhs(slots[v] / number_of_groups, // ordinate
+                    slots[v] % number_of_groups, // group
+                    v,
+                    lhs_[u],
+                    x);
+        }
+    }
+}
+
 Meshless_Sweep::Aztec_Solver::
 Aztec_Solver(Meshless_Sweep const &wrs):
     Trilinos_Solver(wrs)
@@ -536,15 +1323,19 @@ solve(vector<double> &x) const
             // Solve, putting result into LHS
             solver->Iterate(wrs_.options_.max_iterations,
                             wrs_.options_.tolerance);
+            add_iterations(solver->NumIters());
 
             // Check to ensure solver converged
             check_aztec_convergence(solver);
             
-            // Update solution value (overwrite x for this o and g)
+            // Update solution value for this o and g
             for (int i = 0; i < number_of_points; ++i)
             {
-                int k_x = g + number_of_groups * (o + number_of_ordinates * i);
-                x[k_x] = (*lhs_)[i];
+                wrs_.set_solution(i,
+                                  o,
+                                  g,
+                                  (*lhs_)[i],
+                                  x);
             }
         }
     }
@@ -658,15 +1449,19 @@ solve(vector<double> &x) const
             // Solve, putting result into LHS
             solver_[k]->Iterate(wrs_.options_.max_iterations,
                                 wrs_.options_.tolerance);
+            add_iterations(solver_[k]->NumIters());
             
             // Check to ensure solver converged
             check_aztec_convergence(solver_[k]);
             
-            // Update solution value (overwrite x for this o and g)
+            // Update solution value for this o and g
             for (int i = 0; i < number_of_points; ++i)
             {
-                int k_x = g + number_of_groups * (o + number_of_ordinates * i);
-                x[k_x] = (*lhs_)[i];
+                wrs_.set_solution(i,
+                                  o,
+                                  g,
+                                  (*lhs_)[i],
+                                  x);
             }
         }
     }
@@ -697,35 +1492,42 @@ Belos_Solver(Meshless_Sweep const &wrs):
         // Get comm and map
         comm_[t] = make_shared<Epetra_SerialComm>();
         map_[t] = make_shared<Epetra_Map>(number_of_points, 0, *comm_[t]);
-        
-        // Get vectors
-        lhs_[t] = make_shared<Epetra_Vector>(*map_[t]);
-        rhs_[t] = make_shared<Epetra_Vector>(*map_[t]);
-        lhs_[t]->PutScalar(1.0);
-        rhs_[t]->PutScalar(1.0);
 
-        // Get problem and solver
-        shared_ptr<Teuchos::ParameterList> belos_list
-            = make_shared<Teuchos::ParameterList>();
-        belos_list->set("Num Blocks", wrs_.options_.kspace);
-        belos_list->set("Maximum Iterations", wrs_.options_.max_iterations);
-        belos_list->set("Maximum Restarts", wrs_.options_.max_restarts);
-        belos_list->set("Convergence Tolerance", wrs_.options_.tolerance);
-        if (wrs_.options_.print)
-        {
-            belos_list->set("Verbosity", Belos::IterationDetails + Belos::TimingDetails + Belos::FinalSummary);
-        }
-        else
-        {
-            belos_list->set("Verbosity", Belos::Errors + Belos::Warnings);
-        }
+        // Get problem, which is given vectors and a solver once the
+        // number of right hand sides is known
         #pragma omp critical
         {
             problem_[t] = make_shared<BelosLinearProblem>();
-            problem_[t]->setLHS(Teuchos::rcp(lhs_[t]));
-            problem_[t]->setRHS(Teuchos::rcp(rhs_[t]));
-            solver_[t] = make_shared<BelosSolver>(Teuchos::rcp(problem_[t]),
-                                                  Teuchos::rcp(belos_list));
+        }
+    }
+
+    // Initialize storage for initial guess
+    initialize_warm_start();
+}
+
+void Meshless_Sweep::Belos_Solver::
+set_number_of_vectors(int t,
+                      int number_of_vectors) const
+{
+    if (lhs_[t] && lhs_[t]->NumVectors() == number_of_vectors)
+    {
+        return;
+    }
+
+    // Get vectors
+    lhs_[t] = make_shared<Epetra_MultiVector>(*map_[t], number_of_vectors);
+    rhs_[t] = make_shared<Epetra_MultiVector>(*map_[t], number_of_vectors);
+
+    // The pseudo-block solver takes any number of right hand sides, while
+    // the block solver has to be rebuilt for the new block size
+    #pragma omp critical
+    {
+        problem_[t]->setLHS(Teuchos::rcp(lhs_[t]));
+        problem_[t]->setRHS(Teuchos::rcp(rhs_[t]));
+        if (!solver_[t] || wrs_.options_.block_solve)
+        {
+            solver_[t] = get_belos_solver(problem_[t],
+                                          number_of_vectors);
         }
     }
 }
@@ -733,11 +1535,10 @@ Belos_Solver(Meshless_Sweep const &wrs):
 void Meshless_Sweep::Belos_Solver::
 solve(vector<double> &x) const
 {
-    int number_of_points = wrs_.spatial_discretization_->number_of_points();
     int number_of_groups = wrs_.energy_discretization_->number_of_groups();
-    int number_of_ordinates = wrs_.angular_discretization_->number_of_ordinates();
+    int number_of_matrices = wrs_.matrix_slots_.size();
 
-    // Solve independently for each ordinate and group
+    // Solve together for all ordinates and groups that share a matrix
     #pragma omp parallel
     {
         int number_of_threads = omp_get_num_threads();
@@ -745,59 +1546,147 @@ solve(vector<double> &x) const
         Assert(problem_.size() == number_of_threads);
         
         #pragma omp for schedule(dynamic, 1)
-        for (int o = 0; o < number_of_ordinates; ++o)
+        for (int u = 0; u < number_of_matrices; ++u)
         {
-            for (int g = 0; g < number_of_groups; ++g)
+            vector<int> const &slots = wrs_.matrix_slots_[u];
+            int number_of_vectors = slots.size();
+            int o = slots[0] / number_of_groups;
+            int g = slots[0] % number_of_groups;
+            string description = std::to_string(o) + "_" + std::to_string(g);
+            
+            // Set current RHS values
+            set_number_of_vectors(t,
+                                  number_of_vectors);
+            for (int v = 0; v < number_of_vectors; ++v)
             {
-                int k = g + number_of_groups * o;
-                string description = std::to_string(o) + "_" + std::to_string(g);
-                
-                // Set current RHS value
-                set_rhs(o,
-                        g,
+                set_rhs(slots[v] / number_of_groups, // ordinate
+                        slots[v] % number_of_groups, // group
+                        v,
                         rhs_[t],
                         x);
-                
-                // Initialize LHS to 1.0 to avoid implicit residual problems
-                lhs_[t]->PutScalar(1.0);
-
-                // Get matrix
-                shared_ptr<Epetra_CrsMatrix> mat
-                    = get_matrix(o,
-                                 g,
-                                 map_[t]);
-
-                // Set up problem
-                problem_[t]->setOperator(Teuchos::rcp(mat));
-                AssertMsg(problem_[t]->setProblem(), description);
+            }
             
-                // Solve, putting result into LHS
-                try
-                {
-                    Belos::ReturnType belos_result
-                        = solver_[t]->solve();
-                
-                    if (wrs_.options_.quit_if_diverged)
-                    {
-                        AssertMsg(belos_result == Belos::Converged, description);
-                    }
-                }
-                catch (Belos::StatusTestError const &error)
-                {
-                    AssertMsg(false, "Belos status test failed, " + description);
-                }
-                // std::cout << solver_[k]->getNumIters() << std::endl;
+            // Set initial guess
+            for (int v = 0; v < number_of_vectors; ++v)
+            {
+                set_lhs(slots[v] / number_of_groups, // ordinate
+                        slots[v] % number_of_groups, // group
+                        v,
+                        lhs_[t]);
+            }
             
-                // Update solution value (overwrite x for this o and g)
-                for (int i = 0; i < number_of_points; ++i)
-                {
-                    int k_x = g + number_of_groups * (o + number_of_ordinates * i);
-                    x[k_x] = (*lhs_[t])[i];
-                }
+            // Set up problem
+            set_operator(t,
+                         o,
+                         g);
+            AssertMsg(problem_[t]->setProblem(), description);
+            
+            // Solve, putting result into LHS
+            solve_belos(solver_[t],
+                        description);
+            
+            // Update solution values for these o and g
+            for (int v = 0; v < number_of_vectors; ++v)
+            {
+                get_lhs(slots[v] / number_of_groups, // ordinate
+                        slots[v] % number_of_groups, // group
+                        v,
+                        lhs_[t],
+                        x);
+            }
+        }
+    }
+}
+
+void Meshless_Sweep::Belos_Solver::
+set_operator(int t,
+             int o,
+             int g) const
+{
+    shared_ptr<Epetra_CrsMatrix> mat
+        = get_matrix(o,
+                     g,
+                     map_[t]);
+    problem_[t]->setOperator(Teuchos::rcp(mat));
+}
+
+Meshless_Sweep::Belos_Sweep_Solver::
+Belos_Sweep_Solver(Meshless_Sweep const &wrs):
+    Belos_Solver(wrs)
+{
+    int number_of_points = wrs_.spatial_discretization_->number_of_points();
+    int number_of_ordinates = wrs_.angular_discretization_->number_of_ordinates();
+    int dimension = wrs_.spatial_discretization_->dimension();
+
+    // Get order of points along the direction of travel for each ordinate
+    order_.resize(number_of_ordinates);
+    for (int o = 0; o < number_of_ordinates; ++o)
+    {
+        vector<double> const direction = wrs_.angular_discretization_->direction(o);
+        vector<double> distance(number_of_points);
+        for (int i = 0; i < number_of_points; ++i)
+        {
+            vector<double> const &position = wrs_.spatial_discretization_->weight(i)->position();
+            distance[i] = 0;
+            for (int d = 0; d < dimension; ++d)
+            {
+                distance[i] += direction[d] * position[d];
             }
         }
+        
+        order_[o].resize(number_of_points);
+        for (int i = 0; i < number_of_points; ++i)
+        {
+            order_[o][i] = i;
+        }
+        std::stable_sort(order_[o].begin(), order_[o].end(),
+                         [&distance](int i1, int i2)
+                         {
+                             return distance[i1] < distance[i2];
+                         });
+    }
+}
 
+void Meshless_Sweep::Belos_Sweep_Solver::
+set_operator(int t,
+             int o,
+             int g) const
+{
+    // Ordinates that share a matrix have the same projected
+    // direction and therefore the same order
+    shared_ptr<Epetra_CrsMatrix> mat
+        = get_matrix(o,
+                     g,
+                     map_[t]);
+    shared_ptr<Upwind_Gauss_Seidel> sweep
+        = make_shared<Upwind_Gauss_Seidel>(mat,
+                                           order_[o]);
+    shared_ptr<BelosPreconditioner> prec;
+    #pragma omp critical
+    {
+        prec = make_shared<BelosPreconditioner>(Teuchos::rcp(sweep));
     }
+    problem_[t]->setOperator(Teuchos::rcp(mat));
+    problem_[t]->setLeftPrec(Teuchos::rcp(prec));
+}
+
+Meshless_Sweep::Belos_Matrix_Free_Solver::
+Belos_Matrix_Free_Solver(Meshless_Sweep const &wrs):
+    Belos_Solver(wrs)
+{
+}
+
+void Meshless_Sweep::Belos_Matrix_Free_Solver::
+set_operator(int t,
+             int o,
+             int g) const
+{
+    shared_ptr<Matrix_Free_Sweep_Operator> oper
+        = make_shared<Matrix_Free_Sweep_Operator>(wrs_,
+                                                  o,
+                                                  g,
+                                                  map_[t]);
+    problem_[t]->setOperator(Teuchos::rcp(oper));
 }
 
 Meshless_Sweep::Belos_Ifpack_Solver::
@@ -806,100 +1695,86 @@ Belos_Ifpack_Solver(Meshless_Sweep const &wrs):
 {
     int number_of_points = wrs_.spatial_discretization_->number_of_points();
     int number_of_groups = wrs_.energy_discretization_->number_of_groups();
-    int number_of_ordinates = wrs_.angular_discretization_->number_of_ordinates();
+    int number_of_matrices = wrs_.matrix_slots_.size();
     
     // Initialize matrices
-    comm_.resize(number_of_groups * number_of_ordinates);
-    map_.resize(number_of_groups * number_of_ordinates);
-    lhs_.resize(number_of_groups * number_of_ordinates);
-    rhs_.resize(number_of_groups * number_of_ordinates);
-    mat_.resize(number_of_groups * number_of_ordinates);
+    comm_.resize(number_of_matrices);
+    map_.resize(number_of_matrices);
+    lhs_.resize(number_of_matrices);
+    rhs_.resize(number_of_matrices);
+    mat_.resize(number_of_matrices);
     if (wrs_.options_.use_preconditioner)
     {
-        prec_.resize(number_of_groups * number_of_ordinates);
+        prec_.resize(number_of_matrices);
     }
-    problem_.resize(number_of_groups * number_of_ordinates);
-    solver_.resize(number_of_groups * number_of_ordinates);
+    problem_.resize(number_of_matrices);
+    solver_.resize(number_of_matrices);
     
     #pragma omp parallel for schedule(dynamic, 1)
-    for (int o = 0; o < number_of_ordinates; ++o)
+    for (int u = 0; u < number_of_matrices; ++u)
     {
-        for (int g = 0; g < number_of_groups; ++g)
-        {
-            int k = g + number_of_groups * o;
-            string description = std::to_string(o) + "_" + std::to_string(g);
-
-            // Get comm and map
-            comm_[k] = make_shared<Epetra_SerialComm>();
-            map_[k] = make_shared<Epetra_Map>(number_of_points, 0, *comm_[k]);
-
-            // Get vectors and matrix
-            lhs_[k] = make_shared<Epetra_Vector>(*map_[k]);
-            rhs_[k] = make_shared<Epetra_Vector>(*map_[k]);
-            lhs_[k]->PutScalar(1.0);
-            rhs_[k]->PutScalar(1.0);
-            mat_[k] = get_matrix(o,
-                                 g,
-                                 map_[k]);
+        // Get matrix from first ordinate and group that share it
+        int k = wrs_.matrix_slots_[u][0];
+        int o = k / number_of_groups;
+        int g = k % number_of_groups;
+        int number_of_vectors = wrs_.matrix_slots_[u].size();
+        string description = std::to_string(o) + "_" + std::to_string(g);
+        
+        // Get comm and map
+        comm_[u] = make_shared<Epetra_SerialComm>();
+        map_[u] = make_shared<Epetra_Map>(number_of_points, 0, *comm_[u]);
+
+        // Get vectors and matrix
+        lhs_[u] = make_shared<Epetra_MultiVector>(*map_[u], number_of_vectors);
+        rhs_[u] = make_shared<Epetra_MultiVector>(*map_[u], number_of_vectors);
+        lhs_[u]->PutScalar(1.0);
+        rhs_[u]->PutScalar(1.0);
+        mat_[u] = get_matrix(o,
+                             g,
+                             map_[u]);
 
-            // Get preconditioner
-            if (wrs_.options_.use_preconditioner)
-            {
-                Ifpack factory;
-                shared_ptr<Ifpack_Preconditioner> temp_prec
-                    = shared_ptr<Ifpack_Preconditioner>(factory.Create("ILUT",
-                                                                       mat_[k].get()));
-                Teuchos::ParameterList prec_list;
-                prec_list.set("fact: drop tolerance", wrs_.options_.drop_tolerance);
-                prec_list.set("fact: ilut level-of-fill", wrs_.options_.level_of_fill);
-                temp_prec->SetParameters(prec_list);
-                temp_prec->Initialize();
-                temp_prec->Compute();
-                AssertMsg(temp_prec->IsInitialized() == true, description);
-                AssertMsg(temp_prec->IsComputed() == true, description);
+        // Get preconditioner
+        if (wrs_.options_.use_preconditioner)
+        {
+            Ifpack factory;
+            shared_ptr<Ifpack_Preconditioner> temp_prec
+                = shared_ptr<Ifpack_Preconditioner>(factory.Create("ILUT",
+                                                                   mat_[u].get()));
+            Teuchos::ParameterList prec_list;
+            prec_list.set("fact: drop tolerance", wrs_.options_.drop_tolerance);
+            prec_list.set("fact: ilut level-of-fill", wrs_.options_.level_of_fill);
+            temp_prec->SetParameters(prec_list);
+            temp_prec->Initialize();
+            temp_prec->Compute();
+            AssertMsg(temp_prec->IsInitialized() == true, description);
+            AssertMsg(temp_prec->IsComputed() == true, description);
 
-                #pragma omp critical
-                {
-                    prec_[k]
-                        = make_shared<BelosPreconditioner>(Teuchos::rcp(temp_prec));
-                }
-            }
-            
-            // Get problem
             #pragma omp critical
             {
-                problem_[k]
-                    = make_shared<BelosLinearProblem>(Teuchos::rcp(mat_[k]),
-                                                      Teuchos::rcp(lhs_[k]),
-                                                      Teuchos::rcp(rhs_[k]));
-                if (wrs_.options_.use_preconditioner)
-                {
-                    problem_[k]->setLeftPrec(Teuchos::rcp(prec_[k]));
-                }
-                AssertMsg(problem_[k]->setProblem(), description);
-            }
-            
-            // Get solver
-            shared_ptr<Teuchos::ParameterList> belos_list
-                = make_shared<Teuchos::ParameterList>();
-            belos_list->set("Num Blocks", wrs_.options_.kspace);
-            belos_list->set("Maximum Iterations", wrs_.options_.max_iterations);
-            belos_list->set("Maximum Restarts", wrs_.options_.max_restarts);
-            belos_list->set("Convergence Tolerance", wrs_.options_.tolerance);
-            if (wrs_.options_.print)
-            {
-                belos_list->set("Verbosity", Belos::IterationDetails + Belos::TimingDetails + Belos::FinalSummary);
-            }
-            else
-            {
-                belos_list->set("Verbosity", Belos::Errors + Belos::Warnings);
+                prec_[u]
+                    = make_shared<BelosPreconditioner>(Teuchos::rcp(temp_prec));
             }
-            #pragma omp critical
+        }
+        
+        // Get problem
+        #pragma omp critical
+        {
+            problem_[u]
+                = make_shared<BelosLinearProblem>(Teuchos::rcp(mat_[u]),
+                                                  Teuchos::rcp(lhs_[u]),
+                                                  Teuchos::rcp(rhs_[u]));
+            if (wrs_.options_.use_preconditioner)
             {
-                solver_[k]
-                    = make_shared<BelosSolver>(Teuchos::rcp(problem_[k]),
-                                               Teuchos::rcp(belos_list));
+                problem_[u]->setLeftPrec(Teuchos::rcp(prec_[u]));
             }
+            AssertMsg(problem_[u]->setProblem(), description);
+        }
+        
+        // Get solver
+        #pragma omp critical
+        {
+            solver_[u] = get_belos_solver(problem_[u],
+                                          number_of_vectors);
         }
     }
 }
@@ -907,54 +1782,49 @@ Belos_Ifpack_Solver(Meshless_Sweep const &wrs):
 void Meshless_Sweep::Belos_Ifpack_Solver::
 solve(vector<double> &x) const
 {
-    int number_of_points = wrs_.spatial_discretization_->number_of_points();
     int number_of_groups = wrs_.energy_discretization_->number_of_groups();
-    int number_of_ordinates = wrs_.angular_discretization_->number_of_ordinates();
+    int number_of_matrices = wrs_.matrix_slots_.size();
 
-    // Solve independently for each ordinate and group
+    // Solve together for all ordinates and groups that share a matrix
     #pragma omp parallel for schedule(dynamic, 1)
-    for (int o = 0; o < number_of_ordinates; ++o)
+    for (int u = 0; u < number_of_matrices; ++u)
     {
-        for (int g = 0; g < number_of_groups; ++g)
+        vector<int> const &slots = wrs_.matrix_slots_[u];
+        int number_of_vectors = slots.size();
+        string description = std::to_string(slots[0] / number_of_groups) + "_" + std::to_string(slots[0] % number_of_groups);
+        
+        // Set current RHS values
+        for (int v = 0; v < number_of_vectors; ++v)
         {
-            int k = g + number_of_groups * o;
-            string description = std::to_string(o) + "_" + std::to_string(g);
-                
-            // Set current RHS value
-            set_rhs(o,
-                    g,
-                    rhs_[k],
+            set_rhs(slots[v] / number_of_groups, // ordinate
+                    slots[v] % number_of_groups, // group
+                    v,
+                    rhs_[u],
                     x);
+        }
+        
+        // Initialize LHS to 1.0 to avoid implicit residual problems
+        // If warm starting, the LHS already holds the previous solution
+        if (!wrs_.options_.warm_start)
+        {
+            lhs_[u]->PutScalar(1.0);
+        }
 
-            // Initialize LHS to 1.0 to avoid implicit residual problems
-            lhs_[k]->PutScalar(1.0);
-
-            // Set up problem
-            AssertMsg(problem_[k]->setProblem(), description);
-            
-            // Solve, putting result into LHS
-            try
-            {
-                Belos::ReturnType belos_result
-                    = solver_[k]->solve();
-                
-                if (wrs_.options_.quit_if_diverged)
-                {
-                    AssertMsg(belos_result == Belos::Converged, description);
-                }
-            }
-            catch (Belos::StatusTestError const &error)
-            {
-                AssertMsg(false, "Belos status test failed, " + description);
-            }
-            // std::cout << solver_[k]->getNumIters() << std::endl;
-            
-            // Update solution value (overwrite x for this o and g)
-            for (int i = 0; i < number_of_points; ++i)
-            {
-                int k_x = g + number_of_groups * (o + number_of_ordinates * i);
-                x[k_x] = (*lhs_[k])[i];
-            }
+        // Set up problem
+        AssertMsg(problem_[u]->setProblem(), description);
+        
+        // Solve, putting result into LHS
+        solve_belos(solver_[u],
+                    description);
+        
+        // Update solution values for these o and g
+        for (int v = 0; v < number_of_vectors; ++v)
+        {
+            get_lhs(slots[v] / number_of_groups, // ordinate
+                    slots[v] % number_of_groups, // group
+                    v,
+                    lhs_[u],
+                    x);
         }
     }
 }
@@ -1020,19 +1890,7 @@ Belos_Ifpack_Right_Solver(Meshless_Sweep const &wrs):
         
         // Get problem and solver
         shared_ptr<Teuchos::ParameterList> belos_list
-            = make_shared<Teuchos::ParameterList>();
-        belos_list->set("Num Blocks", wrs_.options_.kspace);
-        belos_list->set("Maximum Iterations", wrs_.options_.max_iterations);
-        belos_list->set("Maximum Restarts", wrs_.options_.max_restarts);
-        belos_list->set("Convergence Tolerance", wrs_.options_.tolerance);
-        if (wrs_.options_.print)
-        {
-            belos_list->set("Verbosity", Belos::IterationDetails + Belos::TimingDetails + Belos::FinalSummary);
-        }
-        else
-        {
-            belos_list->set("Verbosity", Belos::Errors + Belos::Warnings);
-        }
+            = get_belos_parameters();
         #pragma omp critical
         {
             problem_[t] = make_shared<BelosLinearProblem>();
@@ -1053,6 +1911,9 @@ Belos_Ifpack_Right_Solver(Meshless_Sweep const &wrs):
                                                   Teuchos::rcp(belos_list));
         }
     }
+
+    // Initialize storage for initial guess
+    initialize_warm_start();
 }
 
 void Meshless_Sweep::Belos_Ifpack_Right_Solver::
@@ -1083,8 +1944,11 @@ solve(vector<double> &x) const
                         rhs_[t],
                         x);
                 
-                // Initialize LHS to 1.0 to avoid implicit residual problems
-                lhs_[t]->PutScalar(1.0);
+                // Set initial guess
+                set_lhs(o,
+                        g,
+                        0, // column
+                        lhs_[t]);
 
                 // Get matrix
                 shared_ptr<Epetra_CrsMatrix> mat
@@ -1097,28 +1961,15 @@ solve(vector<double> &x) const
                 AssertMsg(problem_[t]->setProblem(), description);
                 
                 // Solve, putting result into LHS
-                try
-                {
-                    Belos::ReturnType belos_result
-                        = solver_[t]->solve();
-                
-                    if (wrs_.options_.quit_if_diverged)
-                    {
-                        AssertMsg(belos_result == Belos::Converged, description);
-                    }
-                }
-                catch (Belos::StatusTestError const &error)
-                {
-                    AssertMsg(false, "Belos status test failed, " + description);
-                }
-                // std::cout << solver_[k]->getNumIters() << std::endl;
+                solve_belos(solver_[t],
+                            description);
             
-                // Update solution value (overwrite x for this o and g)
-                for (int i = 0; i < number_of_points; ++i)
-                {
-                    int k_x = g + number_of_groups * (o + number_of_ordinates * i);
-                    x[k_x] = (*lhs_[t])[i];
-                }
+                // Update solution value for this o and g
+                get_lhs(o,
+                        g,
+                        0, // column
+                        lhs_[t],
+                        x);
             }
         }
 
@@ -1189,19 +2040,7 @@ Belos_Ifpack_Right2_Solver(Meshless_Sweep const &wrs):
         
         // Get problem and solver
         shared_ptr<Teuchos::ParameterList> belos_list
-            = make_shared<Teuchos::ParameterList>();
-        belos_list->set("Num Blocks", wrs_.options_.kspace);
-        belos_list->set("Maximum Iterations", wrs_.options_.max_iterations);
-        belos_list->set("Maximum Restarts", wrs_.options_.max_restarts);
-        belos_list->set("Convergence Tolerance", wrs_.options_.tolerance);
-        if (wrs_.options_.print)
-        {
-            belos_list->set("Verbosity", Belos::IterationDetails + Belos::TimingDetails + Belos::FinalSummary);
-        }
-        else
-        {
-            belos_list->set("Verbosity", Belos::Errors + Belos::Warnings);
-        }
+            = get_belos_parameters();
         
         #pragma omp for schedule(static)
         for (int o = 0; o < number_of_ordinates; ++o)
@@ -1239,6 +2078,9 @@ Belos_Ifpack_Right2_Solver(Meshless_Sweep const &wrs):
             }
         }
     }
+
+    // Initialize storage for initial guess
+    initialize_warm_start();
 }
 
 void Meshless_Sweep::Belos_Ifpack_Right2_Solver::
@@ -1268,36 +2110,25 @@ solve(vector<double> &x) const
                         rhs_[t],
                         x);
                 
-                // Initialize LHS to 1.0 to avoid implicit residual problems
-                lhs_[t]->PutScalar(1.0);
+                // Set initial guess
+                set_lhs(o,
+                        g,
+                        0, // column
+                        lhs_[t]);
 
                 // Set up problem
                 AssertMsg(problem_[k]->setProblem(), description);
                 
                 // Solve, putting result into LHS
-                try
-                {
-                    Belos::ReturnType belos_result
-                        = solver_[k]->solve();
-                
-                    if (wrs_.options_.quit_if_diverged)
-                    {
-                        AssertMsg(belos_result == Belos::Converged, description);
-                    }
-                }
-                catch (Belos::StatusTestError const &error)
-                {
-                    AssertMsg(false, "Belos status test failed, " + description);
-                }
-
-                // std::cout << solver_[k]->getNumIters() << std::endl;
+                solve_belos(solver_[k],
+                            description);
             
-                // Update solution value (overwrite x for this o and g)
-                for (int i = 0; i < number_of_points; ++i)
-                {
-                    int k_x = g + number_of_groups * (o + number_of_ordinates * i);
-                    x[k_x] = (*lhs_[t])[i];
-                }
+                // Update solution value for this o and g
+                get_lhs(o,
+                        g,
+                        0, // column
+                        lhs_[t],
+                        x);
             }
         }
     }
@@ -1309,12 +2140,16 @@ solver_conversion() const
     vector<pair<Solver, string> > conversions
         = {{Solver::AMESOS, "amesos"},
            {Solver::AMESOS_PARALLEL, "amesos_parallel"},
+           {Solver::AMESOS_REUSE, "amesos_reuse"},
            {Solver::AZTEC, "aztec"},
            {Solver::AZTEC_IFPACK, "aztec_ifpack"},
            {Solver::BELOS, "belos"},
            {Solver::BELOS_IFPACK, "belos_ifpack"},
            {Solver::BELOS_IFPACK_RIGHT, "belos_ifpack_right"},
-           {Solver::BELOS_IFPACK_RIGHT2, "belos_ifpack_right2"}};
+           {Solver::BELOS_IFPACK_RIGHT2, "belos_ifpack_right2"},
+           {Solver::BELOS_SWEEP, "belos_sweep"},
+           {Solver::BELOS_MATRIX_FREE, "belos_matrix_free"},
+           {Solver::MIXED_PRECISION, "mixed_precision"}};
            
     return make_shared<Conversion<Solver, string> >(conversions);
 }
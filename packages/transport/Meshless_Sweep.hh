@@ -7,6 +7,7 @@
 class Amesos_BaseSolver;
 class AztecOO;
 template<class T1, class T2> class Conversion;
+class Epetra_CrsGraph;
 class Epetra_CrsMatrix;
 class Epetra_Comm;
 class Epetra_LinearProblem;
@@ -20,12 +21,21 @@ namespace Belos
 {
     class EpetraPrecOp;
     template<class Scalar, class MV, class OP> class LinearProblem;
+    template<class Scalar, class MV, class OP> class SolverManager;
     template<class Scalar, class MV, class OP> class PseudoBlockGmresSolMgr;
+    template<class Scalar, class MV, class OP> class BlockGmresSolMgr;
+}
+
+namespace Teuchos
+{
+    class ParameterList;
 }
 
 typedef Belos::EpetraPrecOp BelosPreconditioner;
 typedef Belos::LinearProblem<double, Epetra_MultiVector, Epetra_Operator> BelosLinearProblem;
+typedef Belos::SolverManager<double, Epetra_MultiVector, Epetra_Operator> BelosSolverManager;
 typedef Belos::PseudoBlockGmresSolMgr<double, Epetra_MultiVector, Epetra_Operator> BelosSolver;
+typedef Belos::BlockGmresSolMgr<double, Epetra_MultiVector, Epetra_Operator> BelosBlockSolver;
 
 class Meshless_Sweep : public Sweep_Operator
 {
@@ -39,12 +49,16 @@ public:
         {
             AMESOS,
             AMESOS_PARALLEL,
+            AMESOS_REUSE,
             AZTEC,
             AZTEC_IFPACK,
             BELOS,
             BELOS_IFPACK,
             BELOS_IFPACK_RIGHT,
-            BELOS_IFPACK_RIGHT2
+            BELOS_IFPACK_RIGHT2,
+            BELOS_SWEEP,
+            BELOS_MATRIX_FREE,
+            MIXED_PRECISION
         };
         std::shared_ptr<Conversion<Solver, std::string> > solver_conversion() const;
         
@@ -60,10 +74,35 @@ public:
         double level_of_fill = 1.0;
         double tolerance = 1e-8;
         double drop_tolerance = 1e-12;
+        int max_refinement_iterations = 20;
 
         // Options specific to right preconditioners
         bool weighted_preconditioner = false; 
         bool force_left = false;
+
+        // Form the matrix for each ordinate and group from precomputed,
+        // direction-independent components instead of row by row
+        bool affine_assembly = false;
+
+        // Share one matrix and its factorization or preconditioner between
+        // ordinates with the same projected direction and groups with the
+        // same cross sections (AMESOS, BELOS and BELOS_IFPACK)
+        bool deduplicate_matrices = false;
+
+        // Use block GMRES instead of pseudo-block GMRES for ordinates and
+        // groups that are solved together (BELOS and BELOS_IFPACK)
+        bool block_solve = false;
+
+        // Use the previous solution for each ordinate and group as the
+        // initial guess of the Belos solvers
+        // Not allowed for moment sweeps, which do not keep the angular flux
+        bool warm_start = false;
+
+        // Take and return moments instead of the angular flux
+        // The source for each ordinate is formed from the moments and the
+        // solution is added into the moments as each ordinate is solved, so
+        // the full angular flux is never stored (MOMENT sweep type)
+        bool moment_sweep = false;
     };
 
     // Constructor
@@ -94,6 +133,13 @@ public:
     void save_matrix_as_xml(int o,
                             int g,
                             XML_Node output_node) const;
+
+    // Multiply the transport matrix for o and g by x without forming it
+    // Both x and y are of size number_of_points and cannot be the same
+    virtual void apply_matrix(int o,
+                              int g,
+                              double const *x,
+                              double *y) const;
     
 protected:
 
@@ -102,12 +148,18 @@ protected:
 
     // Meshless_Sweep functions
     virtual void initialize_solver();
+    virtual void initialize_matrix_indices();
+    virtual bool identical_groups(int g1,
+                                  int g2) const;
     virtual void update_augments(std::vector<double> &x) const;
     virtual void get_matrix_row(int i, // weight function index (row)
                                 int o, // ordinate
                                 int g, // group
                                 std::vector<int> &indices, // global basis (column indices)
                                 std::vector<double> &values) const = 0; // column values
+    virtual void get_matrix_values(int o, // ordinate
+                                   int g, // group
+                                   std::vector<double> &values) const; // values in order of column_indices_
     virtual void get_prec_matrix_row(int i, // weight function index (row)
                                      std::vector<int> &indices, // global basis (column indices)
                                      std::vector<double> &values) const = 0; // column values
@@ -117,6 +169,25 @@ protected:
                          std::vector<double> const &x, // angular flux w/ augments
                          double &value) const = 0; // rhs value
     
+    // Get the internal source for row i from x, which holds the angular
+    // flux for ordinate sweeps and the moments for moment sweeps
+    void get_source(int i, // weight function index (row)
+                    int o, // ordinate
+                    int g, // group
+                    std::vector<double> const &x, // angular flux or moments w/ augments
+                    double &value) const; // source value
+
+    // Store the solution for point i, ordinate o and group g
+    // For moment sweeps, adds the solution into the moments instead of x
+    void set_solution(int i, // basis function index
+                      int o, // ordinate
+                      int g, // group
+                      double value, // solution value
+                      std::vector<double> &x) const; // angular flux w/ augments
+
+    // Index of the first augment in x
+    int augment_offset() const;
+    
     // Generalized solver
     class Sweep_Solver
     {
@@ -127,9 +198,43 @@ protected:
         // Solve problem
         virtual void solve(std::vector<double> &x) const = 0;
 
+        // Record the end of a sweep for the iteration count
+        void finish_sweep() const;
+        
+        // Output inner iteration counts
+        virtual void output(XML_Node output_node) const;
+        
     protected:
+
+        // Add to inner iteration count (thread safe)
+        void add_iterations(int number_of_iterations) const;
+        
         // Data
         Meshless_Sweep const &wrs_;
+        mutable int number_of_sweeps_;
+        mutable int number_of_iterations_;
+        mutable int first_sweep_iterations_;
+    };
+    
+    // Mixed precision solver
+    // Stores single precision LU decompositions of all unique matrices and
+    // recovers double precision accuracy by iterative refinement, using
+    // the stored double precision matrices for the residual
+    // Works in parallel
+    struct Float_Factorization;
+    class Mixed_Precision_Solver : public Sweep_Solver
+    {
+    public:
+        // Constructor
+        Mixed_Precision_Solver(Meshless_Sweep const &wrs);
+
+        // Solve problem
+        virtual void solve(std::vector<double> &x) const override;
+
+    protected:
+        
+        // Data, indexed by unique matrix
+        std::vector<std::shared_ptr<Float_Factorization> > lu_;
     };
     
     // Generalized trilinos solver
@@ -145,10 +250,17 @@ protected:
     protected:
         
         // Return transport matrix for o and g
+        // Uses the shared sparsity graph if map is the shared map
         std::shared_ptr<Epetra_CrsMatrix> get_matrix(int o,
                                                      int g,
                                                      std::shared_ptr<Epetra_Map> map) const;
 
+        // Replace values of a matrix with the sparsity pattern of the
+        // shared graph with the values for o and g
+        void fill_matrix(int o,
+                         int g,
+                         std::shared_ptr<Epetra_CrsMatrix> mat) const;
+
         // Get preconditioner matrix that is independent of o and g
         std::shared_ptr<Epetra_CrsMatrix> get_prec_matrix(std::shared_ptr<Epetra_Map> map) const;
         
@@ -157,13 +269,55 @@ protected:
                      int g,
                      std::shared_ptr<Epetra_Vector> &rhs,
                      std::vector<double> const &x) const;
+
+        // Set one column of a multivector rhs to current source
+        void set_rhs(int o,
+                     int g,
+                     int column,
+                     std::shared_ptr<Epetra_MultiVector> &rhs,
+                     std::vector<double> const &x) const;
+        
+        // Copy one column of a multivector lhs into the solution for o and g
+        // Keeps the solution as the next initial guess if warm starting
+        void get_lhs(int o,
+                     int g,
+                     int column,
+                     std::shared_ptr<Epetra_MultiVector> const &lhs,
+                     std::vector<double> &x) const;
+
+        // Set one column of a multivector lhs to the initial guess for o and g
+        // This is the previous solution if warm starting and 1.0 otherwise
+        void set_lhs(int o,
+                     int g,
+                     int column,
+                     std::shared_ptr<Epetra_MultiVector> const &lhs) const;
+
+        // Allocate storage for the previous solutions
+        void initialize_warm_start();
+        
+        // Previous solution for each ordinate and group if warm starting
+        mutable std::vector<double> previous_psi_;
+        mutable std::vector<int> has_previous_psi_;
         
         // Check Aztec solver message
         void check_aztec_convergence(std::shared_ptr<AztecOO> const solver) const;
+
+        // Get GMRES parameters, which depend on whether warm starting
+        std::shared_ptr<Teuchos::ParameterList> get_belos_parameters() const;
+        
+        // Get GMRES solver for a problem with several right hand sides
+        // Not thread safe, as it creates Teuchos pointers
+        std::shared_ptr<BelosSolverManager> get_belos_solver(std::shared_ptr<BelosLinearProblem> problem,
+                                                             int number_of_vectors) const;
+
+        // Solve with a Belos solver whose problem has been set, checking
+        // convergence and counting iterations
+        void solve_belos(std::shared_ptr<BelosSolverManager> solver,
+                         std::string const &description) const;
     };
     
     // Amesos solver
-    // Stores LU decompositions of all matrices
+    // Stores LU decompositions of all unique matrices
     // Only serial
     class Amesos_Solver : public Trilinos_Solver
     {
@@ -176,12 +330,12 @@ protected:
 
     protected:
         
-        // Data
+        // Data, indexed by unique matrix
         std::shared_ptr<Epetra_Comm> comm_;
         std::shared_ptr<Epetra_Map> map_;
         std::vector<std::shared_ptr<Epetra_CrsMatrix> > mat_;
-        mutable std::shared_ptr<Epetra_Vector> lhs_;
-        mutable std::shared_ptr<Epetra_Vector> rhs_;
+        mutable std::vector<std::shared_ptr<Epetra_MultiVector> > lhs_;
+        mutable std::vector<std::shared_ptr<Epetra_MultiVector> > rhs_;
         std::vector<std::shared_ptr<Epetra_LinearProblem> > problem_;
         std::vector<std::shared_ptr<Amesos_BaseSolver> > solver_;
     };
@@ -209,6 +363,33 @@ protected:
         std::vector<std::shared_ptr<Amesos_BaseSolver> > solver_;
     };
     
+    // Amesos solver with a single matrix
+    // Performs the symbolic factorization once and the numeric
+    // factorization once per unique matrix in each sweep, solving all
+    // ordinates and groups that share the matrix together
+    // Stores only the last LU decomposition, which begins the next sweep
+    // without being factored again
+    // Only serial
+    class Amesos_Reuse_Solver : public Trilinos_Solver
+    {
+    public:
+        // Constructor
+        Amesos_Reuse_Solver(Meshless_Sweep const &wrs);
+
+        // Solve problem
+        virtual void solve(std::vector<double> &x) const override;
+
+    protected:
+        
+        // Data, with the vectors indexed by unique matrix
+        std::shared_ptr<Epetra_CrsMatrix> mat_;
+        mutable std::vector<std::shared_ptr<Epetra_MultiVector> > lhs_;
+        mutable std::vector<std::shared_ptr<Epetra_MultiVector> > rhs_;
+        std::shared_ptr<Epetra_LinearProblem> problem_;
+        std::shared_ptr<Amesos_BaseSolver> solver_;
+        mutable int factored_matrix_; // unique matrix in mat_ and solver_, or -1
+    };
+    
     // Aztec solver
     // Iterative, does not store matrices
     // Only in serial
@@ -265,6 +446,8 @@ protected:
     };
 
     // Belos solver: iterative, not preconditioned
+    // Does not store the matrices between iterations
+    // Solves all ordinates and groups that share a matrix at once
     // Works in parallel
     class Belos_Solver : public Trilinos_Solver
     {
@@ -278,16 +461,75 @@ protected:
         
     protected:
 
+        // Set the operator and any preconditioner of the problem for
+        // thread t to the matrix for o and g
+        virtual void set_operator(int t,
+                                  int o,
+                                  int g) const;
+        
+        // Resize the vectors of the problem for thread t if the number of
+        // right hand sides has changed, rebuilding the solver if the
+        // block size depends on the number of right hand sides
+        void set_number_of_vectors(int t,
+                                   int number_of_vectors) const;
+        
+        // Data, indexed by thread
         std::vector<std::shared_ptr<Epetra_Comm> > comm_;
         std::vector<std::shared_ptr<Epetra_Map> > map_;
-        mutable std::vector<std::shared_ptr<Epetra_Vector> > lhs_;
-        mutable std::vector<std::shared_ptr<Epetra_Vector> > rhs_;
+        mutable std::vector<std::shared_ptr<Epetra_MultiVector> > lhs_;
+        mutable std::vector<std::shared_ptr<Epetra_MultiVector> > rhs_;
         std::vector<std::shared_ptr<BelosLinearProblem> > problem_;
-        std::vector<std::shared_ptr<BelosSolver> > solver_;
+        mutable std::vector<std::shared_ptr<BelosSolverManager> > solver_;
     };
 
+    // Belos preconditioned by an upwind Gauss-Seidel sweep
+    // Points are ordered along the direction of each ordinate
+    // Does not store the matrices or factorizations between iterations
+    // Solves all ordinates and groups that share a matrix at once
+    // Works in parallel
+    class Belos_Sweep_Solver : public Belos_Solver
+    {
+    public:
+        
+        // Constructor
+        Belos_Sweep_Solver(Meshless_Sweep const &wrs);
+        
+    protected:
+
+        // Set the matrix and its upwind Gauss-Seidel preconditioner
+        virtual void set_operator(int t,
+                                  int o,
+                                  int g) const override;
+        
+        // Points in increasing order of direction dot position, by ordinate
+        std::vector<std::vector<int> > order_;
+    };
+    
+    // Belos solver with a matrix-free operator
+    // Applies the matrix through apply_matrix, which uses the affine
+    // components of the weak sweep
+    // Requires affine_assembly, as apply_matrix otherwise assembles the
+    // matrix on every application
+    // Not preconditioned
+    // Works in parallel
+    class Belos_Matrix_Free_Solver : public Belos_Solver
+    {
+    public:
+        
+        // Constructor
+        Belos_Matrix_Free_Solver(Meshless_Sweep const &wrs);
+        
+    protected:
+
+        // Set the matrix-free operator
+        virtual void set_operator(int t,
+                                  int o,
+                                  int g) const override;
+    };
+    
     // Belos preconditioned by Ifpack
     // Preconditioned by inverse of Linv matrices
+    // Solves all ordinates and groups that share a matrix at once
     // Works in parallel
     class Belos_Ifpack_Solver : public Trilinos_Solver
     {
@@ -300,15 +542,16 @@ protected:
         virtual void solve(std::vector<double> &x) const override;
 
     protected:
-        
+
+        // Data, indexed by unique matrix
         std::vector<std::shared_ptr<Epetra_Comm> > comm_;
         std::vector<std::shared_ptr<Epetra_Map> > map_;
         std::vector<std::shared_ptr<Epetra_CrsMatrix> > mat_;
-        mutable std::vector<std::shared_ptr<Epetra_Vector> > lhs_;
-        mutable std::vector<std::shared_ptr<Epetra_Vector> > rhs_;
+        mutable std::vector<std::shared_ptr<Epetra_MultiVector> > lhs_;
+        mutable std::vector<std::shared_ptr<Epetra_MultiVector> > rhs_;
         std::vector<std::shared_ptr<BelosPreconditioner> > prec_;
         std::vector<std::shared_ptr<BelosLinearProblem> > problem_;
-        std::vector<std::shared_ptr<BelosSolver> > solver_;
+        std::vector<std::shared_ptr<BelosSolverManager> > solver_;
     };
 
     // Belos preconditioned on the right by Ifpack
@@ -371,6 +614,25 @@ protected:
     std::shared_ptr<Angular_Discretization> angular_discretization_;
     std::shared_ptr<Energy_Discretization> energy_discretization_;
     std::shared_ptr<Sweep_Solver> solver_;
+
+    // Sparsity pattern shared by all ordinates and groups (CSR)
+    // Columns of row i are column_indices_[row_offsets_[i]:row_offsets_[i + 1]]
+    std::vector<int> row_offsets_;
+    std::vector<int> column_indices_;
+
+    // Serial sparsity graph shared by all ordinates and groups
+    std::shared_ptr<Epetra_Comm> comm_;
+    std::shared_ptr<Epetra_Map> map_;
+    std::shared_ptr<Epetra_CrsGraph> graph_;
+
+    // Unique matrix for each ordinate and group, k = g + number_of_groups * o
+    std::vector<int> matrix_indices_;
+    // Ordinate and group indices k that share each unique matrix
+    std::vector<std::vector<int> > matrix_slots_;
+
+    // Moments accumulated by a moment sweep, which converts to and from
+    // the ordinates with the transfer matrices of the angular discretization
+    mutable std::vector<double> moment_result_;
 };
 
 #endif
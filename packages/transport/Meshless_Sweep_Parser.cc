@@ -1,6 +1,7 @@
 #include "Meshless_Sweep_Parser.hh"
 
 #include "Angular_Discretization.hh"
+#include "Check.hh"
 #include "Conversion.hh"
 #include "Energy_Discretization.hh"
 #include "Strong_Meshless_Sweep.hh"
@@ -56,16 +57,33 @@ get_weak_sweep(XML_Node input_node) const
                                                          options.tolerance);
     options.drop_tolerance = input_node.get_attribute<double>("drop_tolerance",
                                                               options.drop_tolerance);
+    options.max_refinement_iterations = input_node.get_attribute<int>("max_refinement_iterations",
+                                                                      options.max_refinement_iterations);
     options.print = input_node.get_attribute<bool>("print",
                                                    options.print);
     options.weighted_preconditioner = input_node.get_attribute<bool>("weighted_preconditioner",
                                                                      options.weighted_preconditioner);
     options.force_left = input_node.get_attribute<bool>("force_left",
                                                         options.force_left);
+    options.affine_assembly = input_node.get_attribute<bool>("affine_assembly",
+                                                             options.affine_assembly);
+    options.deduplicate_matrices = input_node.get_attribute<bool>("deduplicate_matrices",
+                                                                  options.deduplicate_matrices);
+    options.block_solve = input_node.get_attribute<bool>("block_solve",
+                                                         options.block_solve);
+    options.warm_start = input_node.get_attribute<bool>("warm_start",
+                                                        options.warm_start);
+    options.moment_sweep = input_node.get_attribute<bool>("moment_sweep",
+                                                          options.moment_sweep);
     
     string solver = input_node.get_attribute<string>("solver",
                                                      "belos_ifpack");
     options.solver = options.solver_conversion()->convert(solver);
+    AssertMsg(options.solver != Meshless_Sweep::Options::Solver::BELOS_MATRIX_FREE
+              || options.affine_assembly,
+              "belos_matrix_free requires affine_assembly");
+    AssertMsg(!(options.warm_start && options.moment_sweep),
+              "warm_start cannot be used with moment_sweep");
     
     return make_shared<Weak_Meshless_Sweep>(options,
                                        spatial_,
@@ -94,10 +112,18 @@ get_strong_sweep(XML_Node input_node) const
                                                          options.tolerance);
     options.drop_tolerance = input_node.get_attribute<double>("drop_tolerance",
                                                               options.drop_tolerance);
+    options.max_refinement_iterations = input_node.get_attribute<int>("max_refinement_iterations",
+                                                                      options.max_refinement_iterations);
+    options.deduplicate_matrices = input_node.get_attribute<bool>("deduplicate_matrices",
+                                                                  options.deduplicate_matrices);
+    options.moment_sweep = input_node.get_attribute<bool>("moment_sweep",
+                                                          options.moment_sweep);
     
     string solver = input_node.get_attribute<string>("solver",
                                                      "amesos");
     options.solver = options.solver_conversion()->convert(solver);
+    AssertMsg(options.solver != Meshless_Sweep::Options::Solver::BELOS_MATRIX_FREE,
+              "belos_matrix_free requires the weak sweep with affine_assembly");
     
     return make_shared<Strong_Meshless_Sweep>(options,
                                               spatial_,
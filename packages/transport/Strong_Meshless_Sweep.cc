@@ -142,7 +142,7 @@ get_rhs(int i,
     int const number_of_ordinates = angular_discretization_->number_of_ordinates();
     int const number_of_groups = energy_discretization_->number_of_groups();
     int const dimension = spatial_discretization_->dimension();
-    int const psi_size = transport_discretization_->psi_size();
+    int const augment_start = augment_offset();
     
     value = 0;
     if (boundary_point)
@@ -180,7 +180,7 @@ get_rhs(int i,
                                                                             normal_vec);
                 for (int j = 0; j < number_of_basis_functions; ++j)
                 {
-                    int const index = psi_size + g + number_of_groups * (o_ref + number_of_ordinates * j);
+                    int const index = augment_start + g + number_of_groups * (o_ref + number_of_ordinates * j);
                     value += alpha * v_b[j] * x[index];
                 }
             }
@@ -189,6 +189,9 @@ get_rhs(int i,
         // else consider as internal point below
     }
     
-    int const k = g + number_of_groups * (o + number_of_ordinates * i);
-    value = x[k];
+    get_source(i,
+               o,
+               g,
+               x,
+               value);
 }
@@ -20,9 +20,11 @@ Sweep_Operator(Sweep_Type sweep_type,
     case Sweep_Operator::Sweep_Type::MOMENT:
         size_ = (transport_discretization->phi_size()
                  + transport_discretization->number_of_augments());
+        break;
     case Sweep_Operator::Sweep_Type::ORDINATE:
         size_ = (transport_discretization->psi_size()
                  + transport_discretization->number_of_augments());
+        break;
     }
 }
 
@@ -0,0 +1,122 @@
+#include "Upwind_Gauss_Seidel.hh"
+
+#include "Epetra_CrsMatrix.h"
+#include "Epetra_Map.h"
+#include "Epetra_MultiVector.h"
+
+#include "Check.hh"
+
+using std::shared_ptr;
+using std::vector;
+
+Upwind_Gauss_Seidel::
+Upwind_Gauss_Seidel(shared_ptr<Epetra_CrsMatrix> matrix,
+                    vector<int> const &order):
+    matrix_(matrix),
+    order_(order)
+{
+    int number_of_rows = matrix_->NumMyRows();
+    Assert(static_cast<int>(order_.size()) == number_of_rows);
+
+    // Get position of each row in the pass
+    rank_.assign(number_of_rows, -1);
+    for (int r = 0; r < number_of_rows; ++r)
+    {
+        rank_[order_[r]] = r;
+    }
+    
+    // Get global column indices, as local indices follow the column map
+    row_offsets_.resize(number_of_rows + 1);
+    row_offsets_[0] = 0;
+    for (int i = 0; i < number_of_rows; ++i)
+    {
+        int number_of_entries;
+        double *values;
+        int *indices;
+        matrix_->ExtractMyRowView(i,
+                                  number_of_entries,
+                                  values,
+                                  indices);
+        for (int e = 0; e < number_of_entries; ++e)
+        {
+            columns_.push_back(matrix_->GCID(indices[e]));
+        }
+        row_offsets_[i + 1] = columns_.size();
+    }
+}
+
+int Upwind_Gauss_Seidel::
+Apply(Epetra_MultiVector const &X,
+      Epetra_MultiVector &Y) const
+{
+    return matrix_->Apply(X, Y);
+}
+
+int Upwind_Gauss_Seidel::
+ApplyInverse(Epetra_MultiVector const &X,
+             Epetra_MultiVector &Y) const
+{
+    Assert(X.NumVectors() == Y.NumVectors());
+    
+    int number_of_rows = order_.size();
+    int number_of_vectors = X.NumVectors();
+
+    // Each value of X is read before the same value of Y is set, so
+    // X and Y may be the same vector
+    for (int v = 0; v < number_of_vectors; ++v)
+    {
+        double const *x = X[v];
+        double *y = Y[v];
+        
+        for (int r = 0; r < number_of_rows; ++r)
+        {
+            int i = order_[r];
+            int number_of_entries;
+            double *values;
+            int *indices;
+            matrix_->ExtractMyRowView(i,
+                                      number_of_entries,
+                                      values,
+                                      indices);
+            
+            // Subtract contributions of rows already solved
+            double sum = x[i];
+            double diagonal = 0;
+            for (int e = 0; e < number_of_entries; ++e)
+            {
+                int j = columns_[row_offsets_[i] + e];
+                if (j == i)
+                {
+                    diagonal = values[e];
+                }
+                else if (rank_[j] < r)
+                {
+                    sum -= values[e] * y[j];
+                }
+            }
+            Check(diagonal != 0);
+            
+            y[i] = sum / diagonal;
+        }
+    }
+    
+    return 0;
+}
+
+const Epetra_Comm &Upwind_Gauss_Seidel::
+Comm() const
+{
+    return matrix_->Comm();
+}
+
+const Epetra_Map &Upwind_Gauss_Seidel::
+OperatorDomainMap() const
+{
+    return matrix_->OperatorDomainMap();
+}
+
+const Epetra_Map &Upwind_Gauss_Seidel::
+OperatorRangeMap() const
+{
+    return matrix_->OperatorRangeMap();
+}
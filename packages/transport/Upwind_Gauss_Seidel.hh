@@ -0,0 +1,87 @@
+#ifndef Upwind_Gauss_Seidel_hh
+#define Upwind_Gauss_Seidel_hh
+
+#include <memory>
+#include <vector>
+
+#include <Epetra_Operator.h>
+
+class Epetra_Comm;
+class Epetra_CrsMatrix;
+class Epetra_Map;
+class Epetra_MultiVector;
+
+/*
+  Gauss-Seidel preconditioner for a sweep matrix
+  
+  Applies one forward Gauss-Seidel pass over the rows in the given order,
+  which is the order of the points along the direction of travel. Each row
+  only uses solution values from rows earlier in this order, so the inverse
+  is exact when the matrix is lower triangular in this order, as for a
+  classical transport sweep.
+*/
+class Upwind_Gauss_Seidel: public Epetra_Operator
+{
+public:
+
+    // Constructor
+    Upwind_Gauss_Seidel(std::shared_ptr<Epetra_CrsMatrix> matrix,
+                        std::vector<int> const &order);
+
+    // Cannot use transpose
+    virtual int SetUseTranspose(bool UseTranspose) override
+    {
+        return -1;
+    }
+
+    // Apply the matrix
+    virtual int Apply(Epetra_MultiVector const &X,
+                      Epetra_MultiVector &Y) const override;
+    
+    // Perform the Gauss-Seidel pass
+    virtual int ApplyInverse(Epetra_MultiVector const &X,
+                             Epetra_MultiVector &Y) const override;
+    
+    // Cannot provide inf norm
+    virtual double NormInf() const override
+    {
+        return 0.;
+    }
+    
+    // Label for object
+    virtual const char *Label() const override
+    {
+        return "Upwind_Gauss_Seidel";
+    }
+
+    // Cannot use transpose
+    virtual bool UseTranspose() const override
+    {
+        return false;
+    }
+
+    // Cannot provide inf norm
+    virtual bool HasNormInf() const override
+    {
+        return false;
+    }
+
+    // Return associated Epetra_Comm
+    virtual const Epetra_Comm &Comm() const override;
+    
+    // Return associated Epetra_Map
+    virtual const Epetra_Map &OperatorDomainMap() const override;
+
+    // Return associated Epetra_Map
+    virtual const Epetra_Map &OperatorRangeMap() const override;
+    
+private:
+
+    std::shared_ptr<Epetra_CrsMatrix> matrix_;
+    std::vector<int> order_; // rows in order of the pass
+    std::vector<int> rank_; // position of each row in order_
+    std::vector<int> columns_; // global column indices in matrix storage order
+    std::vector<int> row_offsets_; // offset of each row in columns_
+};
+
+#endif
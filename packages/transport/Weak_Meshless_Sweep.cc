@@ -56,6 +56,10 @@ Weak_Meshless_Sweep(Options options,
                    energy_discretization,
                    transport_discretization)
 {
+    if (options_.affine_assembly)
+    {
+        initialize_affine_components();
+    }
     initialize_solver();
     check_class_invariants();
 }
@@ -80,14 +84,14 @@ get_rhs(int i,
 {
     // Get data
     shared_ptr<Weight_Function> weight = spatial_discretization_->weight(i);
-    vector<double> const &is_b_w = weight->integrals().is_b_w;
+    Integral_Span const &is_b_w = weight->integrals().is_b_w;
     vector<double> const direction = angular_discretization_->direction(o);
     int number_of_basis_functions = weight->number_of_basis_functions();
     int number_of_boundary_surfaces = weight->number_of_boundary_surfaces();
     int number_of_ordinates = angular_discretization_->number_of_ordinates();
     int number_of_groups = energy_discretization_->number_of_groups();
     int dimension = spatial_discretization_->dimension();
-    int psi_size = transport_discretization_->psi_size();
+    int augment_start = augment_offset();
     bool has_reflection = transport_discretization_->has_reflection();
 
     value = 0;
@@ -124,7 +128,7 @@ get_rhs(int i,
                         {
                             int aug_index = basis->boundary_index();
                             int is_index = s + number_of_boundary_surfaces * j;
-                            int psi_index = psi_size + g + number_of_groups * (o_ref + number_of_ordinates * aug_index);
+                            int psi_index = augment_start + g + number_of_groups * (o_ref + number_of_ordinates * aug_index);
                             local_sum += is_b_w[is_index] * x[psi_index] * alpha;
                         }
                     }
@@ -150,8 +154,13 @@ get_rhs(int i,
     }
     
     // Add internal source (given contribution)
-    int index = g + number_of_groups * (o + number_of_ordinates * i);
-    value += x[index];
+    double source;
+    get_source(i,
+               o,
+               g,
+               x,
+               source);
+    value += source;
 }
 
 void Weak_Meshless_Sweep::
@@ -163,13 +172,13 @@ get_matrix_row(int i, // weight function index (row)
 {
     // Get data
     shared_ptr<Weight_Function> weight = spatial_discretization_->weight(i);
-    Weight_Function::Integrals const integrals = weight->integrals();
-    vector<double> const &iv_w = integrals.iv_w;
-    vector<double> const &iv_dw = integrals.iv_dw;
-    vector<double> const &is_b_w = integrals.is_b_w;
-    vector<double> const &iv_b_w = integrals.iv_b_w;
-    vector<double> const &iv_b_dw = integrals.iv_b_dw;
-    vector<double> const &iv_db_dw = integrals.iv_db_dw;
+    Weight_Function::Integrals const &integrals = weight->integrals();
+    Integral_Span const &iv_w = integrals.iv_w;
+    Integral_Span const &iv_dw = integrals.iv_dw;
+    Integral_Span const &is_b_w = integrals.is_b_w;
+    Integral_Span const &iv_b_w = integrals.iv_b_w;
+    Integral_Span const &iv_b_dw = integrals.iv_b_dw;
+    Integral_Span const &iv_db_dw = integrals.iv_db_dw;
     vector<double> const direction = angular_discretization_->direction(o);
     shared_ptr<Dimensional_Moments> const dimensional_moments
         = spatial_discretization_->dimensional_moments();
@@ -350,6 +359,429 @@ get_matrix_row(int i, // weight function index (row)
     } // basis functions
 }
 
+void Weak_Meshless_Sweep::
+initialize_affine_components()
+{
+    // Get data
+    int const number_of_points = spatial_discretization_->number_of_points();
+    int const dimension = spatial_discretization_->dimension();
+    int const number_of_groups = energy_discretization_->number_of_groups();
+    int const number_of_entries = column_indices_.size();
+    shared_ptr<Dimensional_Moments> const dimensional_moments
+        = spatial_discretization_->dimensional_moments();
+    int const number_of_dimensional_moments = dimensional_moments->number_of_dimensional_moments();
+    shared_ptr<Weak_Spatial_Discretization_Options> const weak_options
+        = spatial_discretization_->options();
+    bool const include_supg = weak_options->include_supg;
+    bool const normalized = weak_options->normalized;
+    
+    // Initialize components for the spatial dependency of the total cross section
+    sigma_t_spatial_ = spatial_discretization_->weight(0)->material()->sigma_t()->dependencies().spatial;
+    streaming_.assign(2 * dimension, vector<double>(number_of_entries, 0));
+    if (include_supg)
+    {
+        supg_.assign(dimension * dimension, vector<double>(number_of_entries, 0));
+    }
+    switch (sigma_t_spatial_)
+    {
+    case Cross_Section::Dependencies::Spatial::BASIS_WEIGHT:
+    case Cross_Section::Dependencies::Spatial::BASIS:
+        collision_.assign(number_of_dimensional_moments * number_of_groups,
+                          vector<double>(number_of_entries, 0));
+        break;
+    case Cross_Section::Dependencies::Spatial::WEIGHT:
+        Assert(weak_options->total == Weak_Spatial_Discretization_Options::Total::ISOTROPIC); // moment method not yet implemented
+        mass_.assign(include_supg ? dimension + 1 : 1,
+                     vector<double>(number_of_entries, 0));
+        row_sigma_t_.assign(number_of_dimensional_moments * number_of_groups * number_of_points, 0);
+        if (!normalized)
+        {
+            row_norm_.assign(number_of_dimensional_moments * number_of_groups * number_of_points, 0);
+        }
+        break;
+    default:
+        AssertMsg(false, "weighting method not compatible");
+    }
+
+    // Fill in components for each row
+    #pragma omp parallel for schedule(dynamic, 10)
+    for (int i = 0; i < number_of_points; ++i)
+    {
+        shared_ptr<Weight_Function> const weight = spatial_discretization_->weight(i);
+        Weight_Function::Integrals const &integrals = weight->integrals();
+        Integral_Span const &is_b_w = integrals.is_b_w;
+        Integral_Span const &iv_b_w = integrals.iv_b_w;
+        Integral_Span const &iv_b_dw = integrals.iv_b_dw;
+        Integral_Span const &iv_db_dw = integrals.iv_db_dw;
+        vector<int> const &basis_indices = weight->basis_function_indices();
+        int const number_of_basis_functions = weight->number_of_basis_functions();
+        int const number_of_boundary_surfaces = weight->number_of_boundary_surfaces();
+        double const tau = weight->options()->tau;
+        shared_ptr<Material> const material = weight->material();
+        shared_ptr<Cross_Section> const sigma_t_cs = material->sigma_t();
+        vector<double> const &sigma_t_data = sigma_t_cs->data();
+        Assert(sigma_t_cs->dependencies().spatial == sigma_t_spatial_);
+        
+        // Dimensional coefficients without the direction
+        vector<double> tau_coefficients(number_of_dimensional_moments, tau);
+        tau_coefficients[0] = 1;
+        
+        for (int j = 0; j < number_of_basis_functions; ++j)
+        {
+            int const k = row_offsets_[i] + j;
+            
+            // Streaming surface contribution: only for outgoing surfaces,
+            // which depends on the sign of the direction
+            for (int s = 0; s < number_of_boundary_surfaces; ++s)
+            {
+                shared_ptr<Cartesian_Plane> surface = weight->boundary_surface(s);
+                int const surface_dimension = surface->surface_dimension();
+                double const normal = surface->normal();
+                int const sign_index = normal > 0 ? 0 : 1;
+                int const is_index = s + number_of_boundary_surfaces * j;
+                streaming_[surface_dimension + dimension * sign_index][k] += normal * is_b_w[is_index];
+            }
+
+            // Streaming volume contribution
+            for (int d = 0; d < dimension; ++d)
+            {
+                int const iv_index = d + dimension * j;
+                streaming_[d][k] -= iv_b_dw[iv_index];
+                streaming_[d + dimension][k] -= iv_b_dw[iv_index];
+            }
+
+            // Streaming SUPG contribution
+            if (include_supg)
+            {
+                for (int d1 = 0; d1 < dimension; ++d1)
+                {
+                    for (int d2 = 0; d2 < dimension; ++d2)
+                    {
+                        int const iv_index = d2 + dimension * (d1 + dimension * j);
+                        supg_[d2 + dimension * d1][k] = tau * iv_db_dw[iv_index];
+                    }
+                }
+            }
+
+            // Collision contribution
+            switch (sigma_t_spatial_)
+            {
+            case Cross_Section::Dependencies::Spatial::BASIS_WEIGHT:
+                for (int g = 0; g < number_of_groups; ++g)
+                {
+                    for (int d = 0; d < number_of_dimensional_moments; ++d)
+                    {
+                        int const k_sigma = d + number_of_dimensional_moments * (g + number_of_groups * j);
+                        collision_[d + number_of_dimensional_moments * g][k]
+                            = tau_coefficients[d] * sigma_t_data[k_sigma];
+                    }
+                }
+                break;
+            case Cross_Section::Dependencies::Spatial::BASIS:
+            {
+                int const b = basis_indices[j];
+                shared_ptr<Material> const basis_material = spatial_discretization_->weight(b)->material();
+                vector<double> const &basis_sigma_t_data = basis_material->sigma_t()->data();
+                for (int g = 0; g < number_of_groups; ++g)
+                {
+                    for (int d = 0; d < number_of_dimensional_moments; ++d)
+                    {
+                        int const k_sigma = d + number_of_dimensional_moments * g;
+                        double const mult = (d == 0
+                                             ? iv_b_w[j]
+                                             : iv_b_dw[d - 1 + dimension * j]);
+                        collision_[d + number_of_dimensional_moments * g][k]
+                            = tau_coefficients[d] * mult * basis_sigma_t_data[k_sigma];
+                    }
+                }
+                break;
+            }
+            case Cross_Section::Dependencies::Spatial::WEIGHT:
+                mass_[0][k] = iv_b_w[j];
+                if (include_supg)
+                {
+                    for (int d = 0; d < dimension; ++d)
+                    {
+                        mass_[d + 1][k] = tau * iv_b_dw[d + dimension * j];
+                    }
+                }
+                break;
+            default:
+                AssertMsg(false, "weighting method not compatible");
+            }
+        } // basis functions
+
+        // Get the total cross section and norm for this row
+        if (sigma_t_spatial_ == Cross_Section::Dependencies::Spatial::WEIGHT)
+        {
+            shared_ptr<Cross_Section> const norm_cs = material->norm();
+            for (int g = 0; g < number_of_groups; ++g)
+            {
+                for (int d = 0; d < number_of_dimensional_moments; ++d)
+                {
+                    int const k_row = d + number_of_dimensional_moments * (g + number_of_groups * i);
+                    int const k_sigma = d + number_of_dimensional_moments * g;
+                    row_sigma_t_[k_row] = tau_coefficients[d] * sigma_t_data[k_sigma];
+                    
+                    if (!normalized)
+                    {
+                        vector<double> const &norm_data = norm_cs->data();
+                        switch (norm_cs->dependencies().energy)
+                        {
+                        case Cross_Section::Dependencies::Energy::NONE:
+                            row_norm_[k_row] = tau_coefficients[d] * norm_data[d];
+                            break;
+                        case Cross_Section::Dependencies::Energy::GROUP:
+                            row_norm_[k_row] = tau_coefficients[d] * norm_data[k_sigma];
+                            break;
+                        default:
+                            AssertMsg(false, "norm dependency incorrect");
+                            break;
+                        }
+                    }
+                }
+            }
+        }
+    } // points
+}
+
+void Weak_Meshless_Sweep::
+get_matrix_values(int o,
+                  int g,
+                  vector<double> &values) const
+{
+    if (!options_.affine_assembly)
+    {
+        Meshless_Sweep::get_matrix_values(o,
+                                          g,
+                                          values);
+        return;
+    }
+    
+    // Get data
+    int const number_of_points = spatial_discretization_->number_of_points();
+    int const dimension = spatial_discretization_->dimension();
+    int const number_of_groups = energy_discretization_->number_of_groups();
+    int const number_of_entries = column_indices_.size();
+    shared_ptr<Dimensional_Moments> const dimensional_moments
+        = spatial_discretization_->dimensional_moments();
+    int const number_of_dimensional_moments = dimensional_moments->number_of_dimensional_moments();
+    vector<double> const direction = angular_discretization_->direction(o);
+    vector<double> const coefficients = dimensional_moments->coefficients(1., // tau is included in components
+                                                                          direction);
+    
+    values.assign(number_of_entries, 0);
+    
+    // Add streaming contribution
+    for (int d = 0; d < dimension; ++d)
+    {
+        // Both surface and volume terms vanish for a zero direction
+        if (direction[d] == 0)
+        {
+            continue;
+        }
+        
+        vector<double> const &component = streaming_[d + dimension * (direction[d] > 0 ? 0 : 1)];
+        double const coefficient = direction[d];
+        for (int k = 0; k < number_of_entries; ++k)
+        {
+            values[k] += coefficient * component[k];
+        }
+    }
+    
+    // Add SUPG streaming contribution
+    if (!supg_.empty())
+    {
+        for (int d1 = 0; d1 < dimension; ++d1)
+        {
+            for (int d2 = 0; d2 < dimension; ++d2)
+            {
+                vector<double> const &component = supg_[d2 + dimension * d1];
+                double const coefficient = direction[d1] * direction[d2];
+                for (int k = 0; k < number_of_entries; ++k)
+                {
+                    values[k] += coefficient * component[k];
+                }
+            }
+        }
+    }
+    
+    // Add collision contribution
+    switch (sigma_t_spatial_)
+    {
+    case Cross_Section::Dependencies::Spatial::BASIS_WEIGHT:
+    case Cross_Section::Dependencies::Spatial::BASIS:
+        for (int d = 0; d < number_of_dimensional_moments; ++d)
+        {
+            vector<double> const &component = collision_[d + number_of_dimensional_moments * g];
+            double const coefficient = coefficients[d];
+            for (int k = 0; k < number_of_entries; ++k)
+            {
+                values[k] += coefficient * component[k];
+            }
+        }
+        break;
+    case Cross_Section::Dependencies::Spatial::WEIGHT:
+    {
+        // Get direction-dependent mass matrix
+        vector<double> mass(mass_[0]);
+        for (int d = 1; d < mass_.size(); ++d)
+        {
+            vector<double> const &component = mass_[d];
+            double const coefficient = direction[d - 1];
+            for (int k = 0; k < number_of_entries; ++k)
+            {
+                mass[k] += coefficient * component[k];
+            }
+        }
+
+        // Scale rows by total cross section
+        for (int i = 0; i < number_of_points; ++i)
+        {
+            double sigma_t = 0;
+            double norm = 0;
+            for (int d = 0; d < number_of_dimensional_moments; ++d)
+            {
+                int const k_row = d + number_of_dimensional_moments * (g + number_of_groups * i);
+                sigma_t += coefficients[d] * row_sigma_t_[k_row];
+                if (!row_norm_.empty())
+                {
+                    norm += coefficients[d] * row_norm_[k_row];
+                }
+            }
+            if (!row_norm_.empty())
+            {
+                sigma_t /= norm;
+            }
+            
+            for (int k = row_offsets_[i]; k < row_offsets_[i + 1]; ++k)
+            {
+                values[k] += sigma_t * mass[k];
+            }
+        }
+        break;
+    }
+    default:
+        AssertMsg(false, "weighting method not compatible");
+    }
+}
+
+void Weak_Meshless_Sweep::
+apply_matrix(int o,
+             int g,
+             double const *x,
+             double *y) const
+{
+    if (!options_.affine_assembly)
+    {
+        Meshless_Sweep::apply_matrix(o,
+                                     g,
+                                     x,
+                                     y);
+        return;
+    }
+    
+    // Get data
+    int const number_of_points = spatial_discretization_->number_of_points();
+    int const dimension = spatial_discretization_->dimension();
+    int const number_of_groups = energy_discretization_->number_of_groups();
+    shared_ptr<Dimensional_Moments> const dimensional_moments
+        = spatial_discretization_->dimensional_moments();
+    int const number_of_dimensional_moments = dimensional_moments->number_of_dimensional_moments();
+    vector<double> const direction = angular_discretization_->direction(o);
+    vector<double> const coefficients = dimensional_moments->coefficients(1., // tau is included in components
+                                                                          direction);
+    
+    // Get components that are the same for every row and their coefficients
+    vector<double const *> components;
+    vector<double> component_coefficients;
+    for (int d = 0; d < dimension; ++d)
+    {
+        if (direction[d] != 0)
+        {
+            components.push_back(&streaming_[d + dimension * (direction[d] > 0 ? 0 : 1)][0]);
+            component_coefficients.push_back(direction[d]);
+        }
+    }
+    if (!supg_.empty())
+    {
+        for (int d1 = 0; d1 < dimension; ++d1)
+        {
+            for (int d2 = 0; d2 < dimension; ++d2)
+            {
+                components.push_back(&supg_[d2 + dimension * d1][0]);
+                component_coefficients.push_back(direction[d1] * direction[d2]);
+            }
+        }
+    }
+    if (!collision_.empty())
+    {
+        for (int d = 0; d < number_of_dimensional_moments; ++d)
+        {
+            components.push_back(&collision_[d + number_of_dimensional_moments * g][0]);
+            component_coefficients.push_back(coefficients[d]);
+        }
+    }
+    int const number_of_components = components.size();
+    int const number_of_mass_components = mass_.size();
+    
+    // Multiply each row, streaming through the components
+    int const *const columns = &column_indices_[0];
+    for (int i = 0; i < number_of_points; ++i)
+    {
+        int const begin = row_offsets_[i];
+        int const end = row_offsets_[i + 1];
+        double sum = 0;
+        for (int c = 0; c < number_of_components; ++c)
+        {
+            double const *const component = components[c];
+            double const coefficient = component_coefficients[c];
+            double local_sum = 0;
+            #pragma omp simd reduction(+:local_sum)
+            for (int k = begin; k < end; ++k)
+            {
+                local_sum += component[k] * x[columns[k]];
+            }
+            sum += coefficient * local_sum;
+        }
+        
+        // Add collision contribution scaled by the row total cross section
+        if (number_of_mass_components > 0)
+        {
+            double sigma_t = 0;
+            double norm = 0;
+            for (int d = 0; d < number_of_dimensional_moments; ++d)
+            {
+                int const k_row = d + number_of_dimensional_moments * (g + number_of_groups * i);
+                sigma_t += coefficients[d] * row_sigma_t_[k_row];
+                if (!row_norm_.empty())
+                {
+                    norm += coefficients[d] * row_norm_[k_row];
+                }
+            }
+            if (!row_norm_.empty())
+            {
+                sigma_t /= norm;
+            }
+            
+            for (int d = 0; d < number_of_mass_components; ++d)
+            {
+                double const *const component = &mass_[d][0];
+                double const coefficient = d == 0 ? 1 : direction[d - 1];
+                double local_sum = 0;
+                #pragma omp simd reduction(+:local_sum)
+                for (int k = begin; k < end; ++k)
+                {
+                    local_sum += component[k] * x[columns[k]];
+                }
+                sum += sigma_t * coefficient * local_sum;
+            }
+        }
+        
+        y[i] = sum;
+    }
+}
+
 void Weak_Meshless_Sweep::
 get_prec_matrix_row(int i, // weight function index (row)
                     vector<int> &indices, // column indices (global basis)
@@ -357,11 +789,11 @@ get_prec_matrix_row(int i, // weight function index (row)
 {
     // Get data
     shared_ptr<Weight_Function> weight = spatial_discretization_->weight(i);
-    Weight_Function::Integrals const weight_integrals = weight->integrals();
+    Weight_Function::Integrals const &weight_integrals = weight->integrals();
     Weight_Function::Values const weight_values = weight->values();
     vector<double> const &v_b = weight_values.v_b;
-    vector<double> const &iv_w = weight_integrals.iv_w;
-    vector<double> const &iv_b_w = weight_integrals.iv_b_w;
+    Integral_Span const &iv_w = weight_integrals.iv_w;
+    Integral_Span const &iv_b_w = weight_integrals.iv_b_w;
     int const number_of_basis_functions = weight->number_of_basis_functions();
     vector<int> const basis_indices = weight->basis_function_indices();
     
@@ -2,6 +2,7 @@
 #define Weak_Meshless_Sweep_hh
 
 #include "Meshless_Sweep.hh"
+#include "Cross_Section.hh"
 
 class Weak_Meshless_Sweep : public Meshless_Sweep
 {
@@ -19,6 +20,12 @@ public:
     {
         return "Weak_Meshless_Sweep";
     }
+
+    // Apply the matrix from the affine components when using affine_assembly
+    virtual void apply_matrix(int o,
+                              int g,
+                              double const *x,
+                              double *y) const override;
     
 protected:
     
@@ -35,6 +42,28 @@ protected:
                          int g, // group
                          std::vector<double> const &x, // angular flux w/ augments
                          double &value) const override; // rhs value
+    virtual void get_matrix_values(int o, // ordinate
+                                   int g, // group
+                                   std::vector<double> &values) const override; // values in order of column_indices_
+
+private:
+
+    // Precompute the direction-independent components of the matrix
+    void initialize_affine_components();
+    
+    // Affine components of the matrix, each with values in the order of column_indices_
+    // The matrix for ordinate o and group g is
+    //   sum_d Omega_d S_d^(sign Omega_d) + sum_d1 sum_d2 Omega_d1 Omega_d2 T_d1d2 + C
+    // where the collision term C depends on the spatial dependency of sigma_t:
+    //   BASIS_WEIGHT, BASIS: C = C_0g + sum_d Omega_d C_(d+1)g
+    //   WEIGHT: C = diag(sigma_t(Omega, g)) (M_0 + sum_d Omega_d M_(d+1))
+    Cross_Section::Dependencies::Spatial sigma_t_spatial_; // spatial dependency of sigma_t
+    std::vector<std::vector<double> > streaming_; // S: d + dimension * s, s = 0 for Omega_d > 0
+    std::vector<std::vector<double> > supg_; // T: d2 + dimension * d1, includes tau
+    std::vector<std::vector<double> > collision_; // C: d + number_of_dimensional_moments * g
+    std::vector<std::vector<double> > mass_; // M: d, includes tau
+    std::vector<double> row_sigma_t_; // d + number_of_dimensional_moments * (g + number_of_groups * i)
+    std::vector<double> row_norm_; // d + number_of_dimensional_moments * (g + number_of_groups * i)
 };
 
 #endif
@@ -0,0 +1,510 @@
+#include <iomanip>
+#include <iostream>
+#include <mpi.h>
+
+#include "Angular_Discretization.hh"
+#include "Angular_Discretization_Factory.hh"
+#include "Augmented_Operator.hh"
+#include "Boundary_Source.hh"
+#include "Cartesian_Plane.hh"
+#include "Check_Equality.hh"
+#include "Constructive_Solid_Geometry.hh"
+#include "Cross_Section.hh"
+#include "Cylinder_2D.hh"
+#include "Discrete_To_Moment.hh"
+#include "Energy_Discretization.hh"
+#include "Material.hh"
+#include "Material_Factory.hh"
+#include "Moment_To_Discrete.hh"
+#include "Random_Number_Generator.hh"
+#include "Region.hh"
+#include "Transport_Discretization.hh"
+#include "Vector_Operator_Functions.hh"
+#include "Weak_Meshless_Sweep.hh"
+#include "Weak_Spatial_Discretization.hh"
+#include "Weak_Spatial_Discretization_Factory.hh"
+#include "Weight_Function.hh"
+
+namespace ce = Check_Equality;
+using namespace std;
+
+// Apply the sweep with each solver and assembly option to the same source
+// and compare the results to a direct solve of the row-assembled matrices
+
+Random_Number_Generator<double> rng(0, // lower bound
+                                    1, // upper bound
+                                    839); // seed
+
+// Get a two-group, anisotropically-scattering 2D pincell with reflective
+// boundaries, so the sweeps also write augments. With flux weighting, the
+// cross sections of the weight functions depend on the angular moment.
+void get_pincell(int num_dimensional_points,
+                 bool use_flux,
+                 shared_ptr<Weak_Spatial_Discretization> &spatial,
+                 shared_ptr<Angular_Discretization> &angular,
+                 shared_ptr<Energy_Discretization> &energy,
+                 shared_ptr<Transport_Discretization> &transport)
+{
+    // Set constants
+    int dimension = 2;
+    double length = 4.0;
+
+    // Get angular discretization
+    int number_of_moments = 2;
+    int angular_rule = 1;
+    Angular_Discretization_Factory angular_factory;
+    angular = angular_factory.get_angular_discretization(dimension,
+                                                         number_of_moments,
+                                                         angular_rule);
+
+    // Get energy discretization
+    int number_of_groups = 2;
+    energy = make_shared<Energy_Discretization>(number_of_groups);
+
+    // Get materials
+    vector<shared_ptr<Material> > materials(2);
+    Material_Factory material_factory(angular,
+                                      energy);
+    materials[0]
+        = material_factory.get_standard_material(0, // index
+                                                 {1.0, 1.5}, // sigma_t
+                                                 {0.5, 0.2, 0.0, 1.1, // sigma_s
+                                                  0.05, 0.02, 0.0, 0.1},
+                                                 {2.4, 2.4}, // nu
+                                                 {0.1, 0.2}, // sigma_f
+                                                 {1.0, 0.0}, // chi
+                                                 {0.0, 0.0}); // internal source
+    materials[1]
+        = material_factory.get_standard_material(1, // index
+                                                 {2.0, 3.0}, // sigma_t
+                                                 {1.2, 0.6, 0.0, 2.8, // sigma_s
+                                                  0.2, 0.05, 0.0, 0.4},
+                                                 {0.0, 0.0}, // nu
+                                                 {0.0, 0.0}, // sigma_f
+                                                 {0.0, 0.0}, // chi
+                                                 {0.0, 0.0}); // internal source
+
+    // Get reflective boundary source
+    Boundary_Source::Dependencies boundary_dependencies;
+    vector<shared_ptr<Boundary_Source> > boundary_sources(1);
+    boundary_sources[0]
+        = make_shared<Boundary_Source>(0, // index
+                                       boundary_dependencies,
+                                       angular,
+                                       energy,
+                                       vector<double>(number_of_groups, 0), // boundary source
+                                       vector<double>(number_of_groups, 1.0)); // alpha
+
+    // Get Cartesian boundaries and internal cylinder
+    vector<shared_ptr<Surface> > surfaces(2 * dimension + 1);
+    for (int d = 0; d < dimension; ++d)
+    {
+        int index1 = 0 + 2 * d;
+        surfaces[index1]
+            = make_shared<Cartesian_Plane>(index1,
+                                           dimension,
+                                           Surface::Surface_Type::BOUNDARY,
+                                           d,
+                                           -0.5 * length,
+                                           -1);
+        int index2 = 1 + 2 * d;
+        surfaces[index2]
+            = make_shared<Cartesian_Plane>(index2,
+                                           dimension,
+                                           Surface::Surface_Type::BOUNDARY,
+                                           d,
+                                           0.5 * length,
+                                           1);
+    }
+    for (int i = 0; i < 2 * dimension; ++i)
+    {
+        surfaces[i]->set_boundary_source(boundary_sources[0]);
+    }
+    vector<double> origin = {0, 0};
+    surfaces[2 * dimension]
+        = make_shared<Cylinder_2D>(2 * dimension, // index
+                                   Surface::Surface_Type::INTERNAL,
+                                   length / 4, // radius
+                                   origin);
+
+    // Get fuel and moderator regions
+    vector<shared_ptr<Region> > regions(2);
+    vector<Surface::Relation> fuel_relations
+        = {Surface::Relation::INSIDE};
+    vector<shared_ptr<Surface> > fuel_surfaces
+        = {surfaces[4]};
+    regions[0]
+        = make_shared<Region>(0, // index
+                              materials[0],
+                              fuel_relations,
+                              fuel_surfaces);
+    vector<Surface::Relation> mod_relations
+        = {Surface::Relation::NEGATIVE,
+           Surface::Relation::NEGATIVE,
+           Surface::Relation::NEGATIVE,
+           Surface::Relation::NEGATIVE,
+           Surface::Relation::OUTSIDE};
+    regions[1]
+        = make_shared<Region>(1, // index
+                              materials[1],
+                              mod_relations,
+                              surfaces);
+
+    // Create solid geometry
+    shared_ptr<Constructive_Solid_Geometry> solid
+        = make_shared<Constructive_Solid_Geometry>(dimension,
+                                                   surfaces,
+                                                   regions,
+                                                   materials,
+                                                   boundary_sources);
+
+    // Get spatial discretization
+    shared_ptr<Weight_Function_Options> weight_options
+        = make_shared<Weight_Function_Options>();
+    weight_options->tau_const = 1.0;
+    shared_ptr<Weak_Spatial_Discretization_Options> weak_options
+        = make_shared<Weak_Spatial_Discretization_Options>();
+    weak_options->integration_ordinates = 8;
+    weak_options->external_integral_calculation = true;
+    weak_options->tau_scaling = Weak_Spatial_Discretization_Options::Tau_Scaling::NONE;
+    if (use_flux)
+    {
+        // Use a different flux shape for each group and moment
+        int number_of_points = num_dimensional_points * num_dimensional_points;
+        weak_options->weighting = Weak_Spatial_Discretization_Options::Weighting::FLUX;
+        weak_options->flux_coefficients.resize(number_of_groups * angular->number_of_moments() * number_of_points);
+        for (double &coefficient : weak_options->flux_coefficients)
+        {
+            coefficient = 0.5 + rng.scalar();
+        }
+    }
+    Weak_Spatial_Discretization_Factory spatial_factory(solid,
+                                                        solid->cartesian_boundary_surfaces());
+    spatial = spatial_factory.get_simple_discretization(num_dimensional_points,
+                                                        1.5, // radius num intervals
+                                                        true, // basis mls
+                                                        true, // weight mls
+                                                        "wendland11", // basis type
+                                                        "wendland11", // weight type
+                                                        weight_options,
+                                                        weak_options);
+
+    // Get transport discretization
+    transport
+        = make_shared<Transport_Discretization>(spatial,
+                                                angular,
+                                                energy);
+}
+
+// Get a random vector of the size of the operator input
+vector<double> get_random_input(shared_ptr<Vector_Operator> oper)
+{
+    vector<double> x(oper->column_size());
+    for (double &value : x)
+    {
+        value = rng.scalar();
+    }
+    return x;
+}
+
+int compare_results(string description,
+                    vector<double> const &expected,
+                    vector<double> const &calculated,
+                    double tolerance)
+{
+    int w = 24;
+    double error = 0;
+    if (expected.size() == calculated.size())
+    {
+        for (int i = 0; i < static_cast<int>(expected.size()); ++i)
+        {
+            error = max(error, abs(expected[i] - calculated[i]));
+        }
+    }
+    bool passed = ce::approx(expected, calculated, tolerance);
+
+    cout << setw(w) << description;
+    cout << setw(w) << error;
+    cout << setw(w) << (passed ? "passed" : "FAILED");
+    cout << endl;
+
+    return passed ? 0 : 1;
+}
+
+int test_solvers(int num_dimensional_points)
+{
+    int checksum = 0;
+    cout << "test_solvers running for ";
+    cout << num_dimensional_points;
+    cout << " dimensional points";
+    cout << endl;
+
+    shared_ptr<Weak_Spatial_Discretization> spatial;
+    shared_ptr<Angular_Discretization> angular;
+    shared_ptr<Energy_Discretization> energy;
+    shared_ptr<Transport_Discretization> transport;
+    get_pincell(num_dimensional_points,
+                false, // use flux
+                spatial,
+                angular,
+                energy,
+                transport);
+    Assert(transport->has_reflection());
+
+    // Get reference from the direct solver and row assembly
+    Meshless_Sweep::Options reference_options;
+    reference_options.solver = Meshless_Sweep::Options::Solver::AMESOS;
+    reference_options.tolerance = 1e-12;
+    shared_ptr<Vector_Operator> reference_sweep
+        = make_shared<Weak_Meshless_Sweep>(reference_options,
+                                           spatial,
+                                           angular,
+                                           energy,
+                                           transport);
+    vector<double> const source = get_random_input(reference_sweep);
+    vector<double> reference = source;
+    (*reference_sweep)(reference);
+
+    // Get the options to compare
+    vector<string> descriptions;
+    vector<Meshless_Sweep::Options> cases;
+    vector<double> tolerances;
+    {
+        // Affine assembly with the direct solver
+        Meshless_Sweep::Options options = reference_options;
+        options.affine_assembly = true;
+        descriptions.push_back("amesos, affine");
+        cases.push_back(options);
+        tolerances.push_back(1e-10);
+    }
+    {
+        // Shared matrices with the direct solver
+        Meshless_Sweep::Options options = reference_options;
+        options.deduplicate_matrices = true;
+        descriptions.push_back("amesos, deduplicated");
+        cases.push_back(options);
+        tolerances.push_back(1e-10);
+    }
+    {
+        // One stored factorization, with and without shared matrices
+        Meshless_Sweep::Options options = reference_options;
+        options.solver = Meshless_Sweep::Options::Solver::AMESOS_REUSE;
+        descriptions.push_back("amesos_reuse");
+        cases.push_back(options);
+        tolerances.push_back(1e-10);
+        options.deduplicate_matrices = true;
+        descriptions.push_back("amesos_reuse, dedup");
+        cases.push_back(options);
+        tolerances.push_back(1e-10);
+    }
+    {
+        // Block solves of the packed right hand sides
+        Meshless_Sweep::Options options = reference_options;
+        options.solver = Meshless_Sweep::Options::Solver::BELOS_IFPACK;
+        options.deduplicate_matrices = true;
+        options.block_solve = true;
+        descriptions.push_back("belos_ifpack, block");
+        cases.push_back(options);
+        tolerances.push_back(1e-8);
+    }
+    {
+        // Upwind Gauss-Seidel preconditioner
+        Meshless_Sweep::Options options = reference_options;
+        options.solver = Meshless_Sweep::Options::Solver::BELOS_SWEEP;
+        descriptions.push_back("belos_sweep");
+        cases.push_back(options);
+        tolerances.push_back(1e-8);
+    }
+    {
+        // Matrix-free GMRES
+        Meshless_Sweep::Options options = reference_options;
+        options.solver = Meshless_Sweep::Options::Solver::BELOS_MATRIX_FREE;
+        options.affine_assembly = true;
+        descriptions.push_back("belos_matrix_free");
+        cases.push_back(options);
+        tolerances.push_back(1e-8);
+    }
+    {
+        // Single precision factors with refinement, with row and with
+        // matrix-free residuals
+        Meshless_Sweep::Options options = reference_options;
+        options.solver = Meshless_Sweep::Options::Solver::MIXED_PRECISION;
+        descriptions.push_back("mixed_precision");
+        cases.push_back(options);
+        tolerances.push_back(1e-8);
+        options.affine_assembly = true;
+        descriptions.push_back("mixed_precision, affine");
+        cases.push_back(options);
+        tolerances.push_back(1e-8);
+    }
+
+    // Apply each sweep twice to the same source, so solvers that keep
+    // factorizations or solutions between sweeps are also checked
+    for (int i = 0; i < static_cast<int>(cases.size()); ++i)
+    {
+        shared_ptr<Vector_Operator> sweep
+            = make_shared<Weak_Meshless_Sweep>(cases[i],
+                                               spatial,
+                                               angular,
+                                               energy,
+                                               transport);
+        for (int s = 0; s < 2; ++s)
+        {
+            vector<double> result = source;
+            (*sweep)(result);
+            checksum += compare_results(descriptions[i] + (s == 0 ? "" : " (2)"),
+                                        reference,
+                                        result,
+                                        tolerances[i]);
+        }
+    }
+
+    return checksum;
+}
+
+int test_moment_sweep(int num_dimensional_points)
+{
+    int checksum = 0;
+    cout << "test_moment_sweep running for ";
+    cout << num_dimensional_points;
+    cout << " dimensional points";
+    cout << endl;
+
+    shared_ptr<Weak_Spatial_Discretization> spatial;
+    shared_ptr<Angular_Discretization> angular;
+    shared_ptr<Energy_Discretization> energy;
+    shared_ptr<Transport_Discretization> transport;
+    get_pincell(num_dimensional_points,
+                false, // use flux
+                spatial,
+                angular,
+                energy,
+                transport);
+    int number_of_augments = transport->number_of_augments();
+    Assert(number_of_augments > 0);
+
+    // Get the discrete-to-moment, sweep and moment-to-discrete chain
+    Meshless_Sweep::Options options;
+    options.solver = Meshless_Sweep::Options::Solver::AMESOS;
+    shared_ptr<Vector_Operator> Linv
+        = make_shared<Weak_Meshless_Sweep>(options,
+                                           spatial,
+                                           angular,
+                                           energy,
+                                           transport);
+    shared_ptr<Vector_Operator> M
+        = make_shared<Augmented_Operator>(number_of_augments,
+                                          make_shared<Moment_To_Discrete>(spatial,
+                                                                          angular,
+                                                                          energy),
+                                          false);
+    shared_ptr<Vector_Operator> D
+        = make_shared<Augmented_Operator>(number_of_augments,
+                                          make_shared<Discrete_To_Moment>(spatial,
+                                                                          angular,
+                                                                          energy),
+                                          false);
+    shared_ptr<Vector_Operator> chain = D * Linv * M;
+
+    // Get the moment sweeps with the direct and an iterative solver
+    vector<string> descriptions = {"moment, amesos", "moment, belos_sweep"};
+    vector<Meshless_Sweep::Options::Solver> solvers
+        = {Meshless_Sweep::Options::Solver::AMESOS,
+           Meshless_Sweep::Options::Solver::BELOS_SWEEP};
+    vector<double> tolerances = {1e-10, 1e-8};
+
+    vector<double> const source = get_random_input(chain);
+    vector<double> reference = source;
+    (*chain)(reference);
+    for (int i = 0; i < static_cast<int>(solvers.size()); ++i)
+    {
+        Meshless_Sweep::Options moment_options = options;
+        moment_options.solver = solvers[i];
+        moment_options.tolerance = 1e-12;
+        moment_options.moment_sweep = true;
+        shared_ptr<Vector_Operator> moment_sweep
+            = make_shared<Weak_Meshless_Sweep>(moment_options,
+                                               spatial,
+                                               angular,
+                                               energy,
+                                               transport);
+        Assert(moment_sweep->column_size() == chain->column_size());
+        vector<double> result = source;
+        (*moment_sweep)(result);
+        checksum += compare_results(descriptions[i],
+                                    reference,
+                                    result,
+                                    tolerances[i]);
+    }
+
+    return checksum;
+}
+
+int test_angular_cross_sections(int num_dimensional_points)
+{
+    int checksum = 0;
+    cout << "test_angular_cross_sections running for ";
+    cout << num_dimensional_points;
+    cout << " dimensional points";
+    cout << endl;
+
+    shared_ptr<Weak_Spatial_Discretization> spatial;
+    shared_ptr<Angular_Discretization> angular;
+    shared_ptr<Energy_Discretization> energy;
+    shared_ptr<Transport_Discretization> transport;
+    get_pincell(num_dimensional_points,
+                true, // use flux
+                spatial,
+                angular,
+                energy,
+                transport);
+    Assert(spatial->weight(0)->material()->sigma_t()->angular_size() > 1);
+
+    // Groups may only share a matrix if their cross sections agree for
+    // every angular moment
+    Meshless_Sweep::Options reference_options;
+    reference_options.solver = Meshless_Sweep::Options::Solver::AMESOS;
+    reference_options.tolerance = 1e-12;
+    Meshless_Sweep::Options options = reference_options;
+    options.deduplicate_matrices = true;
+    shared_ptr<Vector_Operator> reference_sweep
+        = make_shared<Weak_Meshless_Sweep>(reference_options,
+                                           spatial,
+                                           angular,
+                                           energy,
+                                           transport);
+    shared_ptr<Vector_Operator> sweep
+        = make_shared<Weak_Meshless_Sweep>(options,
+                                           spatial,
+                                           angular,
+                                           energy,
+                                           transport);
+    vector<double> const source = get_random_input(reference_sweep);
+    vector<double> reference = source;
+    (*reference_sweep)(reference);
+    vector<double> result = source;
+    (*sweep)(result);
+    checksum += compare_results("amesos, flux, deduplicated",
+                                reference,
+                                result,
+                                1e-10);
+
+    return checksum;
+}
+
+int main(int argc, char **argv)
+{
+    int checksum = 0;
+
+    // Initialize MPI
+    MPI_Init(&argc, &argv);
+
+    checksum += test_solvers(12);
+    checksum += test_moment_sweep(12);
+    checksum += test_angular_cross_sections(12);
+
+    // Close MPI
+    MPI_Finalize();
+
+    return checksum;
+}